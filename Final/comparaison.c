@@ -0,0 +1,1021 @@
+/**
+* @file comparaison.c
+* @brief Banc d'essai des stratégies de déplacement des différentes versions du Snake.
+*
+* Les stratégies écrites pour les versions 1 à 4 sont extraites de leur programme et placées derrière
+* une même interface : à partir de l'état de la partie, elles rendent la direction du prochain pas.
+* Toutes jouent les mêmes parties, sans affichage, sur les mêmes plateaux et avec les mêmes pommes.
+*
+* @details
+* - Plateaux : "bordures" (version 1), "trous" (version 2) et "paves" (version 3 : trous et pavés).
+* - Un seul serpent de TAILLE anneaux, qui part du centre du plateau vers la droite.
+* - La graine 0 rejoue le calendrier de pommes d'origine ; les autres tirent les pommes au hasard.
+* - Bilan par stratégie et par plateau : parties complètes, collisions, parties bloquées,
+*   pommes mangées par partie, pas par pomme (parties complètes seulement, pour ne pas compter
+*   les tours d'une partie bloquée) et temps moyen d'une décision.
+*
+* @version 1.0
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+// Constantes du jeu (communes aux versions 1 à 3)
+#define TAILLE 10  // Taille du serpent.
+#define LARGEUR_PLATEAU 80  // Largeur du plateau de jeu.
+#define HAUTEUR_PLATEAU 40  // Hauteur du plateau de jeu.
+#define X_DEPART_SERPENT 40  // Position en X du serpent au départ (au centre du plateau).
+#define Y_DEPART_SERPENT 20  // Position en Y du serpent au départ (au centre du plateau).
+#define NB_POMMES 10  // Nombre de pommes à manger pour finir une partie.
+#define BORDURE '#'  // Caractère d'une bordure du plateau.
+#define PAVE '#'  // Caractère d'un pavé d'obstacle (le même que la bordure, comme dans la version 3).
+#define VIDE ' '  // Caractère d'une case vide.
+#define POMME '6'  // Caractère d'une pomme.
+#define HAUT 'z'  // Direction vers le haut.
+#define BAS 's'  // Direction vers le bas.
+#define GAUCHE 'q'  // Direction vers la gauche.
+#define DROITE 'd'  // Direction vers la droite.
+#define CHEMIN_HAUT 1  // Chemin par le trou du haut.
+#define CHEMIN_BAS 2  // Chemin par le trou du bas.
+#define CHEMIN_GAUCHE 3  // Chemin par le trou de gauche.
+#define CHEMIN_DROITE 4  // Chemin par le trou de droite.
+#define CHEMIN_POMME 5  // Chemin direct vers la pomme.
+#define NB_PAVES 6  // Nombre de pavés d'obstacles.
+#define TAILLE_PAVE 5  // Dimension (carrée) des pavés.
+#define NB_CASES ((LARGEUR_PLATEAU+1) * (HAUTEUR_PLATEAU+1))  // Nombre de cases adressables du plateau.
+#define NANO_PAR_SECONDE 1000000000.0  // Nombre de nanosecondes par seconde.
+
+// Constantes du banc d'essai
+#define PAS_MAX 10000  // Au-delà, une partie qui n'avance plus est déclarée bloquée.
+#define NB_PARTIES_DEFAUT 1000  // Nombre de parties jouées par stratégie et par plateau.
+#define NB_MESURES_HORLOGE 100000  // Nombre de lectures de l'horloge pour estimer leur coût.
+#define DUREE_LOT_MIN 2000.0  // Durée minimale (ns) d'un lot de décisions chronométré d'un bloc, soit des dizaines de lectures de l'horloge.
+#define NB_APPELS_MAX 4096  // Nombre maximal de décisions d'un lot.
+#define OPTION_PARTIES "--parties"  // Option pour choisir le nombre de parties.
+#define OPTION_GRAINE "--graine"  // Option pour choisir la graine de la première partie.
+#define OPTION_CARTE "--carte"  // Option pour ne jouer que sur un plateau.
+#define OPTION_STRATEGIE "--strategie"  // Option pour ne comparer qu'une stratégie.
+
+typedef char tPlateau[LARGEUR_PLATEAU + 1][HAUTEUR_PLATEAU + 1];  // Plateau de jeu (indices à partir de 1).
+typedef unsigned char tOccupation[LARGEUR_PLATEAU + 2][HAUTEUR_PLATEAU + 2];  // Nombre d'anneaux sur chaque case (une case de marge de chaque côté).
+
+typedef enum {
+    CARTE_BORDURES,  // Plateau de la version 1 : bordures pleines.
+    CARTE_TROUS,  // Plateau de la version 2 : un trou au milieu de chaque bord.
+    CARTE_PAVES,  // Plateau de la version 3 : trous et pavés.
+    NB_CARTES
+} tCarte;
+
+const char *lesNomsCartes[NB_CARTES] = {"bordures", "trous", "paves"};
+
+typedef struct {
+    int x;  // Coordonnée X du Portail.
+    int y;  // Coordonnée Y du Portail.
+} Portail;
+
+const Portail TROU_HAUT = {40, 0};  // Portail en haut du plateau.
+const Portail TROU_BAS = {40, 40};  // Portail en bas du plateau.
+const Portail TROU_GAUCHE = {0, 20};  // Portail à gauche du plateau.
+const Portail TROU_DROITE = {80, 20};  // Portail à droite du plateau.
+
+const int lesPommesX[NB_POMMES] = {75, 75, 78, 2, 8, 78, 74, 2, 72, 5};  // Calendrier d'origine des pommes, en X.
+const int lesPommesY[NB_POMMES] = {8, 39, 2, 2, 5, 39, 33, 38, 35, 2};  // Calendrier d'origine des pommes, en Y.
+const int lesPavesX[NB_PAVES] = {3, 74, 3, 74, 38, 38};  // Positions en X des pavés (version 3).
+const int lesPavesY[NB_PAVES] = {3, 3, 34, 34, 21, 15};  // Positions en Y des pavés (version 3).
+
+typedef struct {
+    tPlateau plateau;  // Bordures, trous, pavés et pomme en jeu.
+    tOccupation occupation;  // Cases occupées par le serpent.
+    int lesX[TAILLE];  // Positions en X des anneaux (tête en 0).
+    int lesY[TAILLE];  // Positions en Y des anneaux.
+    char direction;  // Dernière direction jouée.
+    int pommeX;  // Position en X de la pomme en jeu.
+    int pommeY;  // Position en Y de la pomme en jeu.
+    bool nouvellePomme;  // La pomme vient d'apparaître : c'est la première décision pour elle.
+    bool trouTraverse;  // La tête est passée par un trou (remis à faux par les stratégies qui le souhaitent).
+    int chemin;  // Mémoire de la stratégie : chemin choisi à l'apparition de la pomme.
+} tEtat;
+
+typedef char (*tDecision)(tEtat *etat);  // Une stratégie : direction du prochain pas d'après l'état.
+
+typedef struct {
+    const char *nom;  // Nom donné à l'option --strategie.
+    const char *origine;  // Programme d'où la stratégie est extraite.
+    tDecision decider;  // Fonction de décision.
+} tStrategie;
+
+typedef struct {
+    long parties;  // Parties jouées.
+    long completes;  // Parties où toutes les pommes ont été mangées.
+    long collisions;  // Parties non complètes terminées par une collision.
+    long bloquees;  // Parties arrêtées après PAS_MAX pas.
+    long pommes;  // Pommes mangées, toutes parties confondues.
+    long pasCompletes;  // Pas joués dans les parties complètes.
+    long decisions;  // Décisions prises.
+    double nanosecondes;  // Temps passé à décider, coût de l'horloge déduit.
+} tBilan;
+
+// Prototypes des fonctions
+void initPlateau(tPlateau plateau, tCarte carte);  // Bordures, trous et pavés du plateau choisi.
+void initEtat(tEtat *etat, tCarte carte);  // Plateau, serpent au départ et indicateurs remis à zéro.
+void placerPomme(tEtat *etat, int numero, uint64_t graine, uint64_t *alea);  // Pomme du calendrier ou tirée sur une case libre.
+void avancer(tEtat *etat, char direction, bool *collision, bool *pomme);  // Fait avancer le serpent d'une case.
+void jouerPartie(const tStrategie *strategie, tCarte carte, uint64_t graine, int nbAppels, double surcout, tBilan *bilan);  // Joue une partie et cumule son résultat.
+double chronometrerDecision(const tStrategie *strategie, tEtat *etat, int nbAppels, double surcout, char *direction);  // Durée (ns) d'un lot de nbAppels décisions sur le même état.
+int calibrerAppels(const tStrategie *strategie, tCarte carte, double surcout);  // Nombre de décisions par lot pour dépasser DUREE_LOT_MIN.
+double coutHorloge(void);  // Coût moyen d'une lecture de l'horloge monotone, en nanosecondes.
+double tempsEcoule(struct timespec debut, struct timespec fin);  // Durée en secondes entre deux instants.
+uint64_t aleatoireSuivant(uint64_t *etat);  // Générateur pseudo-aléatoire splitmix64.
+
+char choisirDirection(int lesX[], int lesY[], int pommeX, int pommeY);  // Version 1 : axe le plus éloigné de la pomme.
+void determinerDirectionVersObjectif(tEtat *etat, char *direction, int cibleX, int cibleY);  // Version 2 : vers la cible, en évitant les collisions.
+bool detecterCollision(tEtat *etat, char directionProchaine);  // Version 2 : la direction mène-t-elle sur une bordure ou le corps ?
+int distancePlusCourt(int lesX[], int lesY[], int pommeX, int pommeY);  // Version 2 : chemin direct ou par un trou.
+int minimunTableau(int tableau[5]);  // Versions 2.2 et 3 : indice de la plus petite distance.
+char directionVersCible(int lesX[], int lesY[], int cibleX, int cibleY);  // Versions 2.2 et 3 : vertical d'abord, puis horizontal.
+bool PasserPortails(int lesX[], int lesY[]);  // Versions 2.2 et 3 : la tête est-elle hors du plateau ?
+bool estSurCorpsSerpent(int x, int y, int lesX[], int lesY[]);  // Versions 2.2 et 3 : position sur le corps (hors tête) ?
+bool directionEstSure(int x, int y, char direction, int lesX[], int lesY[], tPlateau plateau);  // Versions 2.2 et 3 : direction sans danger ?
+char trouverDirectionSure(int lesX[], int lesY[], char directionActuelle, tPlateau plateau);  // Versions 2.2 et 3 : direction sûre la plus proche.
+char directionPlusCourtChemin(tEtat *etat, int cibleX, int cibleY);  // Version 3 actuelle : parcours en largeur.
+void directionSerpent1(tEtat *etat, char *direction1, int x, int y);  // Version 4 (Arthur) : vers la cible, en évitant les collisions.
+bool verifierCollisionProchainDeplacement1(tEtat *etat, char prochaineDirection1);  // Version 4 (Arthur) : collision au prochain pas ?
+int calculDistance1(int lesX1[], int lesY1[], int pommeX, int pommeY);  // Version 4 (Arthur) : chemin direct ou par un trou.
+
+char decisionVersion1(tEtat *etat);  // Stratégie de version1/claude.c.
+char decisionVersion2(tEtat *etat);  // Stratégie de Final/version2.c.
+char decisionTableau(tEtat *etat);  // Stratégie de Final/version2.2.c et de l'ancienne Final/version3.c.
+char decisionArthur(tEtat *etat);  // Stratégie du serpent 1 de version4/v4Arthur.c.
+char decisionLargeur(tEtat *etat);  // Stratégie actuelle de Final/version3.c.
+
+const tStrategie lesStrategies[] = {
+    {"version1", "version1/claude.c", decisionVersion1},
+    {"version2", "Final/version2.c", decisionVersion2},
+    {"tableau", "Final/version2.2.c", decisionTableau},
+    {"arthur", "version4/v4Arthur.c", decisionArthur},
+    {"largeur", "Final/version3.c", decisionLargeur},
+};
+#define NB_STRATEGIES ((int)(sizeof(lesStrategies) / sizeof(lesStrategies[0])))  // Nombre de stratégies comparées.
+
+
+int main(int argc, char *argv[])
+{
+    long nbParties = NB_PARTIES_DEFAUT;
+    uint64_t graine = 1;
+    int carteChoisie = -1;  // -1 : tous les plateaux.
+    int strategieChoisie = -1;  // -1 : toutes les stratégies.
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], OPTION_PARTIES) == 0) && (i + 1 < argc))
+        {
+            nbParties = atol(argv[++i]);
+            if (nbParties <= 0)
+            {
+                fprintf(stderr, "Nombre de parties invalide : %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+        }
+        else if ((strcmp(argv[i], OPTION_GRAINE) == 0) && (i + 1 < argc))
+        {
+            graine = strtoull(argv[++i], NULL, 10);
+        }
+        else if ((strcmp(argv[i], OPTION_CARTE) == 0) && (i + 1 < argc))
+        {
+            i++;
+            for (int c = 0; c < NB_CARTES; c++)
+            {
+                if (strcmp(argv[i], lesNomsCartes[c]) == 0)
+                {
+                    carteChoisie = c;
+                }
+            }
+            if (carteChoisie < 0)
+            {
+                fprintf(stderr, "Plateau invalide : %s (bordures, trous ou paves)\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+        }
+        else if ((strcmp(argv[i], OPTION_STRATEGIE) == 0) && (i + 1 < argc))
+        {
+            i++;
+            for (int s = 0; s < NB_STRATEGIES; s++)
+            {
+                if (strcmp(argv[i], lesStrategies[s].nom) == 0)
+                {
+                    strategieChoisie = s;
+                }
+            }
+            if (strategieChoisie < 0)
+            {
+                fprintf(stderr, "Stratégie inconnue : %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+        }
+        else
+        {
+            fprintf(stderr, "Option inconnue : %s\n", argv[i]);
+            fprintf(stderr, "Usage : %s [--parties n] [--graine g] [--carte bordures|trous|paves] [--strategie nom]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    double surcout = coutHorloge();
+    printf("%ld parties par stratégie et par plateau, graines %llu à %llu (décisions chronométrées par lots, horloge de %.1f ns déduite une fois par lot)\n",
+           nbParties, (unsigned long long)graine, (unsigned long long)(graine + nbParties - 1), surcout);
+    printf("%-9s %-20s %-9s %9s %11s %11s %9s %10s %12s\n",
+           "stratégie", "origine", "plateau", "complètes", "collisions", "bloquées", "pommes", "pas/pomme", "ns/décision");
+
+    for (int s = 0; s < NB_STRATEGIES; s++)
+    {
+        if ((strategieChoisie >= 0) && (s != strategieChoisie))
+        {
+            continue;
+        }
+        for (int c = 0; c < NB_CARTES; c++)
+        {
+            if ((carteChoisie >= 0) && (c != carteChoisie))
+            {
+                continue;
+            }
+            tBilan bilan = {0};
+            int nbAppels = calibrerAppels(&lesStrategies[s], (tCarte)c, surcout);
+            for (long p = 0; p < nbParties; p++)
+            {
+                jouerPartie(&lesStrategies[s], (tCarte)c, graine + (uint64_t)p, nbAppels, surcout, &bilan);
+            }
+            char pasParPomme[16] = "-";  // Sans partie complète, pas de pas par pomme
+            if (bilan.completes > 0)
+            {
+                snprintf(pasParPomme, sizeof(pasParPomme), "%.1f", (double)bilan.pasCompletes / (bilan.completes * NB_POMMES));
+            }
+            printf("%-9s %-20s %-9s %8.1f%% %10.1f%% %10.1f%% %9.2f %10s %12.1f\n",
+                   lesStrategies[s].nom, lesStrategies[s].origine, lesNomsCartes[c],
+                   100.0 * bilan.completes / bilan.parties,
+                   100.0 * bilan.collisions / bilan.parties,
+                   100.0 * bilan.bloquees / bilan.parties,
+                   (double)bilan.pommes / bilan.parties,
+                   pasParPomme,
+                   bilan.nanosecondes / bilan.decisions);
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
+
+/************************************************/
+/*		PLATEAU ET DÉROULEMENT DES PARTIES		*/
+/************************************************/
+
+void initPlateau(tPlateau plateau, tCarte carte)
+{
+    for (int i = 1; i <= LARGEUR_PLATEAU; i++)  // Cases vides, puis bordure tout autour
+    {
+        for (int j = 1; j <= HAUTEUR_PLATEAU; j++)
+        {
+            bool bord = (i == 1) || (i == LARGEUR_PLATEAU) || (j == 1) || (j == HAUTEUR_PLATEAU);
+            plateau[i][j] = bord ? BORDURE : VIDE;
+        }
+    }
+
+    if (carte == CARTE_BORDURES)
+    {
+        return;
+    }
+
+    // Trous au milieu de chaque bord, comme dans les versions 2 et 3
+    plateau[LARGEUR_PLATEAU][HAUTEUR_PLATEAU / 2] = VIDE;
+    plateau[LARGEUR_PLATEAU / 2][HAUTEUR_PLATEAU] = VIDE;
+    plateau[LARGEUR_PLATEAU / 2][1] = VIDE;
+    plateau[1][HAUTEUR_PLATEAU / 2] = VIDE;
+
+    if (carte == CARTE_PAVES)
+    {
+        for (int p = 0; p < NB_PAVES; p++)
+        {
+            for (int i = 0; i < TAILLE_PAVE; i++)
+            {
+                for (int j = 0; j < TAILLE_PAVE; j++)
+                {
+                    plateau[lesPavesX[p] + i][lesPavesY[p] + j] = PAVE;
+                }
+            }
+        }
+    }
+}
+
+
+void initEtat(tEtat *etat, tCarte carte)
+{
+    initPlateau(etat->plateau, carte);
+    memset(etat->occupation, 0, sizeof(etat->occupation));
+    for (int i = 0; i < TAILLE; i++)  // Tête en (X_DEPART_SERPENT, Y_DEPART_SERPENT), anneaux à sa gauche
+    {
+        etat->lesX[i] = X_DEPART_SERPENT - i;
+        etat->lesY[i] = Y_DEPART_SERPENT;
+        etat->occupation[etat->lesX[i]][etat->lesY[i]]++;
+    }
+    etat->direction = DROITE;
+    etat->nouvellePomme = true;
+    etat->trouTraverse = false;
+    etat->chemin = CHEMIN_POMME;
+}
+
+
+void placerPomme(tEtat *etat, int numero, uint64_t graine, uint64_t *alea)
+{
+    int x = lesPommesX[numero];
+    int y = lesPommesY[numero];
+
+    if (graine != 0)  // Case libre à l'intérieur des bordures, hors pavés et hors serpent
+    {
+        do
+        {
+            uint64_t tirage = aleatoireSuivant(alea);
+            x = 2 + (int)(tirage % (LARGEUR_PLATEAU - 2));
+            y = 2 + (int)((tirage >> 32) % (HAUTEUR_PLATEAU - 2));
+        } while ((etat->plateau[x][y] != VIDE) || (etat->occupation[x][y] != 0));
+    }
+
+    etat->plateau[x][y] = POMME;
+    etat->pommeX = x;
+    etat->pommeY = y;
+    etat->nouvellePomme = true;
+}
+
+
+void avancer(tEtat *etat, char direction, bool *collision, bool *pomme)
+{
+    etat->occupation[etat->lesX[TAILLE - 1]][etat->lesY[TAILLE - 1]]--;  // La queue libère sa case
+    for (int i = TAILLE - 1; i > 0; i--)
+    {
+        etat->lesX[i] = etat->lesX[i - 1];
+        etat->lesY[i] = etat->lesY[i - 1];
+    }
+
+    switch (direction)
+    {
+        case HAUT:
+            etat->lesY[0]--;
+            break;
+        case BAS:
+            etat->lesY[0]++;
+            break;
+        case GAUCHE:
+            etat->lesX[0]--;
+            break;
+        case DROITE:
+            etat->lesX[0]++;
+            break;
+    }
+
+    // Sortie par un trou : la tête réapparaît sur le bord opposé
+    if (etat->lesX[0] <= 0)
+    {
+        etat->lesX[0] = LARGEUR_PLATEAU;
+        etat->trouTraverse = true;
+    }
+    else if (etat->lesX[0] > LARGEUR_PLATEAU)
+    {
+        etat->lesX[0] = 1;
+        etat->trouTraverse = true;
+    }
+    if (etat->lesY[0] <= 0)
+    {
+        etat->lesY[0] = HAUTEUR_PLATEAU;
+        etat->trouTraverse = true;
+    }
+    else if (etat->lesY[0] > HAUTEUR_PLATEAU)
+    {
+        etat->lesY[0] = 1;
+        etat->trouTraverse = true;
+    }
+
+    int x = etat->lesX[0];
+    int y = etat->lesY[0];
+    etat->occupation[x][y]++;
+    etat->direction = direction;
+
+    *pomme = (etat->plateau[x][y] == POMME);
+    if (*pomme)
+    {
+        etat->plateau[x][y] = VIDE;
+    }
+    *collision = (etat->plateau[x][y] == BORDURE) || (etat->occupation[x][y] > 1);  // Bordure, pavé ou corps
+}
+
+
+double chronometrerDecision(const tStrategie *strategie, tEtat *etat, int nbAppels, double surcout, char *direction)
+{
+    // Le lot est chronométré d'un bloc et le coût de l'horloge déduit une seule fois. Avant chaque appel, les champs
+    // que les stratégies modifient (chemin, trouTraverse) sont remis : chaque appel refait le même travail.
+    int chemin = etat->chemin;
+    bool trouTraverse = etat->trouTraverse;
+    struct timespec debut, fin;
+
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    for (int k = 0; k < nbAppels; k++)
+    {
+        etat->chemin = chemin;
+        etat->trouTraverse = trouTraverse;
+        *direction = strategie->decider(etat);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &fin);
+    return tempsEcoule(debut, fin) * NANO_PAR_SECONDE - surcout;
+}
+
+
+int calibrerAppels(const tStrategie *strategie, tCarte carte, double surcout)
+{
+    // Sur l'état de départ, le lot double jusqu'à durer DUREE_LOT_MIN : une décision plus brève qu'une lecture de
+    // l'horloge est ainsi répétée assez pour être mesurée, une recherche coûteuse n'est appelée qu'une fois.
+    static tEtat etat;
+    uint64_t alea = 0;
+    char direction;
+    int nbAppels = 1;
+
+    initEtat(&etat, carte);
+    placerPomme(&etat, 0, 0, &alea);
+    while ((nbAppels < NB_APPELS_MAX) && (chronometrerDecision(strategie, &etat, nbAppels, surcout, &direction) < DUREE_LOT_MIN))
+    {
+        nbAppels *= 2;
+    }
+    return nbAppels;
+}
+
+
+void jouerPartie(const tStrategie *strategie, tCarte carte, uint64_t graine, int nbAppels, double surcout, tBilan *bilan)
+{
+    static tEtat etat;
+    uint64_t alea = graine;
+    bool collision = false;
+    bool pomme = false;
+    int nbPommes = 0;
+    int nbPas = 0;
+    double nanosecondes = 0.0;
+
+    initEtat(&etat, carte);
+    placerPomme(&etat, 0, graine, &alea);
+
+    while (!collision && (nbPommes < NB_POMMES) && (nbPas < PAS_MAX))
+    {
+        char direction;
+        nanosecondes += chronometrerDecision(strategie, &etat, nbAppels, surcout, &direction) / nbAppels;
+        etat.nouvellePomme = false;
+
+        avancer(&etat, direction, &collision, &pomme);
+        nbPas++;
+        if (pomme)
+        {
+            nbPommes++;
+            if (nbPommes < NB_POMMES)
+            {
+                placerPomme(&etat, nbPommes, graine, &alea);
+            }
+        }
+    }
+
+    bilan->parties++;
+    // Une seule issue par partie : la dernière pomme mangée sur une collision compte comme partie complète.
+    bilan->completes += (nbPommes == NB_POMMES);
+    bilan->collisions += (collision && (nbPommes < NB_POMMES));
+    bilan->bloquees += (!collision && (nbPommes < NB_POMMES));
+    bilan->pasCompletes += (nbPommes == NB_POMMES) ? nbPas : 0;
+    bilan->pommes += nbPommes;
+    bilan->decisions += nbPas;
+    bilan->nanosecondes += nanosecondes;
+}
+
+
+/************************************************/
+/*		STRATÉGIES DES DIFFÉRENTES VERSIONS		*/
+/************************************************/
+
+char decisionVersion1(tEtat *etat)
+{
+    return choisirDirection(etat->lesX, etat->lesY, etat->pommeX, etat->pommeY);
+}
+
+
+char choisirDirection(int lesX[], int lesY[], int pommeX, int pommeY)
+{
+    // Différence de position entre la tête et la pomme
+    int diffX = pommeX - lesX[0];
+    int diffY = pommeY - lesY[0];
+
+    // Déplacement sur l'axe où la pomme est la plus éloignée, sans aucune vérification de collision
+    if (abs(diffX) > abs(diffY))
+    {
+        return (diffX > 0) ? DROITE : GAUCHE;
+    }
+    else
+    {
+        return (diffY > 0) ? BAS : HAUT;
+    }
+}
+
+
+char decisionVersion2(tEtat *etat)
+{
+    // Le chemin (direct ou par un trou) est choisi une fois par pomme, et l'indicateur de passage remis à zéro.
+    if (etat->nouvellePomme)
+    {
+        etat->trouTraverse = false;
+        etat->chemin = distancePlusCourt(etat->lesX, etat->lesY, etat->pommeX, etat->pommeY);
+    }
+
+    int cibleX = etat->pommeX;
+    int cibleY = etat->pommeY;
+    if (!etat->trouTraverse)  // Tant que le trou n'est pas franchi, il est la cible
+    {
+        switch (etat->chemin)
+        {
+            case CHEMIN_HAUT:
+                cibleX = TROU_HAUT.x;
+                cibleY = TROU_HAUT.y;
+                break;
+            case CHEMIN_BAS:
+                cibleX = TROU_BAS.x;
+                cibleY = TROU_BAS.y;
+                break;
+            case CHEMIN_GAUCHE:
+                cibleX = TROU_GAUCHE.x;
+                cibleY = TROU_GAUCHE.y;
+                break;
+            case CHEMIN_DROITE:
+                cibleX = TROU_DROITE.x;
+                cibleY = TROU_DROITE.y;
+                break;
+        }
+    }
+
+    char direction = etat->direction;
+    determinerDirectionVersObjectif(etat, &direction, cibleX, cibleY);
+    return direction;
+}
+
+
+void determinerDirectionVersObjectif(tEtat *etat, char *direction, int cibleX, int cibleY)
+{
+    int dx = cibleX - etat->lesX[0];  // Différence en X entre la tête du serpent et la cible
+    int dy = cibleY - etat->lesY[0];  // Différence en Y entre la tête du serpent et la cible
+
+    if (dy != 0)  // Vertical d'abord, puis horizontal vers la cible, horizontal opposé et enfin vertical opposé
+    {
+        *direction = (dy > 0) ? BAS : HAUT;
+        if (detecterCollision(etat, *direction))
+        {
+            *direction = (dx > 0) ? DROITE : GAUCHE;
+            if (detecterCollision(etat, *direction))
+            {
+                *direction = (dx > 0) ? GAUCHE : DROITE;
+                if (detecterCollision(etat, *direction))
+                {
+                    *direction = (dy > 0) ? HAUT : BAS;
+                }
+            }
+        }
+    }
+    else if (dx != 0)  // Horizontal d'abord, puis vertical, vertical opposé et enfin horizontal opposé
+    {
+        *direction = (dx > 0) ? DROITE : GAUCHE;
+        if (detecterCollision(etat, *direction))
+        {
+            *direction = (dy > 0) ? BAS : HAUT;
+            if (detecterCollision(etat, *direction))
+            {
+                *direction = (dy > 0) ? HAUT : BAS;
+                if (detecterCollision(etat, *direction))
+                {
+                    *direction = (dx > 0) ? GAUCHE : DROITE;
+                }
+            }
+        }
+    }
+}
+
+
+int distancePlusCourt(int lesX[], int lesY[], int pommeX, int pommeY)
+{
+    // Distance directe, puis par chaque trou : jusqu'au trou, puis du trou opposé jusqu'à la pomme
+    int tab[5] = {
+        abs(lesX[0] - pommeX) + abs(lesY[0] - pommeY),
+        abs(lesX[0] - TROU_HAUT.x) + abs(lesY[0] - TROU_HAUT.y) + abs(pommeX - TROU_BAS.x) + abs(pommeY - TROU_BAS.y),
+        abs(lesX[0] - TROU_BAS.x) + abs(lesY[0] - TROU_BAS.y) + abs(pommeX - TROU_HAUT.x) + abs(pommeY - TROU_HAUT.y),
+        abs(lesX[0] - TROU_GAUCHE.x) + abs(lesY[0] - TROU_GAUCHE.y) + abs(pommeX - TROU_DROITE.x) + abs(pommeY - TROU_DROITE.y),
+        abs(lesX[0] - TROU_DROITE.x) + abs(lesY[0] - TROU_DROITE.y) + abs(pommeX - TROU_GAUCHE.x) + abs(pommeY - TROU_GAUCHE.y)
+    };
+    const int lesChemins[5] = {CHEMIN_POMME, CHEMIN_HAUT, CHEMIN_BAS, CHEMIN_GAUCHE, CHEMIN_DROITE};
+
+    int minDistanceI = 0;
+    for (int i = 0; i < 5; i++)
+    {
+        if (tab[minDistanceI] > tab[i])
+        {
+            minDistanceI = i;
+        }
+    }
+    return lesChemins[minDistanceI];
+}
+
+
+bool detecterCollision(tEtat *etat, char directionProchaine)
+{
+    int nouvelleX = etat->lesX[0];
+    int nouvelleY = etat->lesY[0];
+
+    switch (directionProchaine)
+    {
+        case HAUT:
+            nouvelleY--;
+            break;
+        case BAS:
+            nouvelleY++;
+            break;
+        case GAUCHE:
+            nouvelleX--;
+            break;
+        case DROITE:
+            nouvelleX++;
+            break;
+    }
+
+    // Hors du plateau (sortie par un trou) : la version 2 ne lit que la grille d'occupation, marge comprise
+    bool dansPlateau = (nouvelleX >= 1) && (nouvelleX <= LARGEUR_PLATEAU) && (nouvelleY >= 1) && (nouvelleY <= HAUTEUR_PLATEAU);
+    return (dansPlateau && (etat->plateau[nouvelleX][nouvelleY] == BORDURE)) || (etat->occupation[nouvelleX][nouvelleY] != 0);
+}
+
+
+char decisionTableau(tEtat *etat)
+{
+    // Les cinq distances sont recalculées à chaque pas
+    int tableau[5] = {
+        abs(etat->lesX[0] - etat->pommeX) + abs(etat->lesY[0] - etat->pommeY),
+        abs(etat->lesX[0] - TROU_HAUT.x) + abs(etat->lesY[0] - TROU_HAUT.y) + abs(etat->pommeX - TROU_BAS.x) + abs(etat->pommeY - TROU_BAS.y),
+        abs(etat->lesX[0] - TROU_BAS.x) + abs(etat->lesY[0] - TROU_BAS.y) + abs(etat->pommeX - TROU_HAUT.x) + abs(etat->pommeY - TROU_HAUT.y),
+        abs(etat->lesX[0] - TROU_GAUCHE.x) + abs(etat->lesY[0] - TROU_GAUCHE.y) + abs(etat->pommeX - TROU_DROITE.x) + abs(etat->pommeY - TROU_DROITE.y),
+        abs(etat->lesX[0] - TROU_DROITE.x) + abs(etat->lesY[0] - TROU_DROITE.y) + abs(etat->pommeX - TROU_GAUCHE.x) + abs(etat->pommeY - TROU_GAUCHE.y)
+    };
+    const Portail lesTrous[5] = {{0, 0}, TROU_HAUT, TROU_BAS, TROU_GAUCHE, TROU_DROITE};
+    int minimunDes5distances = minimunTableau(tableau);
+    char direction;
+
+    // Comme dans l'original, PasserPortails est appelé après que la tête a été ramenée sur le plateau :
+    // il répond toujours faux, et le serpent vise le trou tant que ce chemin reste le plus court.
+    if ((minimunDes5distances == 0) || PasserPortails(etat->lesX, etat->lesY))
+    {
+        direction = directionVersCible(etat->lesX, etat->lesY, etat->pommeX, etat->pommeY);
+    }
+    else
+    {
+        direction = directionVersCible(etat->lesX, etat->lesY, lesTrous[minimunDes5distances].x, lesTrous[minimunDes5distances].y);
+    }
+
+    // Dans l'original, progresser remplace la direction par une direction sûre
+    return trouverDirectionSure(etat->lesX, etat->lesY, direction, etat->plateau);
+}
+
+
+int minimunTableau(int tableau[5])
+{
+    int minDistance = tableau[0];
+    int minDistanceI = 0;
+
+    for (int i = 0; i < 5; i++)
+    {
+        if (minDistance > tableau[i])  // Si une distance plus courte est trouvée
+        {
+            minDistance = tableau[i];
+            minDistanceI = i;
+        }
+    }
+    return minDistanceI;
+}
+
+
+char directionVersCible(int lesX[], int lesY[], int cibleX, int cibleY)
+{
+    // Branche commune aux cinq cas du switch d'origine : vertical d'abord, puis horizontal
+    if ((cibleY - lesY[0]) < 0)
+    {
+        return HAUT;
+    }
+    else if ((cibleY - lesY[0]) > 0)
+    {
+        return BAS;
+    }
+    else if ((cibleX - lesX[0]) < 0)
+    {
+        return GAUCHE;
+    }
+    return DROITE;
+}
+
+
+bool PasserPortails(int lesX[], int lesY[])
+{
+    return (lesX[0] <= 0) || (lesX[0] > LARGEUR_PLATEAU) || (lesY[0] <= 0) || (lesY[0] > HAUTEUR_PLATEAU);
+}
+
+
+bool estSurCorpsSerpent(int x, int y, int lesX[], int lesY[])
+{
+    bool collision = false;
+    for (int i = 1; i < TAILLE; i++)  // Parcourt les anneaux, sauf la tête
+    {
+        if (lesX[i] == x && lesY[i] == y)
+        {
+            collision = true;
+        }
+    }
+    return collision;
+}
+
+
+bool directionEstSure(int x, int y, char direction, int lesX[], int lesY[], tPlateau plateau)
+{
+    switch (direction)
+    {
+        case HAUT:
+            y--;
+            break;
+        case BAS:
+            y++;
+            break;
+        case GAUCHE:
+            x--;
+            break;
+        case DROITE:
+            x++;
+            break;
+    }
+
+    x = (x + LARGEUR_PLATEAU - 1) % LARGEUR_PLATEAU + 1;  // Sorties horizontales du plateau
+    y = (y + HAUTEUR_PLATEAU - 1) % HAUTEUR_PLATEAU + 1;  // Sorties verticales du plateau
+
+    return !estSurCorpsSerpent(x, y, lesX, lesY) && (plateau[x][y] != PAVE) && (plateau[x][y] != BORDURE);
+}
+
+
+char trouverDirectionSure(int lesX[], int lesY[], char directionActuelle, tPlateau plateau)
+{
+    // Direction demandée si elle est sûre, sinon la première sûre dans l'ordre de la version 3
+    const char lesDirections[4] = {GAUCHE, DROITE, HAUT, BAS};
+
+    if (directionEstSure(lesX[0], lesY[0], directionActuelle, lesX, lesY, plateau))
+    {
+        return directionActuelle;
+    }
+    for (int d = 0; d < 4; d++)
+    {
+        if (directionEstSure(lesX[0], lesY[0], lesDirections[d], lesX, lesY, plateau))
+        {
+            return lesDirections[d];
+        }
+    }
+    return directionActuelle;  // Aucune direction sûre : on garde la direction (risquée)
+}
+
+
+char decisionArthur(tEtat *etat)
+{
+    // Le chemin est choisi une fois par pomme ; l'indicateur de passage n'est jamais remis à zéro, comme dans l'original.
+    if (etat->nouvellePomme)
+    {
+        etat->chemin = calculDistance1(etat->lesX, etat->lesY, etat->pommeX, etat->pommeY);
+    }
+
+    int cibleX = etat->pommeX;
+    int cibleY = etat->pommeY;
+    if (!etat->trouTraverse)
+    {
+        switch (etat->chemin)
+        {
+            case CHEMIN_HAUT:
+                cibleX = TROU_HAUT.x;
+                cibleY = TROU_HAUT.y;
+                break;
+            case CHEMIN_BAS:
+                cibleX = TROU_BAS.x;
+                cibleY = TROU_BAS.y;
+                break;
+            case CHEMIN_GAUCHE:
+                cibleX = TROU_GAUCHE.x;
+                cibleY = TROU_GAUCHE.y;
+                break;
+            case CHEMIN_DROITE:
+                cibleX = TROU_DROITE.x;
+                cibleY = TROU_DROITE.y;
+                break;
+        }
+    }
+
+    char direction = etat->direction;
+    directionSerpent1(etat, &direction, cibleX, cibleY);
+    return direction;
+}
+
+
+void directionSerpent1(tEtat *etat, char *direction1, int x, int y)
+{
+    int differenceX = x - etat->lesX[0];
+    int differenceY = y - etat->lesY[0];
+
+    if (differenceY != 0)  // Vertical d'abord
+    {
+        *direction1 = (differenceY > 0) ? BAS : HAUT;
+        if (verifierCollisionProchainDeplacement1(etat, *direction1))
+        {
+            *direction1 = (differenceX > 0) ? DROITE : GAUCHE;
+            if (verifierCollisionProchainDeplacement1(etat, *direction1))
+            {
+                *direction1 = (differenceX > 0) ? GAUCHE : DROITE;
+                if (verifierCollisionProchainDeplacement1(etat, *direction1))
+                {
+                    *direction1 = (differenceY > 0) ? HAUT : BAS;
+                }
+            }
+        }
+    }
+    else if (differenceX != 0)  // Sinon horizontal
+    {
+        *direction1 = (differenceX > 0) ? DROITE : GAUCHE;
+        if (verifierCollisionProchainDeplacement1(etat, *direction1))
+        {
+            *direction1 = (differenceY > 0) ? BAS : HAUT;
+            if (verifierCollisionProchainDeplacement1(etat, *direction1))
+            {
+                *direction1 = (differenceY > 0) ? HAUT : BAS;
+                if (verifierCollisionProchainDeplacement1(etat, *direction1))
+                {
+                    *direction1 = (differenceX > 0) ? GAUCHE : DROITE;
+                }
+            }
+        }
+    }
+}
+
+
+int calculDistance1(int lesX1[], int lesY1[], int pommeX, int pommeY)
+{
+    int passageTrouGauche = abs(lesX1[0] - TROU_GAUCHE.x) + abs(lesY1[0] - TROU_GAUCHE.y) + abs(pommeX - TROU_DROITE.x) + abs(pommeY - TROU_DROITE.y);
+    int passageTrouDroit = abs(lesX1[0] - TROU_DROITE.x) + abs(lesY1[0] - TROU_DROITE.y) + abs(pommeX - TROU_GAUCHE.x) + abs(pommeY - TROU_GAUCHE.y);
+    int passageTrouHaut = abs(lesX1[0] - TROU_HAUT.x) + abs(lesY1[0] - TROU_HAUT.y) + abs(pommeX - TROU_BAS.x) + abs(pommeY - TROU_BAS.y);
+    int passageTrouBas = abs(lesX1[0] - TROU_BAS.x) + abs(lesY1[0] - TROU_BAS.y) + abs(pommeX - TROU_HAUT.x) + abs(pommeY - TROU_HAUT.y);
+    int passageDirect = abs(lesX1[0] - pommeX) + abs(lesY1[0] - pommeY);
+
+    // Chemin direct à égalité, puis priorité aux passages verticaux
+    if (passageDirect <= passageTrouHaut && passageDirect <= passageTrouBas &&
+        passageDirect <= passageTrouGauche && passageDirect <= passageTrouDroit)
+    {
+        return CHEMIN_POMME;
+    }
+    else if (passageTrouHaut <= passageTrouBas)
+    {
+        return CHEMIN_HAUT;
+    }
+    else if (passageTrouBas <= passageTrouGauche && passageTrouBas <= passageTrouDroit)
+    {
+        return CHEMIN_BAS;
+    }
+    else if (passageTrouGauche <= passageTrouDroit)
+    {
+        return CHEMIN_GAUCHE;
+    }
+    return CHEMIN_DROITE;
+}
+
+
+bool verifierCollisionProchainDeplacement1(tEtat *etat, char prochaineDirection1)
+{
+    int nouvelleX = etat->lesX[0];
+    int nouvelleY = etat->lesY[0];
+
+    switch (prochaineDirection1)
+    {
+        case HAUT:
+            nouvelleY--;
+            break;
+        case BAS:
+            nouvelleY++;
+            break;
+        case GAUCHE:
+            nouvelleX--;
+            break;
+        case DROITE:
+            nouvelleX++;
+            break;
+    }
+
+    // Collision avec les bordures (les pavés y sont confondus, comme dans l'original)
+    bool dansPlateau = (nouvelleX >= 1) && (nouvelleX <= LARGEUR_PLATEAU) && (nouvelleY >= 1) && (nouvelleY <= HAUTEUR_PLATEAU);
+    if (dansPlateau && (etat->plateau[nouvelleX][nouvelleY] == BORDURE))
+    {
+        return true;
+    }
+
+    // Collision avec le corps, queue comprise ; seul en jeu, le serpent n'a pas d'adversaire à prévoir
+    for (int i = 0; i < TAILLE; i++)
+    {
+        if ((etat->lesX[i] == nouvelleX) && (etat->lesY[i] == nouvelleY))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+char decisionLargeur(tEtat *etat)
+{
+    return trouverDirectionSure(etat->lesX, etat->lesY, directionPlusCourtChemin(etat, etat->pommeX, etat->pommeY), etat->plateau);
+}
+
+
+char directionPlusCourtChemin(tEtat *etat, int cibleX, int cibleY)
+{
+    // Parcours en largeur depuis la tête ; la sortie par un trou relie la case au bord opposé.
+    // Chaque case retient le premier pas qui y mène : dès que la pomme est atteinte, ce premier pas est la direction à prendre.
+    static int file[NB_CASES];
+    static char premierPas[NB_CASES];
+    static unsigned int marque[NB_CASES];
+    static unsigned int generation = 0;
+    const char lesDirections[4] = {HAUT, BAS, GAUCHE, DROITE};
+    const int lesDx[4] = {0, 0, -1, 1};
+    const int lesDy[4] = {-1, 1, 0, 0};
+    int debut = 0;
+    int fin = 0;
+
+    generation++;
+    for (int i = 0; i < TAILLE; i++)  // Le corps (tête comprise) est bloquant
+    {
+        marque[etat->lesX[i] * (HAUTEUR_PLATEAU+1) + etat->lesY[i]] = generation;
+    }
+    int caseTete = etat->lesX[0] * (HAUTEUR_PLATEAU+1) + etat->lesY[0];
+    int caseCible = cibleX * (HAUTEUR_PLATEAU+1) + cibleY;
+    file[fin++] = caseTete;
+
+    while (debut < fin)
+    {
+        int c = file[debut++];
+        int x = c / (HAUTEUR_PLATEAU+1);
+        int y = c % (HAUTEUR_PLATEAU+1);
+
+        for (int d = 0; d < 4; d++)
+        {
+            int vx = (x + lesDx[d] + LARGEUR_PLATEAU - 1) % LARGEUR_PLATEAU + 1;
+            int vy = (y + lesDy[d] + HAUTEUR_PLATEAU - 1) % HAUTEUR_PLATEAU + 1;
+            int v = vx * (HAUTEUR_PLATEAU+1) + vy;
+
+            if ((marque[v] == generation) || (etat->plateau[vx][vy] == BORDURE) || (etat->plateau[vx][vy] == PAVE))
+            {
+                continue;
+            }
+            marque[v] = generation;
+            premierPas[v] = (c == caseTete) ? lesDirections[d] : premierPas[c];
+            if (v == caseCible)
+            {
+                return premierPas[v];
+            }
+            file[fin++] = v;
+        }
+    }
+    return etat->direction;  // Pomme inaccessible : trouverDirectionSure choisira une direction sûre
+}
+
+
+/************************************************/
+/*				 FONCTIONS UTILITAIRES 			*/
+/************************************************/
+
+double coutHorloge(void)
+{
+    // Deux lectures consécutives de l'horloge encadrent chaque lot de décisions : leur coût est mesuré à vide puis déduit.
+    struct timespec debut, fin, inutile;
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    for (int i = 0; i < NB_MESURES_HORLOGE; i++)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &inutile);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &fin);
+    return tempsEcoule(debut, fin) * NANO_PAR_SECONDE / NB_MESURES_HORLOGE;
+}
+
+
+double tempsEcoule(struct timespec debut, struct timespec fin)
+{
+    return (fin.tv_sec - debut.tv_sec) + (fin.tv_nsec - debut.tv_nsec) / NANO_PAR_SECONDE;
+}
+
+
+uint64_t aleatoireSuivant(uint64_t *etat)
+{
+    uint64_t z = (*etat += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
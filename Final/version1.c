@@ -26,6 +26,8 @@
 #include <unistd.h>
 #include <termios.h>
 #include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
 #include <time.h>
 
 
@@ -55,7 +57,7 @@
 #define VIDE ' '
 #define POMME '6'
 
-#define PARSECONDE 1000000.0
+#define NANO_PAR_SECONDE 1000000000.0
 
 
 // définition d'un type pour le plateau : tPlateau
@@ -78,10 +80,12 @@ void afficher(int, int, char);
 void effacer(int x, int y);
 void dessinerSerpent(int lesX[], int lesY[]);
 void progresser(int lesX[], int lesY[], char direction, tPlateau plateau, bool * collision, bool * pomme);
+double tempsEcoule(struct timespec debut, struct timespec fin);
 void gotoxy(int x, int y);
 int kbhit();
 void disable_echo();
 void enable_echo();
+void interrompre(int numeroSignal);
 
 
 int main()
@@ -128,7 +132,9 @@ int main()
 
 	// boucle de jeu. Arret si touche STOP, si collision avec une bordure ou
 	// si toutes les pommes sont mangées
-	time_t debut = clock();
+	struct timespec debutMur, debutCpu;
+	clock_gettime(CLOCK_MONOTONIC, &debutMur);
+	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &debutCpu);
 	do {
 		
 		if ( (lesPommesX[nbPommes] - lesX[0]) > 0)
@@ -178,12 +184,14 @@ int main()
 	gotoxy(LARGEUR_PLATEAU+1, 1);
 	if (gagne)
 	{
-		clock_t fin = clock();
+		struct timespec finMur, finCpu;
+		clock_gettime(CLOCK_MONOTONIC, &finMur);
+		clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &finCpu);
 		enable_echo();
 		gotoxy(2, HAUTEUR_PLATEAU+1);
 		printf("Compteur de pas : %d\n", nbDepUnitaires);
         gotoxy(2,HAUTEUR_PLATEAU+2);
-		printf("Temps écoulé : %f en seconde\n", difftime(fin, debut) / PARSECONDE );
+		printf("Temps écoulé : %f en seconde (CPU : %f en seconde)\n", tempsEcoule(debutMur, finMur), tempsEcoule(debutCpu, finCpu));
 	}
 	return EXIT_SUCCESS;
 }
@@ -317,41 +325,37 @@ void progresser(int lesX[], int lesY[], char direction, tPlateau plateau, bool *
 /************************************************/
 /*				 FONCTIONS UTILITAIRES 			*/
 /************************************************/
+double tempsEcoule(struct timespec debut, struct timespec fin)
+{
+    return (fin.tv_sec - debut.tv_sec) + (fin.tv_nsec - debut.tv_nsec) / NANO_PAR_SECONDE;
+}
+
 void gotoxy(int x, int y)
 { 
     printf("\033[%d;%df", y, x);
 }
 
+// Attributs du terminal au lancement, rétablis à la fin du programme.
+struct termios terminalInitial;
+bool terminalModifie = false;
+
 int kbhit()
 {
 	// la fonction retourne :
 	// 1 si un caractere est present
 	// 0 si pas de caractere présent
-	int unCaractere = 0;
-	struct termios oldt, newt;
-	int ch;
-	int oldf;
-
-	// mettre le terminal en mode non bloquant
-	tcgetattr(STDIN_FILENO, &oldt);
-	newt = oldt;
-	newt.c_lflag &= ~(ICANON | ECHO);
-	tcsetattr(STDIN_FILENO, TCSANOW, &newt);
-	oldf = fcntl(STDIN_FILENO, F_GETFL, 0);
-	fcntl(STDIN_FILENO, F_SETFL, oldf | O_NONBLOCK);
- 
-	ch = getchar();
-
-	// restaurer le mode du terminal
-	tcsetattr(STDIN_FILENO, TCSANOW, &oldt);
-	fcntl(STDIN_FILENO, F_SETFL, oldf);
- 
-	if(ch != EOF)
-	{
-		ungetc(ch, stdin);
-		unCaractere = 1;
-	} 
-	return unCaractere;
+	// Le terminal reste en mode non canonique pendant toute la partie (disable_echo) :
+	// un seul poll() sans attente suffit, sans changer les réglages à chaque tour.
+	struct pollfd entree = {STDIN_FILENO, POLLIN, 0};
+
+	return (poll(&entree, 1, 0) > 0) && (entree.revents & POLLIN);
+}
+
+// Rétablit le terminal quand le programme est interrompu (Ctrl+C) pendant la partie.
+void interrompre(int numeroSignal)
+{
+    enable_echo();
+    _exit(128 + numeroSignal);
 }
 
 // Fonction pour désactiver l'echo
@@ -360,42 +364,43 @@ void disable_echo()
     struct termios tty;
 
     // Obtenir les attributs du terminal
-    if (tcgetattr(STDIN_FILENO, &tty) == -1) 
+    if (tcgetattr(STDIN_FILENO, &terminalInitial) == -1) 
 	{
         perror("tcgetattr");
         exit(EXIT_FAILURE);
     }
 
-    // Désactiver le flag ECHO
-    tty.c_lflag &= ~ECHO;
+    // Désactiver l'écho et le mode ligne ; une lecture rend la main tout de suite
+    tty = terminalInitial;
+    tty.c_lflag &= ~(ICANON | ECHO);
+    tty.c_cc[VMIN] = 0;
+    tty.c_cc[VTIME] = 0;
 
-    // Appliquer les nouvelles configurations
+    // Appliquer les nouvelles configurations, une seule fois pour toute la partie
     if (tcsetattr(STDIN_FILENO, TCSANOW, &tty) == -1)
 	{
         perror("tcsetattr");
         exit(EXIT_FAILURE);
     }
+    terminalModifie = true;
+    setvbuf(stdin, NULL, _IONBF, 0); // getchar() lit un seul octet : poll() voit encore les touches suivantes.
+    atexit(enable_echo);
+    signal(SIGINT, interrompre);
+    signal(SIGTERM, interrompre);
 }
 
 // Fonction pour réactiver l'echo
 void enable_echo()
 {
-    struct termios tty;
-
-    // Obtenir les attributs du terminal
-    if (tcgetattr(STDIN_FILENO, &tty) == -1)
-	{
-        perror("tcgetattr");
-        exit(EXIT_FAILURE);
+    if (!terminalModifie)
+    {
+        return; // Terminal déjà rétabli.
     }
 
-    // Réactiver le flag ECHO
-    tty.c_lflag |= ECHO;
-
-    // Appliquer les nouvelles configurations
-    if (tcsetattr(STDIN_FILENO, TCSANOW, &tty) == -1)
+    // Rétablir les attributs d'origine du terminal
+    if (tcsetattr(STDIN_FILENO, TCSANOW, &terminalInitial) == -1)
 	{
         perror("tcsetattr");
-        exit(EXIT_FAILURE);
     }
-}
\ No newline at end of file
+    terminalModifie = false;
+}
@@ -25,6 +25,8 @@
 #include <unistd.h>
 #include <termios.h>
 #include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
 #include <time.h>
 
 
@@ -45,7 +47,7 @@
 #define BAS 's'  // Touche pour diriger le serpent vers le bas.
 #define GAUCHE 'q'  // Touche pour diriger le serpent vers la gauche.
 #define DROITE 'd'  // Touche pour diriger le serpent vers la droite.
-#define PARSECONDE 1000000.0
+#define NANO_PAR_SECONDE 1000000000.0 // Nombre de nanosecondes par seconde.
 
 
 int lesPommesX[NB_POMMES] = {75, 75, 78, 2, 8, 78, 74,  2, 72, 5}; // Positions en X des pommes.
@@ -77,10 +79,12 @@ void afficher(int x, int y, char car); // Affiche un caractère à une position
 void effacer(int x, int y); // Efface un caractère à une position donnée.
 void dessinerSerpent(int lesX[], int lesY[]); // Affiche le serpent à l'écran.
 void progresser(int lesX[], int lesY[], char direction, tPlateau plateau, bool *collision, bool *pomme); // Gère le déplacement du serpent.
+double tempsEcoule(struct timespec debut, struct timespec fin); // Retourne la durée en secondes entre deux instants.
 void gotoxy(int x, int y); // Déplace le curseur à une position donnée.
 int kbhit(); // Vérifie si une touche a été pressée.
 void disable_echo(); // Désactive l'affichage des touches dans le terminal.
 void enable_echo(); // Réactive l'affichage des touches dans le terminal.
+void interrompre(int numeroSignal); // Rétablit le terminal puis quitte (Ctrl+C).
 int PasserPortails(int lesX[], int lesY[]); // Gère la téléportation via les portails.
 int minimunTableau(tChemins Tableau); // Détermine le chemin le plus court vers une pomme.
 bool estSurCorpsSerpent(int x, int y, int lesX[], int lesY[]); // Vérifie si une position est occupée par le corps du serpent.
@@ -127,7 +131,9 @@ int main()
     disable_echo();  // Désactive l'affichage des touches.
     direction = DROITE;  // Initialisation de la direction du serpent vers la droite.
 
-    time_t debut = clock(); // Enregistre l'heure de début pour calculer le temps d'exécution du programme.
+    struct timespec debutMur, debutCpu; // Heure de début (horloge monotone) et temps CPU consommé au début de la partie.
+    clock_gettime(CLOCK_MONOTONIC, &debutMur);
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &debutCpu);
     
     // Boucle de jeu. Le jeu continue tant que l'utilisateur n'appuie pas sur la touche STOP ou qu'il n'y a pas de collision ou que toutes les pommes ne sont pas mangées.
     do {
@@ -384,12 +390,14 @@ int main()
 	gotoxy(LARGEUR_PLATEAU+1, 1); // Déplace le curseur en dehors du plateau de jeu.
 	if (gagne)
 	{
-		clock_t fin = clock(); // Enregistre l'heure de fin pour calculer le temps d'exécution.
+		struct timespec finMur, finCpu; // Enregistre l'heure de fin pour calculer le temps d'exécution.
+		clock_gettime(CLOCK_MONOTONIC, &finMur);
+		clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &finCpu);
 		enable_echo();
 		gotoxy(2, HAUTEUR_PLATEAU+1);
 		printf("Compteur de pas : %d\n", nbDepUnitaires);// Affiche les performances du programme.
         gotoxy(2,HAUTEUR_PLATEAU+2);
-		printf("Temps écoulé : %f en seconde\n", difftime(fin, debut) / PARSECONDE );// Affiche les performances du programme.
+		printf("Temps écoulé : %f en seconde (CPU : %f en seconde)\n", tempsEcoule(debutMur, finMur), tempsEcoule(debutCpu, finCpu));// Affiche les performances du programme.
 	}
 	return EXIT_SUCCESS;
 }
@@ -676,41 +684,37 @@ int minimunTableau(tChemins Tableau){
 /************************************************/
 /*				 FONCTIONS UTILITAIRES 			*/
 /************************************************/
+double tempsEcoule(struct timespec debut, struct timespec fin)
+{
+    return (fin.tv_sec - debut.tv_sec) + (fin.tv_nsec - debut.tv_nsec) / NANO_PAR_SECONDE;
+}
+
 void gotoxy(int x, int y)
 { 
     printf("\033[%d;%df", y, x);
 }
 
+// Attributs du terminal au lancement, rétablis à la fin du programme.
+struct termios terminalInitial;
+bool terminalModifie = false;
+
 int kbhit()
 {
 	// la fonction retourne :
 	// 1 si un caractere est present
 	// 0 si pas de caractere présent
-	int unCaractere = 0;
-	struct termios oldt, newt;
-	int ch;
-	int oldf;
-
-	// mettre le terminal en mode non bloquant
-	tcgetattr(STDIN_FILENO, &oldt);
-	newt = oldt;
-	newt.c_lflag &= ~(ICANON | ECHO);
-	tcsetattr(STDIN_FILENO, TCSANOW, &newt);
-	oldf = fcntl(STDIN_FILENO, F_GETFL, 0);
-	fcntl(STDIN_FILENO, F_SETFL, oldf | O_NONBLOCK);
- 
-	ch = getchar();
-
-	// restaurer le mode du terminal
-	tcsetattr(STDIN_FILENO, TCSANOW, &oldt);
-	fcntl(STDIN_FILENO, F_SETFL, oldf);
- 
-	if(ch != EOF)
-	{
-		ungetc(ch, stdin);
-		unCaractere = 1;
-	} 
-	return unCaractere;
+	// Le terminal reste en mode non canonique pendant toute la partie (disable_echo) :
+	// un seul poll() sans attente suffit, sans changer les réglages à chaque tour.
+	struct pollfd entree = {STDIN_FILENO, POLLIN, 0};
+
+	return (poll(&entree, 1, 0) > 0) && (entree.revents & POLLIN);
+}
+
+// Rétablit le terminal quand le programme est interrompu (Ctrl+C) pendant la partie.
+void interrompre(int numeroSignal)
+{
+    enable_echo();
+    _exit(128 + numeroSignal);
 }
 
 // Fonction pour désactiver l'echo
@@ -719,42 +723,43 @@ void disable_echo()
     struct termios tty;
 
     // Obtenir les attributs du terminal
-    if (tcgetattr(STDIN_FILENO, &tty) == -1) 
+    if (tcgetattr(STDIN_FILENO, &terminalInitial) == -1) 
 	{
         perror("tcgetattr");
         exit(EXIT_FAILURE);
     }
 
-    // Désactiver le flag ECHO
-    tty.c_lflag &= ~ECHO;
+    // Désactiver l'écho et le mode ligne ; une lecture rend la main tout de suite
+    tty = terminalInitial;
+    tty.c_lflag &= ~(ICANON | ECHO);
+    tty.c_cc[VMIN] = 0;
+    tty.c_cc[VTIME] = 0;
 
-    // Appliquer les nouvelles configurations
+    // Appliquer les nouvelles configurations, une seule fois pour toute la partie
     if (tcsetattr(STDIN_FILENO, TCSANOW, &tty) == -1)
 	{
         perror("tcsetattr");
         exit(EXIT_FAILURE);
     }
+    terminalModifie = true;
+    setvbuf(stdin, NULL, _IONBF, 0); // getchar() lit un seul octet : poll() voit encore les touches suivantes.
+    atexit(enable_echo);
+    signal(SIGINT, interrompre);
+    signal(SIGTERM, interrompre);
 }
 
 // Fonction pour réactiver l'echo
 void enable_echo()
 {
-    struct termios tty;
-
-    // Obtenir les attributs du terminal
-    if (tcgetattr(STDIN_FILENO, &tty) == -1)
-	{
-        perror("tcgetattr");
-        exit(EXIT_FAILURE);
+    if (!terminalModifie)
+    {
+        return; // Terminal déjà rétabli.
     }
 
-    // Réactiver le flag ECHO
-    tty.c_lflag |= ECHO;
-
-    // Appliquer les nouvelles configurations
-    if (tcsetattr(STDIN_FILENO, TCSANOW, &tty) == -1)
+    // Rétablir les attributs d'origine du terminal
+    if (tcsetattr(STDIN_FILENO, TCSANOW, &terminalInitial) == -1)
 	{
         perror("tcsetattr");
-        exit(EXIT_FAILURE);
     }
-}
\ No newline at end of file
+    terminalModifie = false;
+}
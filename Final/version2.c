@@ -23,6 +23,8 @@
 #include <unistd.h>
 #include <termios.h>
 #include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
 #include <time.h>
 
 #define TAILLE 10  // Taille du serpent (longueur initiale). Dans ce cas, il est de 10 unités.
@@ -47,6 +49,7 @@
 #define CHEMIN_GAUCHE 3  // Identifiant pour la direction gauche.
 #define CHEMIN_DROITE 4  // Identifiant pour la direction droite.
 #define CHEMIN_POMME 5  // Identifiant pour la direction menant vers une pomme.
+#define NANO_PAR_SECONDE 1000000000.0  // Nombre de nanosecondes par seconde.
 
 typedef struct {
     int x;  // Coordonnée X du Portail.
@@ -59,12 +62,14 @@ const Portail TROU_GAUCHE = {0, 20};  // Portail à gauche du plateau (Portail d
 const Portail TROU_DROITE = {80, 20};  // Portail à droite du plateau (Portail de coordonnées (80, 20)).
 
 typedef char tPlateau[LARGEUR_PLATEAU + 1][HAUTEUR_PLATEAU + 1];  // Initialiser le plateau de jeu.
+typedef unsigned char tOccupation[LARGEUR_PLATEAU + 2][HAUTEUR_PLATEAU + 2];  // Nombre d'anneaux du serpent sur chaque case (une case de marge de chaque côté).
 
 const int lesPommesX[NB_POMMES] = {75, 75, 78, 2, 8, 78, 74, 2, 72, 5};  // Positions en X des pommes.
 const int lesPommesY[NB_POMMES] = {8, 39, 2, 2, 5, 39, 33, 38, 35, 2};  // Positions en Y des pommes.
 
 int NbPasSerpent = 0;  // Compteur du nombre de déplacements effectués par le serpent.
 int NbPommesManger = 0;  // Compteur du nombre de pommes mangées par le serpent.
+tOccupation occupation;  // Cases occupées par le serpent, mise à jour à chaque déplacement (tête ajoutée, queue retirée).
 
 void initPlateau(tPlateau plateau);  // Fonction pour initialiser le plateau de jeu.
 void dessinerPlateau(tPlateau plateau);  // Fonction pour dessiner le plateau dans la console.
@@ -76,14 +81,18 @@ void determinerDirectionVersObjectif(int lesX[], int lesY[], tPlateau plateau, c
 bool detecterCollision(int lesX[], int lesY[], tPlateau plateau, char directionProchaine);  // Fonction pour détecter une collision avec le serpent.
 int distancePlusCourt(int lesX[], int lesY[], int pommeX, int pommeY);  // Fonction pour calculer la distance la plus courte entre le serpent et une pomme.
 void progresser(int lesX[], int lesY[], char direction, tPlateau plateau, bool *collision, bool *pomme, bool *SerpentPasserPortail);  // Fonction pour faire avancer le serpent dans la direction choisie.
+double tempsEcoule(struct timespec debut, struct timespec fin);  // Retourne la durée en secondes entre deux instants.
 void gotoxy(int x, int y);  // Fonction pour déplacer le curseur à une position donnée sur la console.
 int kbhit();  // Fonction pour détecter si une touche a été pressée.
 void disable_echo();  // Fonction pour désactiver l'affichage des touches sur la console.
 void enable_echo();  // Fonction pour réactiver l'affichage des touches sur la console.
+void interrompre(int numeroSignal); // Rétablit le terminal puis quitte (Ctrl+C).
 
 int main()
 {
-    clock_t begin = clock();  // Enregistre l'heure de début pour calculer le temps d'exécution du programme.
+    struct timespec debutMur, debutCpu;  // Heure de début (horloge monotone) et temps CPU consommé, pour calculer le temps d'exécution.
+    clock_gettime(CLOCK_MONOTONIC, &debutMur);
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &debutCpu);
 
     // 2 tableaux contenant les positions des éléments qui constituent le serpent
     int lesX[TAILLE];  // Tableau pour les positions en X des différentes parties du serpent.
@@ -108,6 +117,7 @@ int main()
     for (int i = 0; i < TAILLE; i++) {
         lesX[i] = X_DEPART_SERPENT - i;  // Position X de chaque partie du serpent.
         lesY[i] = Y_DEPART_SERPENT;  // Position Y de chaque partie du serpent.
+        occupation[lesX[i]][lesY[i]]++;  // La case est occupée par un anneau.
     }
 
     // Mise en place du plateau
@@ -200,12 +210,15 @@ int main()
     enable_echo();  // Réactive l'affichage des touches.
     gotoxy(1, HAUTEUR_PLATEAU + 1);  // Déplace le curseur en dehors du plateau de jeu.
 
-    clock_t end = clock();  // Enregistre l'heure de fin pour calculer le temps d'exécution.
-    double tmpsCPU = ((end - begin) * 1.0) / CLOCKS_PER_SEC;  // Calcule le temps CPU en secondes.
+    struct timespec finMur, finCpu;  // Enregistre l'heure de fin pour calculer le temps d'exécution.
+    clock_gettime(CLOCK_MONOTONIC, &finMur);
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &finCpu);
+    double tmpsMur = tempsEcoule(debutMur, finMur);  // Durée réelle de la partie, attentes comprises.
+    double tmpsCPU = tempsEcoule(debutCpu, finCpu);  // Calcule le temps CPU en secondes.
 
     // Affiche les performances du programme.
     printf("Compteur de pas : %d\n", NbPasSerpent);
-    printf("Temps CPU = %.3f secondes\n", tmpsCPU);
+    printf("Temps écoulé = %.3f secondes, temps CPU = %.3f secondes\n", tmpsMur, tmpsCPU);
 
     return EXIT_SUCCESS;  // Terminer le programme avec succès.
 }
@@ -436,13 +449,10 @@ bool detecterCollision(int lesX[], int lesY[], tPlateau plateau, char directionP
         return true; // Collision avec une bordure du plateau
     }
 
-    // Vérification des collisions avec le corps du serpent (si une partie du corps est sur la nouvelle position)
-    for (int i = 0; i < TAILLE; i++)
+    // Vérification des collisions avec le corps du serpent : une seule lecture dans la grille d'occupation
+    if (occupation[nouvelleX][nouvelleY] != 0)
     {
-        if (lesX[i] == nouvelleX && lesY[i] == nouvelleY)
-        {
-            return true; // Collision avec une partie du corps du serpent
-        }
+        return true; // Collision avec une partie du corps du serpent
     }
 
     // Si aucune collision n'est détectée, retourner false
@@ -452,6 +462,7 @@ bool detecterCollision(int lesX[], int lesY[], tPlateau plateau, char directionP
 void progresser(int lesX[], int lesY[], char direction, tPlateau plateau, bool *collision, bool *pomme, bool *SerpentPasserPortail)
 {
     // Efface le dernier élément (queue) du serpent avant de mettre à jour les autres segments
+    occupation[lesX[TAILLE - 1]][lesY[TAILLE - 1]]--;  // La queue libère sa case
     effacer(lesX[TAILLE - 1], lesY[TAILLE - 1]);
 
     // Déplace chaque segment du serpent pour le faire progresser d'une case
@@ -502,6 +513,8 @@ void progresser(int lesX[], int lesY[], char direction, tPlateau plateau, bool *
         *SerpentPasserPortail = true; // Indique que le serpent a traversé un portail
     }
 
+    occupation[lesX[0]][lesY[0]]++;  // La nouvelle tête occupe sa case
+
     // Initialisation de l'indicateur de pomme détectée
     *pomme = false;
 
@@ -529,49 +542,82 @@ void progresser(int lesX[], int lesY[], char direction, tPlateau plateau, bool *
 /*				 FONCTIONS UTILITAIRES 			*/
 /************************************************/
 
+double tempsEcoule(struct timespec debut, struct timespec fin)
+{
+    return (fin.tv_sec - debut.tv_sec) + (fin.tv_nsec - debut.tv_nsec) / NANO_PAR_SECONDE;
+}
+
 void gotoxy(int x, int y)
 {
     printf("\033[%d;%df", y, x);
 }
 
+// Attributs du terminal au lancement, rétablis à la fin du programme.
+struct termios terminalInitial;
+bool terminalModifie = false;
+
 int kbhit()
 {
-    struct termios oldt, newt;
-    int ch;
-    int oldf;
-
-    tcgetattr(STDIN_FILENO, &oldt);
-    newt = oldt;
-    newt.c_lflag &= ~(ICANON | ECHO);
-    tcsetattr(STDIN_FILENO, TCSANOW, &newt);
-    oldf = fcntl(STDIN_FILENO, F_GETFL, 0);
-    fcntl(STDIN_FILENO, F_SETFL, oldf | O_NONBLOCK);
-
-    ch = getchar();
-
-    tcsetattr(STDIN_FILENO, TCSANOW, &oldt);
-    fcntl(STDIN_FILENO, F_SETFL, oldf);
+	// la fonction retourne :
+	// 1 si un caractere est present
+	// 0 si pas de caractere présent
+	// Le terminal reste en mode non canonique pendant toute la partie (disable_echo) :
+	// un seul poll() sans attente suffit, sans changer les réglages à chaque tour.
+	struct pollfd entree = {STDIN_FILENO, POLLIN, 0};
+
+	return (poll(&entree, 1, 0) > 0) && (entree.revents & POLLIN);
+}
 
-    if (ch != EOF)
-    {
-        ungetc(ch, stdin);
-        return 1;
-    }
-    return 0;
+// Rétablit le terminal quand le programme est interrompu (Ctrl+C) pendant la partie.
+void interrompre(int numeroSignal)
+{
+    enable_echo();
+    _exit(128 + numeroSignal);
 }
 
+// Fonction pour désactiver l'echo
 void disable_echo()
 {
     struct termios tty;
-    tcgetattr(STDIN_FILENO, &tty);
-    tty.c_lflag &= ~ECHO;
-    tcsetattr(STDIN_FILENO, TCSANOW, &tty);
+
+    // Obtenir les attributs du terminal
+    if (tcgetattr(STDIN_FILENO, &terminalInitial) == -1) 
+	{
+        perror("tcgetattr");
+        exit(EXIT_FAILURE);
+    }
+
+    // Désactiver l'écho et le mode ligne ; une lecture rend la main tout de suite
+    tty = terminalInitial;
+    tty.c_lflag &= ~(ICANON | ECHO);
+    tty.c_cc[VMIN] = 0;
+    tty.c_cc[VTIME] = 0;
+
+    // Appliquer les nouvelles configurations, une seule fois pour toute la partie
+    if (tcsetattr(STDIN_FILENO, TCSANOW, &tty) == -1)
+	{
+        perror("tcsetattr");
+        exit(EXIT_FAILURE);
+    }
+    terminalModifie = true;
+    setvbuf(stdin, NULL, _IONBF, 0); // getchar() lit un seul octet : poll() voit encore les touches suivantes.
+    atexit(enable_echo);
+    signal(SIGINT, interrompre);
+    signal(SIGTERM, interrompre);
 }
 
+// Fonction pour réactiver l'echo
 void enable_echo()
 {
-    struct termios tty;
-    tcgetattr(STDIN_FILENO, &tty);
-    tty.c_lflag |= ECHO;
-    tcsetattr(STDIN_FILENO, TCSANOW, &tty);
+    if (!terminalModifie)
+    {
+        return; // Terminal déjà rétabli.
+    }
+
+    // Rétablir les attributs d'origine du terminal
+    if (tcsetattr(STDIN_FILENO, TCSANOW, &terminalInitial) == -1)
+	{
+        perror("tcsetattr");
+    }
+    terminalModifie = false;
 }
@@ -20,6 +20,8 @@
 #include <unistd.h>
 #include <termios.h>
 #include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
 #include <time.h>
 
 // Constantes du jeu
@@ -40,10 +42,11 @@
 #define BAS 's'  // Touche pour diriger le serpent vers le bas.
 #define GAUCHE 'q'  // Touche pour diriger le serpent vers la gauche.
 #define DROITE 'd'  // Touche pour diriger le serpent vers la droite.
-#define PARSECONDE 1000000.0 // Nombre de microsecondes par seconde
+#define NANO_PAR_SECONDE 1000000000.0 // Nombre de nanosecondes par seconde
 #define PAVE '#' // Représente un pavé d'obstacle
 #define NB_PAVES 6 // Nombre de pavés d'obstacles
 #define TAILLE_PAVE 5 // Dimension (carrée) des pavés
+#define NB_CASES ((LARGEUR_PLATEAU+1) * (HAUTEUR_PLATEAU+1)) // Nombre de cases adressables du plateau.
 
 // Positions des pommes et des pavés
 int lesPommesX[NB_POMMES] = {75, 75, 78, 2, 8, 78, 74, 2, 72, 5}; // Positions en X des pommes.
@@ -53,8 +56,6 @@ int lesPavesY[NB_PAVES] = {3, 3, 34, 34, 21, 15}; // Positions en Y des pavés.
 
 typedef char tPlateau[LARGEUR_PLATEAU+1][HAUTEUR_PLATEAU+1]; // Initialiser le plateau de jeu.
 
-typedef int tChemins[5]; // Initialiser le tableau avec les 5 chemins possibles.
-
 int NbPommesSerpentManger = 0; // Compteur du nombre de déplacements effectués par le serpent.
 int nbDepUnitaires = 0; // Compteur du nombre de pommes mangées par le serpent.
 
@@ -77,16 +78,18 @@ void afficher(int x, int y, char car); // Affiche un caractère à une position
 void effacer(int x, int y); // Efface un caractère à une position donnée.
 void dessinerSerpent(int lesX[], int lesY[]); // Dessine le serpent entier sur le plateau.
 void progresser(int lesX[], int lesY[], char direction, tPlateau plateau, bool *collision, bool *pomme); // Fait avancer le serpent dans une direction donnée.
+double tempsEcoule(struct timespec debut, struct timespec fin); // Retourne la durée en secondes entre deux instants.
 void gotoxy(int x, int y); // Déplace le curseur à une position spécifique dans le terminal.
 int kbhit(void); // Vérifie si une touche a été pressée.
 void disable_echo(void); // Désactive l'écho des touches dans le terminal.
 void enable_echo(void); // Réactive l'écho des touches dans le terminal.
+void interrompre(int numeroSignal); // Rétablit le terminal puis quitte (Ctrl+C).
 bool PasserPortails(int lesX[], int lesY[]); // Gère la traversée des bords du plateau via les portails.
-int minimunTableau(tChemins Tableau); // Retourne l'index de la plus petite distance dans un tableau de distances.
 bool estSurCorpsSerpent(int x, int y, int lesX[], int lesY[]); // Vérifie si une position est occupée par le corps du serpent.
 bool estSurPave(int x, int y, tPlateau plateau); // Vérifie si une position est occupée par un pavé.
 bool directionEstSure(int x, int y, char direction, int lesX[], int lesY[], tPlateau plateau); // Vérifie si une direction est sans danger.
 char trouverDirectionSure(int lesX[], int lesY[], char directionActuelle, tPlateau plateau); // Trouve une direction sûre pour le serpent.
+char directionPlusCourtChemin(int lesX[], int lesY[], int cibleX, int cibleY, char directionActuelle, tPlateau plateau); // Premier pas du plus court chemin vers la cible (parcours en largeur).
 
 
 int main() {
@@ -124,230 +127,14 @@ int main() {
     disable_echo();  // Désactive l'affichage des touches.
     direction = DROITE;  // Initialisation de la direction du serpent vers la droite.
 
-    time_t debut = clock(); // Enregistre l'heure de début pour calculer le temps d'exécution du programme.
+    struct timespec debutMur, debutCpu; // Heure de début (horloge monotone) et temps CPU consommé au début de la partie.
+    clock_gettime(CLOCK_MONOTONIC, &debutMur);
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &debutCpu);
     
     // Boucle de jeu. Le jeu continue tant que l'utilisateur n'appuie pas sur la touche STOP ou qu'il n'y a pas de collision ou que toutes les pommes ne sont pas mangées.
     do {
-		int CheminDirectPomme = abs(lesX[0] - lesPommesX[NbPommesSerpentManger]) + abs(lesY[0] - lesPommesY[NbPommesSerpentManger]); // Calcul de la distance directe entre la tête du serpent et la pomme
-
-        // Calcul des distances en passant par différents portails (haut, bas, gauche, droite)
-        // Chaque chemin nécessite de passer par un portail et d'en sortir de l'autre côté avant d'atteindre la pomme.
-        int CheminPortailHaut = abs(lesX[0] - TROU_HAUT.x) + abs(lesY[0] - TROU_HAUT.y) + abs(lesPommesX[NbPommesSerpentManger] - TROU_BAS.x) + abs(lesPommesY[NbPommesSerpentManger] - TROU_BAS.y);
-        int CheminPortailBas = abs(lesX[0] - TROU_BAS.x) + abs(lesY[0] - TROU_BAS.y) + abs(lesPommesX[NbPommesSerpentManger] - TROU_HAUT.x) + abs(lesPommesY[NbPommesSerpentManger] - TROU_HAUT.y);
-        int CheminPortailGauche = abs(lesX[0] - TROU_GAUCHE.x) + abs(lesY[0] - TROU_GAUCHE.y) + abs(lesPommesX[NbPommesSerpentManger] - TROU_DROITE.x) + abs(lesPommesY[NbPommesSerpentManger] - TROU_DROITE.y);
-        int CheminPortailDroite = abs(lesX[0] - TROU_DROITE.x) + abs(lesY[0] - TROU_DROITE.y) + abs(lesPommesX[NbPommesSerpentManger] - TROU_GAUCHE.x) + abs(lesPommesY[NbPommesSerpentManger] - TROU_GAUCHE.y);
-
-        // Tableau contenant les distances calculées pour chaque chemin
-        tChemins Tableau = {CheminDirectPomme, CheminPortailHaut, CheminPortailBas, CheminPortailGauche, CheminPortailDroite};
-        
-        // Affichage pour moi, pour comprendre comment les distances fonctionnent.
-        gotoxy(2+LARGEUR_PLATEAU, 1);
-        printf("Distance Pomme : %4d pas", CheminDirectPomme);
-        gotoxy(2+LARGEUR_PLATEAU, 2);
-        printf("Distance Portail Haut + Pomme : %4d pas", CheminPortailHaut);
-        gotoxy(2+LARGEUR_PLATEAU, 3);
-        printf("Distance Portail Bas + Pomme : %4d pas", CheminPortailBas);
-        gotoxy(2+LARGEUR_PLATEAU, 4);
-        printf("Distance Portail Gauche + Pomme : %4d pas", CheminPortailGauche);
-        gotoxy(2+LARGEUR_PLATEAU, 5);
-        printf("Distance Portail Droit + Pomme : %4d pas", CheminPortailDroite);
-
-        int minimunDes5distances = minimunTableau(Tableau); // Calcule la minimun des distances pour atteindre la pomme.
-
-        switch (minimunDes5distances)
-        {
-            case 0:
-                // Cas 0 : Chemin direct vers la pomme
-                // Si la pomme est plus proche sans utiliser de portail, on va vers la pomme.
-                if ((lesPommesY[NbPommesSerpentManger] - lesY[0]) < 0) 
-                {
-                    direction = HAUT; // La pomme est située au-dessus de la tête du serpent.
-                } 
-                else if ((lesPommesY[NbPommesSerpentManger] - lesY[0]) > 0) 
-                {
-                    direction = BAS; // La pomme est située en-dessous de la tête du serpent.
-                } 
-                else if ((lesPommesX[NbPommesSerpentManger] - lesX[0]) < 0) 
-                {
-                    direction = GAUCHE; // La pomme est à gauche de la tête du serpent.
-                } 
-                else 
-                {
-                    direction = DROITE; // La pomme est à droite de la tête du serpent.
-                }
-                break;
-
-            case 1:
-                // Cas 1 : Chemin via le portail haut
-                if (PasserPortails(lesX, lesY) == false)
-                {
-                    // Si le serpent n'est pas encore au portail haut, il se dirige vers le portail.
-                    if ((TROU_HAUT.y - lesY[0]) < 0) 
-                    {
-                        direction = HAUT; // Le portail haut est au-dessus de la tête du serpent.
-                    } 
-                    else if ((TROU_HAUT.y - lesY[0]) > 0)
-                    {
-                        direction = BAS; // Le portail haut est en-dessous de la tête.
-                    }
-                    else if ((TROU_HAUT.x - lesX[0]) < 0) 
-                    {
-                        direction = GAUCHE; // Le portail haut est à gauche de la tête.
-                    } else 
-                    {
-                        direction = DROITE; // Le portail haut est à droite de la tête.
-                    }
-                } else {
-                    // Une fois passé par le portail, on calcule la direction directe vers la pomme.
-                    if ((lesPommesY[NbPommesSerpentManger] - lesY[0]) < 0) 
-                    {
-                        direction = HAUT; // La pomme est au-dessus après téléportation.
-                    } 
-                    else if ((lesPommesY[NbPommesSerpentManger] - lesY[0]) > 0) 
-                    {
-                        direction = BAS; // La pomme est en-dessous après téléportation.
-                    } 
-                    else if ((lesPommesX[NbPommesSerpentManger] - lesX[0]) < 0) 
-                    {
-                        direction = GAUCHE; // La pomme est à gauche après téléportation.
-                    } 
-                    else 
-                    {
-                        direction = DROITE; // La pomme est à droite après téléportation.
-                    }
-                }
-                break;
-
-            case 2:
-                // Cas 2 : Chemin via le portail bas
-                if (PasserPortails(lesX, lesY) == false) 
-                {
-                    // Si le serpent n'est pas encore au portail bas, il se dirige vers le portail.
-                    if ((TROU_BAS.y - lesY[0]) < 0) 
-                    {
-                        direction = HAUT; // Le portail bas est au-dessus de la tête du serpent.
-                    } 
-                    else if ((TROU_BAS.y - lesY[0]) > 0) 
-                    {
-                        direction = BAS; // Le portail bas est en-dessous de la tête.
-                    } 
-                    else if ((TROU_BAS.x - lesX[0]) < 0) 
-                    {
-                        direction = GAUCHE; // Le portail bas est à gauche de la tête.
-                    } 
-                    else 
-                    {
-                        direction = DROITE; // Le portail bas est à droite de la tête.
-                    }
-                } else {
-                    // Une fois passé par le portail, on calcule la direction directe vers la pomme.
-                    if ((lesPommesY[NbPommesSerpentManger] - lesY[0]) < 0)
-                    {
-                        direction = HAUT; // La pomme est au-dessus après téléportation.
-                    } 
-                    else if ((lesPommesY[NbPommesSerpentManger] - lesY[0]) > 0) 
-                    {
-                        direction = BAS; // La pomme est en-dessous après téléportation.
-                    } 
-                    else if ((lesPommesX[NbPommesSerpentManger] - lesX[0]) < 0) 
-                    {
-                        direction = GAUCHE; // La pomme est à gauche après téléportation.
-                    } 
-                    else 
-                    {
-                        direction = DROITE; // La pomme est à droite après téléportation.
-                    }
-                }
-                break;
-
-            case 3:
-                // Cas 3 : Chemin via le portail gauche
-                if (PasserPortails(lesX, lesY) == false) 
-                {
-                    // Si le serpent n'est pas encore au portail gauche, il se dirige vers le portail.
-                    if ((TROU_GAUCHE.y - lesY[0]) < 0) 
-                    {
-                        direction = HAUT; // Le portail gauche est au-dessus de la tête du serpent.
-                    } 
-                    else if ((TROU_GAUCHE.y - lesY[0]) > 0) 
-                    {
-                        direction = BAS; // Le portail gauche est en-dessous de la tête.
-                    } 
-                    else if ((TROU_GAUCHE.x - lesX[0]) < 0) 
-                    {
-                        direction = GAUCHE; // Le portail gauche est à gauche de la tête.
-                    } 
-                    else 
-                    {
-                        direction = DROITE; // Le portail gauche est à droite de la tête.
-                    }
-                } 
-                else 
-                {
-                    // Une fois passé par le portail, on calcule la direction directe vers la pomme.
-                    if ((lesPommesY[NbPommesSerpentManger] - lesY[0]) < 0) 
-                    {
-                        direction = HAUT; // La pomme est au-dessus après téléportation.
-                    } 
-                    else if ((lesPommesY[NbPommesSerpentManger] - lesY[0]) > 0) 
-                    {
-                        direction = BAS; // La pomme est en-dessous après téléportation.
-                    } 
-                    else if ((lesPommesX[NbPommesSerpentManger] - lesX[0]) < 0) 
-                    {
-                        direction = GAUCHE; // La pomme est à gauche après téléportation.
-                    } 
-                    else 
-                    {
-                        direction = DROITE; // La pomme est à droite après téléportation.
-                    }
-                }
-                break;
-
-            case 4:
-                // Cas 4 : Chemin via le portail droit
-                if (PasserPortails(lesX, lesY) == false)
-                {
-                    // Si le serpent n'est pas encore au portail droit, il se dirige vers le portail.
-                    if ((TROU_DROITE.y - lesY[0]) < 0) 
-                    {
-                        direction = HAUT; // Le portail droit est au-dessus de la tête du serpent.
-                    } 
-                    else if ((TROU_DROITE.y - lesY[0]) > 0) 
-                    {
-                        direction = BAS; // Le portail droit est en-dessous de la tête.
-                    } 
-                    else if ((TROU_DROITE.x - lesX[0]) < 0) 
-                    {
-                        direction = GAUCHE; // Le portail droit est à gauche de la tête.
-                    } 
-                    else
-                    {
-                        direction = DROITE; // Le portail droit est à droite de la tête.
-                    }
-                } 
-                else 
-                {
-                    // Une fois passé par le portail, on calcule la direction directe vers la pomme.
-                    if ((lesPommesY[NbPommesSerpentManger] - lesY[0]) < 0) 
-                    {
-                        direction = HAUT; // La pomme est au-dessus après téléportation.
-                    } 
-                    else if ((lesPommesY[NbPommesSerpentManger] - lesY[0]) > 0) 
-                    {
-                        direction = BAS; // La pomme est en-dessous après téléportation.
-                    } 
-                    else if ((lesPommesX[NbPommesSerpentManger] - lesX[0]) < 0) 
-                    {
-                        direction = GAUCHE; // La pomme est à gauche après téléportation.
-                    } 
-                    else 
-                    {
-                        direction = DROITE; // La pomme est à droite après téléportation.
-                    }
-                }
-                break;
-        }
+        // Plus court chemin vers la pomme, en passant par les trous si c'est plus court et en contournant pavés et corps.
+        direction = directionPlusCourtChemin(lesX, lesY, lesPommesX[NbPommesSerpentManger], lesPommesY[NbPommesSerpentManger], direction, lePlateau);
         
 		progresser(lesX, lesY, direction, lePlateau, &collision, &pommeMangee); // Le serpent progresse dans la direction déterminée.
         PasserPortails(lesX, lesY); //Vérifie si le serpent est passé par un portail.
@@ -382,12 +169,14 @@ int main() {
 	gotoxy(LARGEUR_PLATEAU+1, 1); // Déplace le curseur en dehors du plateau de jeu.
 	if (gagne)
 	{
-		clock_t fin = clock(); // Enregistre l'heure de fin pour calculer le temps d'exécution.
+		struct timespec finMur, finCpu; // Enregistre l'heure de fin pour calculer le temps d'exécution.
+		clock_gettime(CLOCK_MONOTONIC, &finMur);
+		clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &finCpu);
 		enable_echo();
 		gotoxy(2, HAUTEUR_PLATEAU+1);
 		printf("Compteur de pas : %d\n", nbDepUnitaires);// Affiche les performances du programme.
         gotoxy(2,HAUTEUR_PLATEAU+2);
-		printf("Temps écoulé : %f en seconde\n", difftime(fin, debut) / PARSECONDE );// Affiche les performances du programme.
+		printf("Temps écoulé : %f en seconde (CPU : %f en seconde)\n", tempsEcoule(debutMur, finMur), tempsEcoule(debutCpu, finCpu));// Affiche les performances du programme.
 	}
 	return EXIT_SUCCESS;
 }
@@ -607,19 +396,55 @@ bool PasserPortails(int lesX[], int lesY[]){ //Vérifie si le serpent est passé
 }
 
 
-int minimunTableau(tChemins Tableau){
-    int minDistance = Tableau[0];
-    int minDistanceI = 0;
-    
-    for (int i = 0; i < 5; i++)
+char directionPlusCourtChemin(int lesX[], int lesY[], int cibleX, int cibleY, char directionActuelle, tPlateau plateau) {
+    // Parcours en largeur depuis la tête. Deux cases voisines sont reliées, et la sortie par un trou relie la case
+    // au bord opposé (même calcul que directionEstSure). Bordures, pavés et corps du serpent sont bloquants.
+    // Chaque case retient le premier pas qui y mène : dès que la pomme est atteinte, ce premier pas est la direction à prendre.
+    static int file[NB_CASES]; // File des cases à visiter (indice x * (HAUTEUR_PLATEAU+1) + y).
+    static char premierPas[NB_CASES]; // Direction prise depuis la tête pour atteindre chaque case.
+    static unsigned int marque[NB_CASES]; // Case vue (ou occupée par le corps) si marque == generation.
+    static unsigned int generation = 0;
+    const char lesDirections[4] = {HAUT, BAS, GAUCHE, DROITE};
+    const int lesDx[4] = {0, 0, -1, 1};
+    const int lesDy[4] = {-1, 1, 0, 0};
+    int debut = 0;
+    int fin = 0;
+
+    generation++;
+    for (int i = 0; i < TAILLE; i++) // Le corps (tête comprise) est bloquant
     {
-        if (minDistance > Tableau[i]) // Si une distance plus courte est trouvée
+        marque[lesX[i] * (HAUTEUR_PLATEAU+1) + lesY[i]] = generation;
+    }
+    int caseTete = lesX[0] * (HAUTEUR_PLATEAU+1) + lesY[0];
+    int caseCible = cibleX * (HAUTEUR_PLATEAU+1) + cibleY;
+    file[fin++] = caseTete;
+
+    while (debut < fin)
+    {
+        int c = file[debut++];
+        int x = c / (HAUTEUR_PLATEAU+1);
+        int y = c % (HAUTEUR_PLATEAU+1);
+
+        for (int d = 0; d < 4; d++)
         {
-            minDistance = Tableau[i]; // Met à jour la distance minimale
-            minDistanceI = i;     // Met à jour l'index du chemin le plus court
+            int vx = (x + lesDx[d] + LARGEUR_PLATEAU - 1) % LARGEUR_PLATEAU + 1; // Sortie par un trou : bord opposé
+            int vy = (y + lesDy[d] + HAUTEUR_PLATEAU - 1) % HAUTEUR_PLATEAU + 1;
+            int v = vx * (HAUTEUR_PLATEAU+1) + vy;
+
+            if ((marque[v] == generation) || (plateau[vx][vy] == BORDURE) || estSurPave(vx, vy, plateau))
+            {
+                continue; // Case déjà vue ou bloquée
+            }
+            marque[v] = generation;
+            premierPas[v] = (c == caseTete) ? lesDirections[d] : premierPas[c];
+            if (v == caseCible)
+            {
+                return premierPas[v]; // Plus court chemin trouvé
+            }
+            file[fin++] = v;
         }
     }
-    return minDistanceI;
+    return trouverDirectionSure(lesX, lesY, directionActuelle, plateau); // Pomme inaccessible : on se contente d'une direction sûre
 }
 
 
@@ -670,41 +495,37 @@ bool directionEstSure(int x, int y, char direction, int lesX[], int lesY[], tPla
 /************************************************/
 /*				 FONCTIONS UTILITAIRES 			*/
 /************************************************/
+double tempsEcoule(struct timespec debut, struct timespec fin)
+{
+    return (fin.tv_sec - debut.tv_sec) + (fin.tv_nsec - debut.tv_nsec) / NANO_PAR_SECONDE;
+}
+
 void gotoxy(int x, int y)
 { 
     printf("\033[%d;%df", y, x);
 }
 
+// Attributs du terminal au lancement, rétablis à la fin du programme.
+struct termios terminalInitial;
+bool terminalModifie = false;
+
 int kbhit()
 {
 	// la fonction retourne :
 	// 1 si un caractere est present
 	// 0 si pas de caractere présent
-	int unCaractere = 0;
-	struct termios oldt, newt;
-	int ch;
-	int oldf;
-
-	// mettre le terminal en mode non bloquant
-	tcgetattr(STDIN_FILENO, &oldt);
-	newt = oldt;
-	newt.c_lflag &= ~(ICANON | ECHO);
-	tcsetattr(STDIN_FILENO, TCSANOW, &newt);
-	oldf = fcntl(STDIN_FILENO, F_GETFL, 0);
-	fcntl(STDIN_FILENO, F_SETFL, oldf | O_NONBLOCK);
- 
-	ch = getchar();
-
-	// restaurer le mode du terminal
-	tcsetattr(STDIN_FILENO, TCSANOW, &oldt);
-	fcntl(STDIN_FILENO, F_SETFL, oldf);
- 
-	if(ch != EOF)
-	{
-		ungetc(ch, stdin);
-		unCaractere = 1;
-	} 
-	return unCaractere;
+	// Le terminal reste en mode non canonique pendant toute la partie (disable_echo) :
+	// un seul poll() sans attente suffit, sans changer les réglages à chaque tour.
+	struct pollfd entree = {STDIN_FILENO, POLLIN, 0};
+
+	return (poll(&entree, 1, 0) > 0) && (entree.revents & POLLIN);
+}
+
+// Rétablit le terminal quand le programme est interrompu (Ctrl+C) pendant la partie.
+void interrompre(int numeroSignal)
+{
+    enable_echo();
+    _exit(128 + numeroSignal);
 }
 
 // Fonction pour désactiver l'echo
@@ -713,42 +534,43 @@ void disable_echo()
     struct termios tty;
 
     // Obtenir les attributs du terminal
-    if (tcgetattr(STDIN_FILENO, &tty) == -1) 
+    if (tcgetattr(STDIN_FILENO, &terminalInitial) == -1) 
 	{
         perror("tcgetattr");
         exit(EXIT_FAILURE);
     }
 
-    // Désactiver le flag ECHO
-    tty.c_lflag &= ~ECHO;
+    // Désactiver l'écho et le mode ligne ; une lecture rend la main tout de suite
+    tty = terminalInitial;
+    tty.c_lflag &= ~(ICANON | ECHO);
+    tty.c_cc[VMIN] = 0;
+    tty.c_cc[VTIME] = 0;
 
-    // Appliquer les nouvelles configurations
+    // Appliquer les nouvelles configurations, une seule fois pour toute la partie
     if (tcsetattr(STDIN_FILENO, TCSANOW, &tty) == -1)
 	{
         perror("tcsetattr");
         exit(EXIT_FAILURE);
     }
+    terminalModifie = true;
+    setvbuf(stdin, NULL, _IONBF, 0); // getchar() lit un seul octet : poll() voit encore les touches suivantes.
+    atexit(enable_echo);
+    signal(SIGINT, interrompre);
+    signal(SIGTERM, interrompre);
 }
 
 // Fonction pour réactiver l'echo
 void enable_echo()
 {
-    struct termios tty;
-
-    // Obtenir les attributs du terminal
-    if (tcgetattr(STDIN_FILENO, &tty) == -1)
-	{
-        perror("tcgetattr");
-        exit(EXIT_FAILURE);
+    if (!terminalModifie)
+    {
+        return; // Terminal déjà rétabli.
     }
 
-    // Réactiver le flag ECHO
-    tty.c_lflag |= ECHO;
-
-    // Appliquer les nouvelles configurations
-    if (tcsetattr(STDIN_FILENO, TCSANOW, &tty) == -1)
+    // Rétablir les attributs d'origine du terminal
+    if (tcsetattr(STDIN_FILENO, TCSANOW, &terminalInitial) == -1)
 	{
         perror("tcsetattr");
-        exit(EXIT_FAILURE);
     }
-}
\ No newline at end of file
+    terminalModifie = false;
+}
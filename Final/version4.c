@@ -26,22 +26,36 @@
 #include <unistd.h>
 #include <termios.h>
 #include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
 #include <time.h>
+#include <string.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <pthread.h>
 
 // Constantes du jeu
 #define TAILLE 10  // Taille du serpent.
-#define LARGEUR_PLATEAU 80  // Largeur du plateau de jeu.
-#define HAUTEUR_PLATEAU 40  // Hauteur du plateau de jeu.
-#define X_DEPART_SERPENT 40  // Position en X du serpent 1 au départ (au centre du plateau).
-#define Y_DEPART_SERPENT 13  // Position en Y du serpent 1 au départ (au centre du plateau).
-#define X_DEPART_SERPENT_2 40  // Position en X du serpent 2 au départ (au centre du plateau).
-#define Y_DEPART_SERPENT_2 27  // Position en Y du serpent 2 au départ (au centre du plateau).
+#define LARGEUR_PLATEAU 80  // Largeur du plateau de jeu par défaut (plateau de référence des positions).
+#define HAUTEUR_PLATEAU 40  // Hauteur du plateau de jeu par défaut.
+#define LARGEUR_MAX 16384  // Largeur maximale choisie avec --plateau.
+#define HAUTEUR_MAX 16384  // Hauteur maximale choisie avec --plateau.
+#define X_DEPART_SERPENT 40  // Position en X du serpent 1 au départ, sur le plateau de référence (au centre du plateau).
+#define Y_DEPART_SERPENT 13  // Position en Y du serpent 1 au départ, sur le plateau de référence (au centre du plateau).
+#define X_DEPART_SERPENT_2 40  // Position en X du serpent 2 au départ, sur le plateau de référence (au centre du plateau).
+#define Y_DEPART_SERPENT_2 27  // Position en Y du serpent 2 au départ, sur le plateau de référence (au centre du plateau).
 #define NB_POMMES 10  // Nombre de pommes présentes sur le plateau.
-#define ATTENTE 200000  // Temps d'attente entre chaque déplacement du serpent (en microsecondes).
+#define ATTENTE 200000  // Durée d'un tour par défaut, entre deux déplacements du serpent (en microsecondes).
 #define CORPS 'X'  // Caractère utilisé pour dessiner le corps du serpent.
 #define TETE '1'  // Caractère utilisé pour dessiner la tête du serpent.
 #define TETE2 '2'  // Caractère utilisé pour dessiner la tête du serpent.
+#define TETE_AUTRE '*'  // Tête des serpents au-delà des chiffres et des lettres.
 #define BORDURE '#'  // Caractère utilisé pour dessiner les bords du plateau.
+#define SORTIE_PORTAIL 'O'  // Case de garde devant un trou (jamais affichée) : y entrer fait ressortir par le trou opposé.
 #define STOP 'a'  // Touche pour arrêter le jeu.
 #define VIDE ' '  // Caractère pour un espace vide sur le plateau.
 #define POMME '6'  // Caractère pour une pomme.
@@ -52,975 +66,4828 @@
 #define PAVE '#' // Représente un pavé d'obstacle
 #define NB_PAVES 6 // Nombre de pavés d'obstacles
 #define TAILLE_PAVE 5 // Dimension (carrée) des pavés
+#define TAILLE_MAX 64 // Capacité du tampon circulaire d'un serpent (puissance de 2, longueur maximale).
+#define CROISSANCE 0 // Nombre d'anneaux gagnés par pomme mangée (0 : le serpent garde sa taille).
+#define MAX_TOURS 5000 // Nombre maximal de tours d'une partie simulée sur le plateau de référence (évite les parties sans fin).
+#define NB_PARTIES_DEFAUT 100000 // Nombre de parties simulées par défaut en mode sans affichage.
+#define OPTION_SANS_AFFICHAGE "--sans-affichage" // Option de la ligne de commande pour lancer la simulation sans affichage.
+#define OPTION_HEURISTIQUE "--heuristique" // Option pour revenir à l'ancienne estimation (distances de Manhattan + portails).
+#define OPTION_PLATEAU "--plateau" // Option pour choisir les dimensions du plateau : --plateau LARGEURxHAUTEUR.
+#define ALIGNEMENT_CASES 64 // Alignement (taille d'une ligne de cache) du tampon du plateau et de chacune de ses lignes.
+#define CASE(x, y) ((y) * pasLigne + (x)) // Indice de la case (x, y) dans un tampon de cases.
+#define X_CASE(c) ((c) % pasLigne) // Colonne de la case d'indice c.
+#define Y_CASE(c) ((c) / pasLigne) // Ligne de la case d'indice c.
+#define MAX_CASES_TABLE 8192 // Nombre maximal de cases libres pour la table des distances (n*n octets et plus) ; au-delà, champ des distances à la pomme.
+#define OPTION_SANS_TABLE "--sans-table" // Option pour recalculer chaque chemin par parcours en largeur, sans la table des distances.
+#define FICHIER_DISTANCES "version4_distances.cache" // Fichier qui conserve la table des distances d'un lancement à l'autre.
+#define SIGNATURE_DISTANCES "SNK4DIST" // Les 8 premiers octets du fichier de la table.
+#define DISTANCE_INCONNUE 255 // Distance enregistrée entre deux cases qui ne communiquent pas (ou trop éloignées).
+#define CHAMP_INCONNU UINT32_MAX // Distance à la pomme d'une case du champ d'où la pomme est inaccessible.
+#define NB_CASES_RECHERCHE_LOCALE 4096 // Cases visitées au plus pour contourner un corps qui barre le pas lu dans le champ.
+#define TAILLE_HACHAGE_LOCAL 8192 // Cases marquées par la recherche locale (puissance de 2, double du nombre de cases).
+#define TAILLE_SORTIE 65536 // Taille du tampon des séquences d'échappement d'une image.
+#define LONGUEUR_PANNEAU 64 // Longueur maximale d'une ligne de texte à droite du plateau.
+#define NB_LIGNES_PANNEAU 32 // Nombre de lignes de texte à droite du plateau.
+#define NANO_PAR_SECONDE 1000000000.0 // Nombre de nanosecondes par seconde.
+#define OPTION_PERIODE "--periode" // Option pour choisir la durée d'un tour en microsecondes (ATTENTE par défaut).
+#define OPTION_SANS_RATTRAPAGE "--sans-rattrapage" // Option pour abandonner les échéances manquées au lieu de les rattraper.
+#define MAX_RATTRAPAGE 5 // Retard maximal (en tours) rattrapé ; au-delà les échéances manquées sont abandonnées.
+#define OPTION_TOURNOI "--tournoi" // Option pour jouer des parties à graines différentes sur tous les cœurs.
+#define OPTION_PROCESSUS "--processus" // Option pour choisir le nombre de processus du tournoi (un par cœur par défaut).
+#define OPTION_GRAINE "--graine" // Option pour choisir la graine de la première partie (tournoi et simulation sans affichage).
+#define OPTION_DETAIL "--detail" // Option pour écrire le résultat de chaque graine dans un fichier CSV.
+#define TAILLE_LOT 64 // Nombre de parties prises d'un coup par un processus du tournoi.
+#define OPTION_SERPENTS "--serpents" // Option pour choisir le nombre de serpents de l'arène.
+#define NB_SERPENTS_DEFAUT 2 // Nombre de serpents par défaut (les deux serpents d'origine).
+#define NB_SERPENTS_MAX 65536 // Nombre maximal de serpents.
+#define OPTION_FILS "--fils" // Option pour répartir les décisions de chaque tour sur plusieurs fils d'exécution.
+#define NB_FILS_MAX 256 // Nombre maximal de fils de décision.
+#define LOT_DECISIONS 8 // Nombre de serpents pris d'un coup par un fil de décision.
+#define SEUIL_PARALLELE 32 // Nombre de serpents en jeu à partir duquel les décisions sont réparties sur les fils.
+#define OPTION_ENREGISTRER "--enregistrer" // Option pour écrire chaque partie jouée dans un journal binaire.
+#define OPTION_REJOUER "--rejouer" // Option pour rejouer toutes les parties d'un journal et vérifier leur état final.
+#define SIGNATURE_JOURNAL "SNK4JRNL" // Les 8 premiers octets d'un journal de parties.
+#define OPTION_INSTANTANES "--instantanes" // Option pour vérifier et chronométrer instantanés, restaurations et annulations.
+#define NB_PARTIES_INSTANTANES 1000 // Nombre de parties parcourues par défaut avec --instantanes.
+#define NB_BLOC_INSTANTANES 16 // Opérations d'un même bloc chronométré avec --instantanes (nombre pair).
+#define OPTION_MICRO "--micro" // Option pour chronométrer une à une les fonctions appelées à chaque tour.
+#define NB_ECHANTILLONS_MICRO 30 // Nombre d'échantillons par fonction par défaut avec --micro.
+#define NB_ETATS_MICRO 64 // États de partie relevés pour les mesures, répartis entre les longueurs de serpent.
+#define NB_LONGUEURS_MICRO 4 // Classes de longueur des serpents mesurés (de TAILLE à presque TAILLE_MAX).
+#define PAS_RELEVE_MICRO 5 // Un état relevé tous les PAS_RELEVE_MICRO tours.
+#define NB_APPELS_MICRO 4096 // Appels chronométrés d'un bloc pour les fonctions courtes.
+#define NB_TOURS_MICRO 256 // Appels de progresser et de rafraichirEcran par échantillon.
+#define NB_COPIES_MICRO 8 // Copies de la partie avancées dans un même bloc chronométré de progresser.
+#define NB_MESURES_HORLOGE 100000 // Lectures de l'horloge pour estimer le coût d'une lecture.
+#define Z_95 1.96 // Quantile de la loi normale pour un intervalle de confiance à 95 %.
+#define OPTION_MCTS "--mcts" // Option pour diriger des serpents par recherche arborescente Monte-Carlo : --mcts 1,2.
+#define OPTION_MCTS_BUDGET "--mcts-budget" // Option pour choisir le temps de recherche d'une décision, en microsecondes.
+#define OPTION_MCTS_PLAYOUTS "--mcts-playouts" // Option pour fixer le nombre de simulations d'une décision au lieu du temps.
+#define OPTION_MCTS_ROLLOUT "--mcts-rollout" // Option pour choisir la stratégie des simulations : aleatoire, sure ou chemin.
+#define NB_SERPENTS_MCTS 64 // Seuls les 64 premiers serpents peuvent être dirigés par la recherche.
+#define BUDGET_MCTS 5000 // Temps de recherche par défaut d'une décision (en microsecondes).
+#define NB_NOEUDS_MCTS 32768 // Nombre maximal de nœuds de l'arbre de chaque fil.
+#define PROFONDEUR_MCTS 40 // Nombre maximal de tours descendus dans l'arbre, puis joués par une simulation.
+#define EXPLORATION_MCTS 0.7 // Constante d'exploration d'UCB1 (gains entre 0 et 1).
+#define MARGE_MCTS 0.02 // Avance de gain moyen nécessaire pour préférer un autre coup à celui de la stratégie ordinaire.
+#define ACTUALISATION_MCTS 0.97 // Une pomme mangée t tours après la racine compte ACTUALISATION_MCTS^t.
+#define OPTION_POMMES "--pommes" // Option pour choisir la source des pommes : fixes (calendrier de la partie) ou aleatoires.
+#define OPTION_ALPHABETA "--alphabeta" // Option pour diriger des serpents par recherche alpha-bêta : --alphabeta 1,2.
+#define OPTION_ALPHABETA_BUDGET "--alphabeta-budget" // Option pour choisir le temps de recherche alpha-bêta d'une décision, en microsecondes.
+#define OPTION_ALPHABETA_PROFONDEUR "--alphabeta-profondeur" // Option pour fixer la profondeur de recherche (en tours) au lieu du temps.
+#define OPTION_ALPHABETA_TABLE "--alphabeta-table" // Option pour choisir la taille de la table de transposition, en mégaoctets.
+#define BUDGET_ALPHABETA 5000 // Temps de recherche alpha-bêta par défaut d'une décision (en microsecondes).
+#define PROFONDEUR_MAX_ALPHABETA 64 // Profondeur maximale de l'approfondissement itératif (en tours).
+#define TABLE_ALPHABETA 16 // Taille par défaut de la table de transposition (en mégaoctets).
+#define TABLE_MAX_ALPHABETA 65536 // Taille maximale de la table de transposition (en mégaoctets).
+#define VICTOIRE_ALPHABETA 1000000 // Valeur d'une partie gagnée, plus la profondeur restante.
+#define INFINI_ALPHABETA 0x3FFFFFFF // Bornes de la fenêtre alpha-bêta de la racine.
+#define POMME_ALPHABETA 1000 // Valeur d'une pomme d'avance à l'horizon.
+#define DISTANCE_ALPHABETA 10 // Valeur d'une case d'avance vers la pomme en jeu.
+#define PIEGE_ALPHABETA 50000 // Pénalité d'un serpent enfermé dans moins de cases libres que sa longueur.
+#define EMPREINTE_INITIALE 14695981039346656037ULL // Point de départ des empreintes FNV-1a 64 bits.
 
-// Positions des pommes et des pavés
+// Mesure du temps passé dans chaque phase d'un tour : compiler avec -DMESURE_PHASES pour l'activer.
+// Sans cette option, DEBUT_PHASE et FIN_PHASE ne génèrent aucun code.
+#ifdef MESURE_PHASES
+#define DEBUT_PHASE(phase) debutPhase(phase)
+#define FIN_PHASE(phase) finPhase(phase)
+#define NB_CLASSES_DUREE 1024 // Classes de l'histogramme des durées : 16 par puissance de 2 (précision d'environ 6 %).
+#else
+#define DEBUT_PHASE(phase) ((void)0)
+#define FIN_PHASE(phase) ((void)0)
+#endif
+
+// Positions de départ des pommes et des pavés, données sur le plateau de référence puis mises à l'échelle
+// par initDimensions(). Chaque partie en garde sa propre copie (tPartie).
 int lesPommesX[NB_POMMES] = {40, 75, 78, 2, 9, 78, 74, 2, 72, 5}; // Positions en X des pommes.
 int lesPommesY[NB_POMMES] = {20, 38, 2, 2, 5, 38, 32, 38, 32, 2}; // Positions en Y des pommes.
 int lesPavesX[NB_PAVES] = { 4, 73, 4, 73, 38, 38}; // Positions en X des pavés.
 int lesPavesY[NB_PAVES] = { 4, 4, 33, 33, 14, 22}; // Positions en Y des pavés.
 
-typedef char tPlateau[LARGEUR_PLATEAU+1][HAUTEUR_PLATEAU+1]; // Initialiser le plateau de jeu.
+// Dimensions du plateau, choisies au lancement. Toutes les grilles (plateau, occupation, écran) sont rangées
+// ligne par ligne dans un seul tampon aligné, entouré d'une rangée de cases de garde : la case (x, y) est
+// à l'indice CASE(x, y), avec x de 0 à largeurPlateau + 1 et y de 0 à hauteurPlateau + 1. Les cases de garde
+// bloquent, sauf devant les trous : une case voisine se trouve donc sans aucun test de bord.
+int largeurPlateau = LARGEUR_PLATEAU;
+int hauteurPlateau = HAUTEUR_PLATEAU;
+int pasLigne; // Nombre de cases d'une ligne du tampon (garde comprise, arrondi à l'alignement).
+int nbCasesMemoire; // Nombre de cases du tampon.
+int limiteTours = MAX_TOURS; // Nombre maximal de tours d'une partie simulée, proportionnel à la taille du plateau.
+int lesDecalages[4]; // Écart d'indice vers la case voisine : HAUT, BAS, GAUCHE, DROITE.
+int lesSortiesPortail[4]; // Case de garde devant chaque trou.
+int lesArriveesPortail[4]; // Trou opposé, où ressort un serpent entré dans cette case de garde.
+
+typedef char *tPlateau; // Cases du plateau : plateau[CASE(x, y)].
+
+typedef unsigned char *tOccupation; // Nombre d'anneaux de serpent sur chaque case du plateau.
 
 typedef int tChemins[5]; // Initialiser le tableau avec les 5 chemins possibles.
 
-int NbPommesSerpentManger = 0; // Compteur du nombre de déplacements effectués par le serpent.
-int NbPommesSerpentManger2 = 0; 
-int nbDepUnitaires = 0; // Compteur du nombre de pommes mangées par le serpent.
-int nbDepUnitaires2 = 0;
+bool affichageActif = false; // Vrai pour la partie affichée ; faux en mode simulation : aucune écriture dans le terminal.
+bool heuristiqueManhattan = false; // Vrai pour diriger les serpents avec l'ancienne estimation au lieu du plus court chemin.
+
+// Source des pommes : les positions fixes de la partie (dans l'ordre tiré de la graine), ou une case libre tirée au
+// hasard par le générateur de la partie au moment où la pomme apparaît.
+typedef enum {
+    POMMES_FIXES, // Calendrier lesPommesX / lesPommesY, mélangé selon la graine.
+    POMMES_ALEATOIRES // Case libre au hasard, parmi les cases libres tenues à jour (tirage en temps constant).
+} tSourcePommes;
+
+tSourcePommes sourcePommes = POMMES_FIXES;
+_Thread_local bool enRecherche = false; // Vrai pendant les simulations d'une recherche : elles ne dessinent rien.
+_Thread_local int rangFil = 0; // Rang du fil dans l'équipe de décision (0 : fil principal).
 
 typedef struct {
     int x; // Coordonnée X du Portail.
     int y; // Coordonnée X du Portail.
 } Portail;
 
-const Portail TROU_HAUT = {40, 0};  // Portail en haut du plateau (Portail de coordonnées (40, 0)).
-const Portail TROU_BAS = {40, 40};  // Portail en bas du plateau (Portail de coordonnées (40, 40)).
-const Portail TROU_GAUCHE = {0, 20};  // Portail à gauche du plateau (Portail de coordonnées (0, 20)).
-const Portail TROU_DROITE = {80, 20};  // Portail à droite du plateau (Portail de coordonnées (80, 20)).
+int nbSerpents = NB_SERPENTS_DEFAUT; // Nombre de serpents de chaque partie, choisi au lancement.
+
+// État complet d'une partie, en un seul bloc aligné sans pointeur : plusieurs parties peuvent se jouer
+// côte à côte sans verrou, et une partie se copie d'un seul memcpy de taillePartie() octets.
+// Les dimensions, la table des distances et l'écran restent communs (lus seulement pendant le jeu).
+// Après l'en-tête viennent, à la place donnée par disposition, le plateau, l'occupation, puis les
+// serpents rangés tableau par tableau (un tableau par caractéristique, une case par serpent).
+typedef struct {
+    unsigned long graine; // Graine de la configuration de départ (0 : ordre des pommes d'origine).
+    int lesPommesX[NB_POMMES]; // Positions des pommes de cette partie, dans leur ordre d'apparition.
+    int lesPommesY[NB_POMMES];
+    int lesPavesX[NB_PAVES]; // Positions des pavés de cette partie.
+    int lesPavesY[NB_PAVES];
+    int nbPommesMangees; // Pommes mangées par l'ensemble des serpents (indice de la pomme en jeu).
+    int nbVivants; // Serpents encore en jeu.
+    int nbTours; // Nombre de tours joués.
+    bool collision; // Vrai si un serpent a heurté un mur, un pavé ou un anneau.
+    bool gagne; // Vrai si toutes les pommes ont été mangées.
+    uint64_t zobrist; // Hachage de Zobrist de la position (corps, têtes, pommes), tenu à jour à chaque déplacement.
+    uint64_t alea; // État du générateur des pommes aléatoires (splitmix64), tiré de la graine.
+    int nbCasesLibres; // Cases jouables sans anneau, rangées dans casesLibres (pommes aléatoires seulement).
+    _Alignas(ALIGNEMENT_CASES) unsigned char cases[]; // Plateau, occupation et serpents.
+} tPartie;
+
+// Place de chaque tableau dans partie->cases (en octets), fixée une fois pour toutes par initDisposition().
+// Les tableaux des serpents se suivent, d'anneaux jusqu'à la fin : un instantané les copie d'un seul bloc.
+// Le corps d'un serpent est un tampon circulaire d'indices de cases : avancer écrit seulement la nouvelle
+// tête, la queue est abandonnée en déplaçant l'indice de tête, sans décaler les autres anneaux.
+typedef struct {
+    size_t plateau; // nbCasesMemoire caractères.
+    size_t occupation; // nbCasesMemoire compteurs d'anneaux.
+    size_t teteSur; // nbCasesMemoire entiers : numéro + 1 du serpent dont la tête est sur la case, 0 sinon.
+    size_t casesLibres; // Pommes aléatoires : les nbCasesLibres cases jouables sans anneau, dans un ordre quelconque.
+    size_t rangLibre; // Pommes aléatoires : place de chaque case dans casesLibres, -1 si elle n'y est pas.
+    size_t anneaux; // TAILLE_MAX cases par serpent : anneaux[s * TAILLE_MAX + k].
+    size_t tetes; // Indice de la tête dans le tampon de chaque serpent.
+    size_t longueurs; // Nombre d'anneaux (tête comprise).
+    size_t aGrandir; // Nombre d'anneaux à ajouter lors des prochains déplacements.
+    size_t pommes; // Pommes mangées par chaque serpent.
+    size_t pas; // Déplacements de chaque serpent.
+    size_t directions; // Direction prise au dernier tour (HAUT, BAS, GAUCHE ou DROITE).
+    size_t decisions; // Direction choisie pour le tour en cours, appliquée seulement après toutes les décisions.
+    size_t vivants; // Vrai tant que le serpent n'a rien heurté.
+    size_t taille; // Taille totale de ces tableaux.
+} tDisposition;
+
+tDisposition disposition;
+
+#define PLATEAU(partie) ((tPlateau)((partie)->cases + disposition.plateau)) // Plateau d'une partie.
+#define OCCUPATION(partie) ((unsigned char *)((partie)->cases + disposition.occupation)) // Occupation des cases d'une partie.
+#define TETE_SUR(partie) ((int *)((partie)->cases + disposition.teteSur)) // Tête présente sur chaque case.
+#define CASES_LIBRES(partie) ((int *)((partie)->cases + disposition.casesLibres))
+#define RANG_LIBRE(partie) ((int *)((partie)->cases + disposition.rangLibre))
+#define ANNEAUX(partie) ((int *)((partie)->cases + disposition.anneaux))
+#define TETES(partie) ((int *)((partie)->cases + disposition.tetes))
+#define LONGUEURS(partie) ((int *)((partie)->cases + disposition.longueurs))
+#define A_GRANDIR(partie) ((int *)((partie)->cases + disposition.aGrandir))
+#define POMMES_SERPENTS(partie) ((int *)((partie)->cases + disposition.pommes))
+#define PAS_SERPENTS(partie) ((int *)((partie)->cases + disposition.pas))
+#define DIRECTIONS(partie) ((char *)((partie)->cases + disposition.directions))
+#define DECISIONS(partie) ((char *)((partie)->cases + disposition.decisions))
+#define VIVANTS(partie) ((bool *)((partie)->cases + disposition.vivants))
+
+// Instantané d'une partie pour les recherches : compteurs et tableaux des serpents seulement. Le plateau fixe
+// ne change pas et la pomme en jeu se déduit de nbPommesMangees ; occupation et têtes se déduisent des corps.
+// Prendre un instantané est un seul memcpy ; il se restaure dans la partie d'où il vient (ou une copie de celle-ci).
+typedef struct {
+    int nbPommesMangees;
+    int nbVivants;
+    int nbTours;
+    bool collision;
+    bool gagne;
+    uint64_t zobrist;
+    uint64_t alea;
+    _Alignas(ALIGNEMENT_CASES) unsigned char serpents[]; // Copie de partie->cases, de disposition.anneaux à la fin.
+} tInstantane;
+
+// Annulation incrémentale, plus rapide que l'instantané quand on explore tour par tour : avant chaque tour,
+// marquerTour() note seulement ce que le tour va changer (compteurs, puis pour chaque serpent en jeu ses valeurs
+// et la case du tampon que sa nouvelle tête va écraser) ; annulerTour() défait le dernier tour marqué.
+typedef struct {
+    int s; // Numéro du serpent.
+    int tete; // Valeurs d'avant le tour.
+    int longueur;
+    int aGrandir;
+    int pommes;
+    int pas;
+    int caseEcrasee; // Ancienne valeur de la case du tampon qui reçoit la nouvelle tête.
+    char direction;
+    bool queueLiberee; // Vrai si la queue quitte sa case pendant le tour (serpent qui ne grandit pas).
+} tAnnulationSerpent;
+
+typedef struct {
+    int nbPommesMangees; // Compteurs d'avant le tour.
+    int nbVivants;
+    int nbTours;
+    bool collision;
+    bool gagne;
+    uint64_t zobrist;
+    uint64_t alea;
+    int premierSerpent; // Première entrée du tour dans lesSerpents.
+} tAnnulationTour;
+
+typedef struct {
+    tAnnulationTour *lesTours; // Un élément par tour marqué, du plus ancien au plus récent.
+    int nbTours;
+    int capaciteTours;
+    tAnnulationSerpent *lesSerpents; // Les serpents en jeu de chaque tour, à la suite.
+    int nbSerpents;
+    int capaciteSerpents;
+} tPileAnnulation;
+
+// En-tête du fichier de la table des distances. La table n'est réutilisée que si le plateau fixe
+// (dimensions, bordures, trous et pavés) a la même empreinte que celui qui l'a produite.
+typedef struct {
+    char signature[8]; // SIGNATURE_DISTANCES
+    uint32_t largeur; // largeurPlateau
+    uint32_t hauteur; // hauteurPlateau
+    uint32_t nbCasesLibres; // Nombre de cases ni bordure ni pavé.
+    uint32_t reserve; // Toujours 0 (alignement de l'empreinte).
+    uint64_t empreinte; // Empreinte FNV-1a du plateau fixe.
+} tEnteteDistances;
+
+// Distances et premiers pas entre toutes les paires de cases libres du plateau fixe.
+// Pour n cases libres : n*n distances sur un octet puis n*n premiers pas sur 2 bits, rangés ligne par ligne (départ, arrivée).
+typedef struct {
+    int *numero; // Numéro de chaque case libre dans la table (indice CASE(x, y)), -1 pour une bordure ou un pavé.
+    int nbCasesLibres; // Nombre de cases libres.
+    const unsigned char *distances; // distances[depart * n + arrivee]
+    const unsigned char *premiersPas; // 2 bits par paire : 0 HAUT, 1 BAS, 2 GAUCHE, 3 DROITE.
+    void *memoire; // Zone projetée depuis le fichier (ou allouée) contenant en-tête, distances et premiers pas.
+    size_t tailleMemoire; // Taille de cette zone.
+    bool projetee; // Vrai si la zone vient de mmap, faux si elle a été allouée.
+} tTableDistances;
+
+bool tableActive = false; // Vrai si la table des distances du plateau fixe est chargée.
+tTableDistances tableDistances; // Table des distances du plateau fixe, chargée une seule fois au lancement.
+
+// Distances de toutes les cases à une même pomme sur le plateau fixe, pour les plateaux trop grands pour la table.
+typedef struct {
+    uint32_t *distances; // Distance de chaque case à la pomme (indice CASE(x, y)), CHAMP_INCONNU si aucun chemin.
+    int *file; // File du parcours en largeur qui construit le champ.
+    int cible; // Case de la pomme du champ, -1 avant le premier parcours.
+} tChampDistances;
+
+bool champActif = false; // Vrai si le plateau est trop grand pour la table : les pas se lisent dans un champ des distances à la pomme.
+tChampDistances champPartage = {NULL, NULL, -1}; // Champ de la pomme en jeu, refait par le fil principal avant les décisions.
+
+// Écran en double tampon : le jeu modifie l'image voulue et note les cases changées ; une fois par image,
+// seules les cases qui diffèrent de l'image déjà affichée sont envoyées au terminal, en un seul write().
+typedef struct {
+    char *voulu; // Image que le jeu veut afficher (indice CASE(x, y)).
+    char *affiche; // Image actuellement dans le terminal.
+    bool *estSale; // Vrai si la case est déjà dans la liste des cases modifiées.
+    int *lesSales; // Indices des cases modifiées depuis la dernière image.
+    int nbSales; // Nombre de cases modifiées.
+    char panneau[NB_LIGNES_PANNEAU][LONGUEUR_PANNEAU]; // Textes déjà affichés à droite du plateau, ligne par ligne.
+    char sortie[TAILLE_SORTIE]; // Séquences d'échappement de l'image en cours.
+    int tailleSortie; // Nombre d'octets dans sortie.
+} tEcran;
+
+tEcran ecran; // Écran du mode interactif.
+int sortieEcran = STDOUT_FILENO; // Descripteur où rafraichirEcran() envoie l'image (/dev/null pour --micro).
+
+// Cadence des tours : chaque tour a une échéance absolue sur l'horloge monotone (début + n * periode),
+// si bien que le temps de calcul et d'affichage ne décale pas les tours suivants.
+typedef struct {
+    struct timespec echeance; // Échéance du prochain tour.
+    long periode; // Durée d'un tour en nanosecondes.
+    bool rattrapage; // Vrai : un tour en retard est joué tout de suite, sans affichage, jusqu'à rattraper l'horloge.
+    bool enRetard; // Vrai si le tour en cours a commencé après son échéance.
+    long nbTours; // Nombre d'échéances attendues.
+    long nbManquees; // Échéances déjà dépassées à la fin du tour précédent.
+    long nbImagesSautees; // Tours joués sans affichage pour rattraper le retard.
+    long nbAbandonnees; // Échéances abandonnées (retard trop grand ou rattrapage désactivé).
+    long nbReveils; // Nombre d'attentes effectuées.
+    double gigueTotale; // Somme des retards au réveil (en nanosecondes).
+    double gigueMax; // Plus grand retard au réveil (en nanosecondes).
+} tOrdonnanceur;
+
+tOrdonnanceur ordonnanceur = {.periode = ATTENTE * 1000L, .rattrapage = true}; // Cadence des tours du mode interactif.
+
+// Phases d'un tour mesurées séparément.
+typedef enum {
+    PHASE_DECISION, // Choix des directions (plus court chemin ou heuristique).
+    PHASE_PROGRESSION, // Déplacement des serpents, portails et pommes.
+    PHASE_AFFICHAGE, // Construction et écriture de l'image.
+    PHASE_ENTREE, // Lecture du clavier.
+    PHASE_ATTENTE, // Attente de l'échéance du tour suivant.
+    NB_PHASES
+} tPhase;
+
+#ifdef MESURE_PHASES
+// Cumul des durées d'une phase : temps réel (horloge monotone) et temps CPU du fil d'exécution.
+typedef struct {
+    struct timespec debutMur; // Début de la mesure en cours.
+    struct timespec debutCpu;
+    long nbMesures; // Nombre de passages dans la phase.
+    double totalMur; // Somme des durées réelles (en nanosecondes).
+    double totalCpu; // Somme des durées CPU (en nanosecondes).
+    double maxMur; // Plus longue durée réelle (en nanosecondes).
+    long histogramme[NB_CLASSES_DUREE]; // Nombre de durées réelles par classe, pour les centiles.
+} tMesurePhase;
+
+tMesurePhase lesMesures[NB_PHASES]; // Mesures cumulées de chaque phase depuis le lancement.
+const char *lesNomsPhases[NB_PHASES] = {"décision", "progression", "affichage", "entrée", "attente"};
+#endif
+
+typedef struct {
+    unsigned long graine; // Graine de la configuration de départ (0 : ordre des pommes d'origine).
+    int nbTours; // Nombre de tours joués pendant la partie.
+    int nbPommes1; // Pommes mangées par le serpent 1.
+    int nbPommes2; // Pommes mangées par le serpent 2.
+    int nbPas1; // Déplacements du serpent 1.
+    int nbPas2; // Déplacements du serpent 2.
+    bool gagne; // Vrai si toutes les pommes ont été mangées.
+    bool collision; // Vrai si la partie s'est terminée sur une collision.
+} tResultatPartie;
+
+// Zone partagée entre les processus du tournoi (mmap anonyme partagé). Chaque processus prend le lot
+// de parties suivant avec un incrément atomique : un processus en avance reprend aussitôt du travail,
+// et chaque partie écrit son résultat dans sa propre case, sans verrou.
+typedef struct {
+    long prochainePartie; // Première partie du lot suivant, avancée de TAILLE_LOT à chaque prise.
+    long nbParties; // Nombre total de parties du tournoi.
+    unsigned long graineInitiale; // Graine de la partie 0 ; la partie p a la graine graineInitiale + p.
+    tResultatPartie lesResultats[]; // Résultat de chaque partie.
+} tTournoi;
+
+// Journal binaire des parties : un en-tête pour tout le fichier (dimensions, nombre de serpents et règles
+// compilées), puis, pour chaque partie, un tPartieJournal suivi des coups joués. Un coup est la direction d'un
+// serpent en jeu pendant un tour, sur 2 bits (0 HAUT, 1 BAS, 2 GAUCHE, 3 DROITE), rangés tour par tour puis
+// serpent par serpent ; les serpents sortis du jeu n'ont plus de coups. Entiers dans l'ordre de la machine.
+typedef struct {
+    char signature[8]; // SIGNATURE_JOURNAL
+    uint32_t largeur; // largeurPlateau
+    uint32_t hauteur; // hauteurPlateau
+    uint32_t nbSerpents;
+    uint32_t nbPommes; // NB_POMMES, TAILLE, TAILLE_MAX et CROISSANCE : une partie ne se rejoue qu'avec les mêmes règles.
+    uint32_t taille;
+    uint32_t tailleMax;
+    uint32_t croissance;
+    uint32_t pommes; // Source des pommes (tSourcePommes) ; 0, les pommes fixes, dans les journaux plus anciens.
+} tEnteteJournal;
+
+typedef struct {
+    uint64_t graine; // Graine de la partie, passée à initPartie().
+    uint64_t empreinte; // Empreinte de l'état final (empreintePartie), vérifiée au rejeu.
+    uint32_t nbTours; // Nombre de tours joués.
+    uint32_t nbCoups; // Nombre de coups de 2 bits qui suivent (arrondis à l'octet).
+} tPartieJournal;
+
+// Enregistrement de la partie en cours : les coups s'ajoutent derrière l'en-tête de la partie, dans un tampon
+// qui ne fait que grandir ; la partie finie est écrite d'un seul write(). Le fichier est ouvert en ajout :
+// les processus du tournoi y écrivent chacun leurs parties entières, sans se mélanger.
+typedef struct {
+    int fd; // Fichier du journal (-1 : pas d'enregistrement).
+    unsigned char *tampon; // tPartieJournal puis coups de la partie en cours.
+    size_t capacite; // Taille du tampon.
+    size_t nbCoups; // Coups de la partie en cours.
+    bool erreur; // Vrai si une partie n'a pas pu être écrite.
+} tJournal;
+
+tJournal journal = {.fd = -1};
+
+// Équipe de fils de décision, créée une fois au lancement. À chaque tour, le fil principal publie la partie,
+// franchit la barrière de départ avec les autres fils, et tous prennent des lots de serpents jusqu'au dernier.
+// La barrière d'arrivée garantit que toutes les décisions sont écrites avant le déplacement des serpents.
+// Pendant les décisions, la partie n'est que lue, et chaque serpent écrit sa propre case de DECISIONS.
+// L'équipe sert aussi aux recherches d'un seul serpent : arbre Monte-Carlo propre à chaque fil, ou recherche
+// alpha-bêta de chaque fil sur une table de transposition commune.
+typedef struct {
+    pthread_t lesFils[NB_FILS_MAX]; // Fils de travail (le fil principal n'en fait pas partie).
+    int nbFils; // Nombre de fils qui décident, fil principal compris (1 : aucun fil créé).
+    pthread_barrier_t depart; // Franchie quand la partie du tour est publiée.
+    pthread_barrier_t arrivee; // Franchie quand tous les serpents ont décidé.
+    void (*travail)(void); // Travail du passage en cours : deciderLots, rechercheEquipe ou rechercheEquipeAlphaBeta.
+    bool occupee; // Vrai pendant un passage de deciderLots : une recherche ne peut pas y relancer l'équipe.
+    tPartie *partie; // Partie du tour en cours.
+    int caseCible; // Pomme à atteindre.
+    int prochainSerpent; // Premier serpent du lot suivant, avancé de LOT_DECISIONS à chaque prise.
+    const tPartie *partieRecherche; // Recherche en cours : partie, serpent, adversaire, simulations et échéance.
+    int serpentRecherche;
+    int adversaireRecherche;
+    long nbPlayoutsMcts;
+    struct timespec echeanceRecherche;
+    bool arret; // Vrai pour terminer les fils.
+} tEquipe;
+
+tEquipe equipe = {.nbFils = 1}; // Fils de décision, partagés par toutes les parties du processus.
+
+// Recherche arborescente Monte-Carlo pour coups simultanés : chaque nœud garde, pour le serpent qui cherche et pour
+// son adversaire, les visites et gains de chacun de leurs coups ; les deux choisissent séparément par UCB1, et le
+// coup joint (4 * coup du serpent + coup de l'adversaire) mène au nœud suivant. Les autres serpents, et les deux
+// serpents après la dernière case de l'arbre, jouent la stratégie des simulations.
+typedef enum {
+    ROLLOUT_ALEATOIRE, // Direction au hasard, sauf le demi-tour.
+    ROLLOUT_SURE, // Direction sûre au hasard.
+    ROLLOUT_CHEMIN // Stratégie ordinaire des serpents (plus court chemin ou heuristique).
+} tRollout;
+
+typedef struct {
+    int enfants[16]; // Nœud atteint par chaque coup joint, 0 : pas encore créé.
+    int visites; // Passages par ce nœud.
+    int visitesCoup[2][4]; // Passages par chaque coup : [0] serpent qui cherche, [1] adversaire.
+    float gains[2][4]; // Somme des gains de ces passages.
+    unsigned char coupsPossibles[2]; // Coups sûrs de chacun à ce nœud (bit d : 0 HAUT, 1 BAS, 2 GAUCHE, 3 DROITE).
+} tNoeudMcts;
+
+// Recherche propre à un fil : arbre, partie de simulation et instantané de la racine, gardés d'une décision à l'autre.
+typedef struct {
+    tNoeudMcts *noeuds; // NB_NOEUDS_MCTS nœuds, la racine en 0.
+    int nbNoeuds;
+    tPartie *jeu; // Copie de la partie où se jouent les simulations.
+    tInstantane *racine; // État de la racine, restauré au début de chaque simulation.
+    int serpent; // Serpent qui cherche son coup.
+    int adversaire; // Adversaire dont les coups sont dans l'arbre (-1 : aucun).
+    int ecartRacine; // Pommes du serpent moins celles de l'adversaire, à la racine.
+    double pommesActualisees[2]; // Pommes prises pendant la simulation par le serpent et l'adversaire, actualisées.
+    double actualisation; // ACTUALISATION_MCTS^t au tour t de la simulation.
+    uint64_t alea; // État du générateur splitmix64 du fil.
+    long nbPlayouts; // Simulations faites pour la décision en cours.
+} tRechercheMcts;
+
+typedef struct {
+    uint64_t serpents; // Bit s : le serpent s est dirigé par la recherche.
+    long budget; // Temps de recherche d'une décision (en nanosecondes).
+    long nbPlayouts; // Nombre fixe de simulations par décision (0 : budget en temps).
+    tRollout rollout; // Stratégie des simulations.
+    long nbDecisions; // Décisions cherchées depuis le lancement.
+    long nbPlayoutsTotal; // Simulations faites depuis le lancement, tous fils compris.
+    long dureeTotale; // Temps passé à chercher (en nanosecondes).
+} tMcts;
+
+tMcts mcts = {.budget = BUDGET_MCTS * 1000L, .rollout = ROLLOUT_CHEMIN};
+tRechercheMcts lesRecherches[NB_FILS_MAX]; // Une recherche par fil de l'équipe, indicée par rangFil.
+
+// Recherche alpha-bêta à profondeur croissante. Chaque tour cherché se joue puis s'annule (marquerTour, annulerTour)
+// sur la copie de la partie propre au fil. Les positions déjà vues sont retrouvées dans une table de transposition
+// indicée par leur hachage de Zobrist, de taille fixe et commune à tous les fils, sans verrou : chaque entrée garde
+// sa clé XOR ses données (une entrée déchirée par deux écritures simultanées ne se vérifie plus et est ignorée).
+typedef enum {
+    CLE_CORPS, // Anneau d'un serpent sur une case.
+    CLE_TETE, // Tête d'un serpent sur une case.
+    CLE_POMMES, // Nombre de pommes mangées par un serpent.
+    CLE_POMME_EN_JEU, // Indice et case de la pomme en jeu.
+    CLE_CAMP // Serpent qui cherche et adversaire : la valeur d'une position dépend du point de vue.
+} tCleZobrist;
+
+typedef enum {
+    BORNE_EXACTE, // Valeur exacte.
+    BORNE_INFERIEURE, // Coupure : la valeur est au moins celle-ci.
+    BORNE_SUPERIEURE // Aucun coup n'a dépassé alpha : la valeur est au plus celle-ci.
+} tBorne;
+
+typedef struct {
+    uint64_t verification; // Clé de la position XOR donnees.
+    uint64_t donnees; // Valeur (32 bits), profondeur (8 bits), borne (2 bits), meilleur coup (2 bits), validité (1 bit).
+} tEntreeTransposition;
+
+#define VALEUR_ENTREE(donnees) ((int)(int32_t)(uint32_t)(donnees))
+#define PROFONDEUR_ENTREE(donnees) ((int)(((donnees) >> 32) & 0xFF))
+#define BORNE_ENTREE(donnees) ((tBorne)(((donnees) >> 40) & 3))
+#define COUP_ENTREE(donnees) ((int)(((donnees) >> 42) & 3))
+#define ENTREE_VALIDE (1ULL << 44)
+
+// Recherche propre à un fil : partie où les coups sont joués puis annulés, et résultat de la dernière profondeur terminée.
+typedef struct {
+    tPartie *jeu;
+    tPileAnnulation pile;
+    int serpent; // Serpent qui cherche son coup.
+    int adversaire; // Adversaire dont les réponses sont cherchées (-1 : aucun).
+    uint64_t camp; // Clé du point de vue, ajoutée au hachage de chaque position.
+    int coupOrdinaire; // Coup de la stratégie ordinaire à la racine, gardé à valeur égale.
+    struct timespec echeance;
+    bool avecEcheance; // Faux à profondeur fixe.
+    bool interrompue; // Vrai une fois l'échéance passée : la profondeur en cours est abandonnée.
+    long nbNoeuds; // Nœuds, lectures de la table et entrées trouvées pour la décision en cours.
+    long nbLectures;
+    long nbTrouvees;
+    int coupRacine; // Meilleur coup de la racine à la profondeur en cours.
+    int meilleurCoup; // Meilleur coup de la dernière profondeur terminée (-1 : aucune).
+    int profondeur; // Dernière profondeur terminée.
+} tRechercheAlphaBeta;
+
+typedef struct {
+    uint64_t serpents; // Bit s : le serpent s est dirigé par la recherche alpha-bêta.
+    long budget; // Temps de recherche d'une décision (en nanosecondes).
+    int profondeur; // Profondeur fixe (0 : approfondissement jusqu'au budget).
+    long tailleTable; // Taille de la table de transposition (en mégaoctets).
+    tEntreeTransposition *table; // Table de transposition, masque + 1 entrées.
+    uint64_t masque;
+    long nbDecisions; // Cumuls depuis le lancement, tous fils compris.
+    long nbNoeudsTotal;
+    long sommeProfondeurs;
+    long nbLectures;
+    long nbTrouvees;
+    long dureeTotale; // Temps passé à chercher (en nanosecondes).
+} tAlphaBeta;
+
+tAlphaBeta alphabeta = {.budget = BUDGET_ALPHABETA * 1000L, .tailleTable = TABLE_ALPHABETA};
+tRechercheAlphaBeta lesRecherchesAlphaBeta[NB_FILS_MAX]; // Une recherche par fil de l'équipe, indicée par rangFil.
+
+// Portails visés par l'heuristique, placés par initDimensions() (valeurs du plateau de référence).
+Portail TROU_HAUT = {40, 0};  // Portail en haut du plateau (Portail de coordonnées (40, 0)).
+Portail TROU_BAS = {40, 40};  // Portail en bas du plateau (Portail de coordonnées (40, 40)).
+Portail TROU_GAUCHE = {0, 20};  // Portail à gauche du plateau (Portail de coordonnées (0, 20)).
+Portail TROU_DROITE = {80, 20};  // Portail à droite du plateau (Portail de coordonnées (80, 20)).
 
 // Prototypes des fonctions
-void initPlateau(tPlateau plateau); // Initialise le plateau avec des bordures et des espaces vides.
+void initDimensions(int largeur, int hauteur); // Fixe les dimensions du tampon, les trous et met les positions à l'échelle.
+int echelleX(int x); // Colonne du plateau courant correspondant à une colonne du plateau de référence.
+int echelleY(int y); // Ligne du plateau courant correspondant à une ligne du plateau de référence.
+void *allouerCases(size_t tailleCase); // Alloue un tampon aligné d'une valeur par case (garde comprise).
+int caseVoisine(tPlateau plateau, int c, int d); // Indice de la case voisine dans la direction d, trous compris.
+size_t reserver(size_t *taille, size_t octets); // Place un tableau à la fin de la disposition et retourne sa position.
+void initDisposition(void); // Place plateau, occupation et tableaux des serpents dans le bloc d'une partie.
+size_t taillePartie(void); // Taille en octets d'une partie, plateau, occupation et serpents compris.
+tPartie *nouvellePartie(void); // Alloue une partie (à libérer par free).
+void copierPartie(tPartie *copie, const tPartie *partie); // Copie complète d'une partie, en un seul memcpy.
+bool initPartie(tPartie *partie, unsigned long graine); // Configuration de départ : plateau, serpents et ordre des pommes (0 : ordre d'origine).
+bool placerSerpents(tPartie *partie); // Place les serpents au départ ; faux si le plateau est trop petit.
+bool tronconLibre(const tPartie *partie, int x, int y); // Vrai si TAILLE cases à partir de (x, y) peuvent recevoir un serpent.
+void jouerTour(tPartie *partie); // Décision puis déplacement simultané de tous les serpents, puis pommes ; met à jour collision et gagne.
+void appliquerTour(tPartie *partie); // Déplacement des serpents selon DECISIONS, pommes, sorties du jeu et compteur de tours.
+char deciderDirection(const tPartie *partie, int s, int caseCible); // Direction du serpent s, choisie d'après l'état du tour précédent seulement.
+char directionAutomatique(const tPartie *partie, int s, int caseCible); // Stratégie ordinaire : plus court chemin ou heuristique, puis sécurité et priorité.
+bool caseDisputee(const tPartie *partie, int s, int c); // Vrai si la tête d'un serpent de plus petit numéro peut entrer en c au même tour.
+char cederPassage(const tPartie *partie, int s, char direction); // Évite une case disputée s'il reste une autre direction sûre.
+void deciderSerpents(tPartie *partie, int caseCible); // Décision de tous les serpents en jeu, répartie sur l'équipe si elle sert.
+void deciderLots(void); // Prend des lots de serpents de la partie publiée jusqu'à ce qu'il n'en reste plus.
+void *filDecision(void *argument); // Boucle d'un fil de l'équipe : un passage par tour.
+void lancerEquipe(int nbFils); // Crée les fils de décision et leurs barrières.
+void arreterEquipe(void); // Termine et attend les fils de décision.
+size_t tailleInstantane(void); // Taille en octets d'un instantané.
+tInstantane *nouvelInstantane(void); // Alloue un instantané (à libérer par free).
+void prendreInstantane(tInstantane *instantane, const tPartie *partie); // Copie compteurs et serpents d'une partie.
+void restaurerInstantane(tPartie *partie, const tInstantane *instantane); // Remet la partie dans l'état de l'instantané.
+void poserCorps(tPartie *partie, int s, int sens); // Ajoute (sens 1) ou retire (sens -1) le corps du serpent s de l'occupation et des têtes.
+void marquerTour(tPileAnnulation *pile, const tPartie *partie); // Note ce que le prochain tour va changer.
+void annulerTour(tPileAnnulation *pile, tPartie *partie); // Défait le dernier tour marqué.
+void libererPileAnnulation(tPileAnnulation *pile); // Libère les tableaux de la pile.
+bool etatsEgaux(const tPartie *partie, const tPartie *copie); // Même état de jeu, et cases libres bien rangées.
+void mesurerInstantanes(long nbParties); // Vérifie puis chronomètre instantanés, restaurations et annulations.
+int releverEtats(tInstantane **lesEtats, unsigned long *lesGraines); // Joue des parties et garde des états variés (longueurs, avancement) et la graine de leur partie ; retourne leur nombre.
+double coutHorloge(void); // Coût moyen d'une lecture de l'horloge monotone, en nanosecondes.
+void noterMesure(FILE *detail, const char *fonction, const double *echantillons, long nbEchantillons); // Moyenne, intervalle de confiance et minimum d'une fonction.
+bool mesurerFonctions(long nbEchantillons, const char *nomDetail); // Chronomètre les fonctions de chaque tour ; CSV dans nomDetail.
+bool estSerpentMcts(int s); // Vrai si le serpent s est dirigé par la recherche Monte-Carlo.
+int adversaireProche(const tPartie *partie, int s); // Serpent en jeu le plus proche, dont les coups sont cherchés avec ceux du serpent s (-1 : aucun).
+unsigned coupsSurs(const tPartie *partie, int s); // Directions sûres du serpent s (bit d), ou sa direction actuelle s'il n'y en a aucune.
+char directionSimulation(const tPartie *partie, int s, int caseCible, uint64_t *alea); // Direction d'un serpent pendant une simulation.
+int nouveauNoeud(tRechercheMcts *recherche, const tPartie *jeu); // Ajoute un nœud pour l'état courant de la simulation.
+int choisirCoup(const tNoeudMcts *noeud, int joueur, uint64_t *alea); // Coup d'un des deux serpents à un nœud (UCB1).
+void jouerCoupsMcts(tRechercheMcts *recherche, int coupSerpent, int coupAdversaire); // Joue un tour de simulation avec ces coups imposés.
+double valeurMcts(const tRechercheMcts *recherche, int joueur); // Gain d'une simulation pour le serpent (0) ou son adversaire (1).
+int distanceEstimee(int caseDepart, int caseArrivee); // Distance sur le plateau fixe, ou de Manhattan sans la table.
+void simulerMcts(tRechercheMcts *recherche); // Une itération : descente, ajout d'un nœud, simulation, remontée des gains.
+void chercherMcts(tRechercheMcts *recherche, const tPartie *partie, int s, int adversaire, long nbPlayouts, struct timespec echeance); // Fait pousser un arbre jusqu'au budget.
+void rechercheEquipe(void); // Part d'un fil de l'équipe dans la recherche en cours.
+char directionMcts(const tPartie *partie, int s); // Direction du serpent s choisie par la recherche, sur toute l'équipe si elle est libre.
+void afficherBilanMcts(void); // Affiche décisions cherchées et simulations par seconde.
+void libererRecherches(void); // Libère arbres, parties de simulation et table de transposition.
+bool lireSerpents(const char *liste, uint64_t *serpents); // Ajoute les serpents d'une liste "1,2" à un masque (bit s - 1).
+bool estSerpentAlphaBeta(int s); // Vrai si le serpent s est dirigé par la recherche alpha-bêta.
+uint64_t cleZobrist(tCleZobrist type, int s, int valeur); // Clé de Zobrist d'un élément de la position.
+uint64_t zobristPartie(const tPartie *partie); // Hachage de Zobrist recalculé depuis zéro.
+uint64_t clePommeEnJeu(const tPartie *partie); // Clé de Zobrist de la pomme en jeu (0 si toutes sont mangées).
+void allouerTransposition(void); // Alloue la table de transposition à la taille demandée.
+bool lireTransposition(uint64_t cle, uint64_t *donnees); // Lit l'entrée d'une position, faux si elle n'y est pas.
+void ecrireTransposition(uint64_t cle, int valeur, int profondeur, tBorne borne, int coup); // Range le résultat d'une position.
+int espaceLibre(const tPartie *partie, int depart, int limite); // Cases libres atteignables depuis une case, jusqu'à limite.
+int evaluerAlphaBeta(const tRechercheAlphaBeta *recherche, int profondeur); // Valeur d'une position pour le serpent qui cherche.
+void jouerCoupsAlphaBeta(tRechercheAlphaBeta *recherche, int coupSerpent, int coupAdversaire); // Marque puis joue un tour avec ces coups.
+int alphaBeta(tRechercheAlphaBeta *recherche, int profondeur, int alpha, int beta, bool racine); // Valeur d'une position à profondeur tours.
+void chercherAlphaBeta(tRechercheAlphaBeta *recherche, const tPartie *partie, int s, int adversaire, int profondeurMax, struct timespec echeance, int premiereProfondeur); // Approfondissement itératif jusqu'à l'échéance.
+void rechercheEquipeAlphaBeta(void); // Part d'un fil de l'équipe dans la recherche alpha-bêta en cours.
+char directionAlphaBeta(const tPartie *partie, int s); // Direction du serpent s choisie par la recherche alpha-bêta.
+void afficherBilanAlphaBeta(void); // Affiche profondeur moyenne, nœuds par seconde et réussite de la table.
+uint64_t ajouterEmpreinte(uint64_t empreinte, const void *octets, size_t taille); // Ajoute des octets à une empreinte FNV-1a.
+uint64_t empreintePartie(const tPartie *partie); // Empreinte de tout l'état d'une partie (plateau, occupation, serpents, compteurs).
+bool ouvrirJournal(const char *nomFichier); // Crée le journal et écrit son en-tête.
+void commencerJournal(void); // Vide les coups de la partie qui commence.
+void noterCoups(const tPartie *partie); // Ajoute au journal les décisions des serpents en jeu.
+void terminerJournal(const tPartie *partie); // Écrit la partie finie dans le journal.
+bool rejouerJournal(const char *nomFichier); // Rejoue chaque partie du journal et compare son état final.
+bool partieTerminee(const tPartie *partie); // Toutes les pommes mangées, ou plus assez de serpents en jeu.
+void initPlateau(tPartie *partie); // Initialise le plateau avec des bordures et des espaces vides.
 void dessinerPlateau(tPlateau plateau); // Affiche le plateau à l'écran.
-void ajouterPomme(tPlateau plateau, int Pomme);
-void placerPaves(tPlateau plateau); // Ajoute les pavés à une position définie.
-void afficher(int x, int y, char car); // Affiche un caractère à une position donnée.
-void effacer(int x, int y); // Efface un caractère à une position donnée.
-void dessinerSerpent(int lesX[], int lesY[]); // Dessine le serpent entier sur le plateau.
-void dessinerSerpent2(int lesX2[], int lesY2[]); // Dessine le serpent entier sur le plateau.
-void progresser(int lesX[], int lesY[], char direction, tPlateau plateau, bool *collision, bool *pomme, int autreX[], int autreY[]); // Fait avancer le serpent 1 dans une direction donnée.
-void progresser2(int lesX2[], int lesY2[], char direction2, tPlateau plateau, bool *collision, bool *pomme, int autreX[], int autreY[]);// Fait avancer le serpent 2 dans une direction donnée.
+void ajouterPomme(tPartie *partie); // Place la prochaine pomme de la partie.
+void initCasesLibres(tPartie *partie); // Range les cases jouables sans anneau (pommes aléatoires seulement).
+void occuperCase(tPartie *partie, int c); // Ajoute un anneau sur la case c ; occupée, elle quitte les cases libres.
+void libererCase(tPartie *partie, int c); // Retire un anneau de la case c ; libre, elle rejoint les cases libres.
+int tirerCaseLibre(tPartie *partie); // Case libre tirée au hasard en temps constant (-1 : aucune).
+void placerPaves(tPartie *partie); // Ajoute les pavés à une position définie.
+void afficher(int x, int y, char car); // Place un caractère dans l'image voulue (affiché au prochain rafraîchissement).
+void afficherCase(int c, char car); // Même chose pour la case d'indice c.
+void effacer(int x, int y); // Efface un caractère dans l'image voulue.
+void initEcran(void); // Vide les deux images et prépare l'effacement du terminal.
+void ecrireTexte(int x, int y, const char *format, ...); // Écrit un texte à droite du plateau s'il a changé.
+void ajouterSortie(const char *texte, int longueur); // Ajoute des octets à la sortie de l'image en cours.
+void deplacerCurseur(int x, int y); // Ajoute à la sortie le déplacement du curseur en (x, y).
+void rafraichirEcran(void); // Envoie au terminal, en un seul write(), les cases qui ont changé.
+void initSerpent(tPartie *partie, int s, int xTete, int yTete, int sens); // Place le serpent s horizontal, tête en (xTete, yTete), anneaux vers -sens.
+int caseAnneau(const tPartie *partie, int s, int i); // Case du i-ème anneau du serpent s (0 pour la tête).
+void grandirSerpent(tPartie *partie, int s, int nbAnneaux); // Programme l'ajout d'anneaux, sans recopie du corps.
+char caractereTete(int s); // Caractère de la tête du serpent s : '1', '2'... puis des lettres.
+void dessinerSerpent(const tPartie *partie, int s); // Dessine le serpent entier sur le plateau.
+void avancerQueue(tPartie *partie, int s); // Libère la case de la queue, sauf si le serpent grandit.
+void avancerTete(tPartie *partie, int s, int c); // Ajoute la nouvelle tête en c, sans décaler les autres anneaux.
+void retirerSerpent(tPartie *partie, int s); // Enlève du plateau le corps d'un serpent sorti du jeu.
+int progresser(tPartie *partie); // Applique ensemble les décisions de tous les serpents ; retourne le serpent qui a mangé la pomme (-1 : aucun).
 void gotoxy(int x, int y); // Déplace le curseur à une position spécifique dans le terminal.
 int kbhit(void); // Vérifie si une touche a été pressée.
 void disable_echo(void); // Désactive l'écho des touches dans le terminal.
 void enable_echo(void); // Réactive l'écho des touches dans le terminal.
-bool PasserPortails(int lesX[], int lesY[]); // Gère la traversée des bords du plateau via les portails.
+void interrompre(int numeroSignal); // Rétablit le terminal puis quitte (Ctrl+C).
 int minimunTableau(tChemins Tableau); // Retourne l'index de la plus petite distance dans un tableau de distances.
-bool estSurCorpsSerpent(int x, int y, int lesX[], int lesY[]); // Vérifie si une position est occupée par le corps du serpent.
-bool estSurPave(int x, int y, tPlateau plateau); // Vérifie si une position est occupée par un pavé.
-bool directionEstSure(int x, int y, char direction, int lesX[], int lesY[], int autreX[], int autreY[], tPlateau plateau) ;// Vérifie si une direction est sans danger.
-char trouverDirectionSure(int lesX[], int lesY[], char directionActuelle, tPlateau plateau, int autreX[], int autreY[]);// Trouve une direction sûre pour le serpent.
-bool estSurCorpsAutreSerpent(int x, int y, int autreX[], int autreY[]); // Vérifie si les serpent sont pas l'un sur l'autre .
-
-int main() {
-    // 2 tableaux contenant les positions des éléments qui constituent le serpent
-    int lesX[TAILLE];  // Tableau pour les positions en X des différentes parties du serpent.
-    int lesY[TAILLE];  // Tableau pour les positions en Y des différentes parties du serpent.
-    
-    int lesX2[TAILLE];  // Tableau pour les positions en X des différentes parties du serpent.
-    int lesY2[TAILLE];  // Tableau pour les positions en Y des différentes parties du serpent.
-    
-    // Représente la touche frappée par l'utilisateur : touche de direction ou pour l'arrêt
-    char touche;
+bool estSurUnSerpent(const tPartie *partie, int c); // Vérifie si une case est occupée par un anneau de serpent (lecture d'une case).
+bool estSurPave(const tPartie *partie, int c); // Vérifie si une case est occupée par un pavé.
+int codeDirection(char direction); // Code d'une direction : 0 HAUT, 1 BAS, 2 GAUCHE, 3 DROITE.
+bool directionEstSure(const tPartie *partie, int c, char direction) ;// Vérifie si une direction est sans danger depuis la case c.
+char trouverDirectionSure(const tPartie *partie, int s, char directionActuelle);// Trouve une direction sûre pour le serpent s.
+char directionHeuristique(const tPartie *partie, int s, char direction, bool verticalDabord, int ligneAffichage); // Ancienne stratégie : distances de Manhattan directes ou via un portail.
+char directionVers(int x, int y, int cibleX, int cibleY, bool verticalDabord); // Direction qui rapproche (x, y) de la cible, un axe après l'autre.
+char directionPlusCourtChemin(const tPartie *partie, int s, int caseCible, char directionActuelle); // Premier pas du plus court chemin vers la cible (parcours en largeur).
+void calculerChampDistances(tPlateau plateau, int caseCible, uint32_t *champ, int *file); // Parcours en largeur depuis la pomme sur le plateau fixe.
+const uint32_t *distancesVers(tChampDistances *champ, tPlateau plateau, int caseCible); // Distances du champ à la cible, refait si la cible a changé.
+char directionChampDistances(const tPartie *partie, int s, int caseCible, char directionActuelle); // Pas lu dans le champ des distances, recherche locale bornée si un corps le barre.
+char rechercheLocale(const tPartie *partie, int caseTete, const uint32_t *champ, char directionActuelle, int s); // Contourne les corps jusqu'à une case plus proche de la pomme.
+uint64_t empreintePlateau(tPlateau plateau); // Empreinte des cases du plateau fixe, pour valider le fichier de la table.
+size_t tailleTableDistances(int nbCasesLibres); // Taille en octets du fichier de la table (en-tête compris).
+void calculerTableDistances(tPlateau plateau, unsigned char *distances, unsigned char *premiersPas); // Parcours en largeur depuis chaque case libre.
+bool chargerTableDistances(tPlateau plateau, const char *nomFichier); // Projette la table depuis le fichier, ou la calcule et l'enregistre.
+void libererTableDistances(void); // Libère la table des distances.
+char premierPasStatique(int caseDepart, int caseArrivee); // Premier pas du plus court chemin sur le plateau fixe entre deux cases, '\0' si aucun.
+int distanceStatique(int caseDepart, int caseArrivee); // Distance sur le plateau fixe, DISTANCE_INCONNUE si aucun chemin.
+tResultatPartie jouerPartie(tPartie *partie, bool interactif); // Joue une partie préparée jusqu'au bout, avec ou sans affichage ni attente.
+void simulerParties(long nbParties, unsigned long graine); // Enchaîne des parties sans affichage (graine, graine + 1...) et mesure le nombre de tours par seconde.
+uint64_t aleatoireSuivant(uint64_t *etat); // Générateur pseudo-aléatoire splitmix64.
+void jouerLots(tTournoi *tournoi); // Joue des lots de parties du tournoi jusqu'à ce qu'il n'en reste plus.
+bool lancerTournoi(long nbParties, int nbProcessus, unsigned long graine, const char *nomDetail); // Répartit les parties sur plusieurs processus et affiche le bilan.
+double tempsEcoule(struct timespec debut, struct timespec fin); // Retourne la durée en secondes entre deux instants.
+void ajouterNanosecondes(struct timespec *instant, long nanosecondes); // Avance un instant d'une durée donnée.
+void demarrerOrdonnanceur(tOrdonnanceur *ordo); // Fixe la première échéance à maintenant + une période.
+void attendreProchainTour(tOrdonnanceur *ordo); // Dort jusqu'à l'échéance du tour, ou applique la politique de retard.
+void afficherBilanOrdonnanceur(const tOrdonnanceur *ordo, int ligne); // Affiche échéances manquées et gigue du réveil.
+#ifdef MESURE_PHASES
+void debutPhase(tPhase phase); // Note l'heure et le temps CPU au début d'une phase.
+void finPhase(tPhase phase); // Ajoute la durée de la phase aux cumuls et à l'histogramme.
+int classeDuree(unsigned long long duree); // Classe de l'histogramme d'une durée en nanosecondes.
+double dureeClasse(int classe); // Plus petite durée (en nanosecondes) d'une classe de l'histogramme.
+double centilePhase(const tMesurePhase *mesure, double centile); // Durée sous laquelle tombe le centile demandé des mesures.
+void afficherMesuresPhases(void); // Affiche, par phase, totaux, moyenne, centiles et maximum.
+#endif
 
-    // Direction courante du serpent (HAUT, BAS, GAUCHE ou DROITE)
-    char direction;
-    char direction2;
+int main(int argc, char *argv[]) {
+    bool sansAffichage = false; // Mode simulation : "./version4 --sans-affichage [nbParties]"
+    bool avecTable = true; // Utilise la table des distances du plateau fixe.
+    long nbParties = NB_PARTIES_DEFAUT;
+    int largeur = LARGEUR_PLATEAU;
+    int hauteur = HAUTEUR_PLATEAU;
+    bool tournoi = false; // Tournoi : "./version4 --tournoi [nbParties] [--processus n] [--graine g] [--detail fichier.csv]"
+    int nbProcessus = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    unsigned long graine = 1;
+    const char *nomDetail = NULL;
+    int nbFils = 1; // Fils de décision : "./version4 --serpents 2000 --fils 8"
+    const char *nomJournal = NULL; // Journal : "./version4 --tournoi 1000000 --enregistrer parties.jnl"
+    const char *nomRejeu = NULL; // Rejeu : "./version4 --rejouer parties.jnl"
+    long nbPartiesInstantanes = 0; // Mesure : "./version4 --instantanes [nbParties]"
+    long nbEchantillonsMicro = 0; // Mesure : "./version4 --micro [nbEchantillons] [--detail fichier.csv]"
+    // Recherche : "./version4 --mcts 1 [--mcts-budget microsecondes | --mcts-playouts n] [--mcts-rollout chemin]"
+    //         ou "./version4 --alphabeta 1 [--alphabeta-budget microsecondes | --alphabeta-profondeur n] [--alphabeta-table Mo]"
 
-    // Le plateau de jeu
-    tPlateau lePlateau;
+    for (int i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], OPTION_SANS_AFFICHAGE) == 0) || (strcmp(argv[i], OPTION_TOURNOI) == 0))
+        {
+            sansAffichage = true;
+            tournoi = (strcmp(argv[i], OPTION_TOURNOI) == 0);
+            if ((i + 1 < argc) && (argv[i + 1][0] != '-'))
+            {
+                nbParties = atol(argv[++i]);
+                if (nbParties <= 0)
+                {
+                    fprintf(stderr, "Nombre de parties invalide : %s\n", argv[i]);
+                    return EXIT_FAILURE;
+                }
+            }
+        }
+        else if (strcmp(argv[i], OPTION_HEURISTIQUE) == 0)
+        {
+            heuristiqueManhattan = true;
+        }
+        else if (strcmp(argv[i], OPTION_SANS_TABLE) == 0)
+        {
+            avecTable = false;
+        }
+        else if ((strcmp(argv[i], OPTION_PERIODE) == 0) && (i + 1 < argc))
+        {
+            long periode = atol(argv[++i]);
+            if (periode <= 0)
+            {
+                fprintf(stderr, "Période invalide : %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+            ordonnanceur.periode = periode * 1000L;
+        }
+        else if (strcmp(argv[i], OPTION_SANS_RATTRAPAGE) == 0)
+        {
+            ordonnanceur.rattrapage = false;
+        }
+        else if ((strcmp(argv[i], OPTION_PROCESSUS) == 0) && (i + 1 < argc))
+        {
+            nbProcessus = atoi(argv[++i]);
+            if (nbProcessus <= 0)
+            {
+                fprintf(stderr, "Nombre de processus invalide : %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+        }
+        else if ((strcmp(argv[i], OPTION_GRAINE) == 0) && (i + 1 < argc))
+        {
+            graine = strtoul(argv[++i], NULL, 10);
+        }
+        else if ((strcmp(argv[i], OPTION_DETAIL) == 0) && (i + 1 < argc))
+        {
+            nomDetail = argv[++i];
+        }
+        else if ((strcmp(argv[i], OPTION_SERPENTS) == 0) && (i + 1 < argc))
+        {
+            nbSerpents = atoi(argv[++i]);
+            if ((nbSerpents <= 0) || (nbSerpents > NB_SERPENTS_MAX))
+            {
+                fprintf(stderr, "Nombre de serpents invalide : %s (de 1 à %d)\n", argv[i], NB_SERPENTS_MAX);
+                return EXIT_FAILURE;
+            }
+        }
+        else if ((strcmp(argv[i], OPTION_FILS) == 0) && (i + 1 < argc))
+        {
+            nbFils = atoi(argv[++i]);
+            if ((nbFils <= 0) || (nbFils > NB_FILS_MAX))
+            {
+                fprintf(stderr, "Nombre de fils invalide : %s (de 1 à %d)\n", argv[i], NB_FILS_MAX);
+                return EXIT_FAILURE;
+            }
+        }
+        else if (strcmp(argv[i], OPTION_INSTANTANES) == 0)
+        {
+            nbPartiesInstantanes = NB_PARTIES_INSTANTANES;
+            if ((i + 1 < argc) && (argv[i + 1][0] != '-'))
+            {
+                nbPartiesInstantanes = atol(argv[++i]);
+                if (nbPartiesInstantanes <= 0)
+                {
+                    fprintf(stderr, "Nombre de parties invalide : %s\n", argv[i]);
+                    return EXIT_FAILURE;
+                }
+            }
+        }
+        else if (strcmp(argv[i], OPTION_MICRO) == 0)
+        {
+            nbEchantillonsMicro = NB_ECHANTILLONS_MICRO;
+            if ((i + 1 < argc) && (argv[i + 1][0] != '-'))
+            {
+                nbEchantillonsMicro = atol(argv[++i]);
+                if (nbEchantillonsMicro <= 0)
+                {
+                    fprintf(stderr, "Nombre d'échantillons invalide : %s\n", argv[i]);
+                    return EXIT_FAILURE;
+                }
+            }
+        }
+        else if ((strcmp(argv[i], OPTION_MCTS) == 0) && (i + 1 < argc))
+        {
+            if (!lireSerpents(argv[++i], &mcts.serpents))
+            {
+                return EXIT_FAILURE;
+            }
+        }
+        else if ((strcmp(argv[i], OPTION_ALPHABETA) == 0) && (i + 1 < argc))
+        {
+            if (!lireSerpents(argv[++i], &alphabeta.serpents))
+            {
+                return EXIT_FAILURE;
+            }
+        }
+        else if ((strcmp(argv[i], OPTION_ALPHABETA_BUDGET) == 0) && (i + 1 < argc))
+        {
+            long budget = atol(argv[++i]);
+            if (budget <= 0)
+            {
+                fprintf(stderr, "Budget invalide : %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+            alphabeta.budget = budget * 1000L;
+        }
+        else if ((strcmp(argv[i], OPTION_ALPHABETA_PROFONDEUR) == 0) && (i + 1 < argc))
+        {
+            alphabeta.profondeur = atoi(argv[++i]);
+            if ((alphabeta.profondeur <= 0) || (alphabeta.profondeur > PROFONDEUR_MAX_ALPHABETA))
+            {
+                fprintf(stderr, "Profondeur invalide : %s (de 1 à %d)\n", argv[i], PROFONDEUR_MAX_ALPHABETA);
+                return EXIT_FAILURE;
+            }
+        }
+        else if ((strcmp(argv[i], OPTION_ALPHABETA_TABLE) == 0) && (i + 1 < argc))
+        {
+            alphabeta.tailleTable = atol(argv[++i]);
+            if ((alphabeta.tailleTable <= 0) || (alphabeta.tailleTable > TABLE_MAX_ALPHABETA))
+            {
+                fprintf(stderr, "Taille de table invalide : %s (de 1 à %d Mo)\n", argv[i], TABLE_MAX_ALPHABETA);
+                return EXIT_FAILURE;
+            }
+        }
+        else if ((strcmp(argv[i], OPTION_MCTS_BUDGET) == 0) && (i + 1 < argc))
+        {
+            long budget = atol(argv[++i]);
+            if (budget <= 0)
+            {
+                fprintf(stderr, "Budget invalide : %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+            mcts.budget = budget * 1000L;
+        }
+        else if ((strcmp(argv[i], OPTION_MCTS_PLAYOUTS) == 0) && (i + 1 < argc))
+        {
+            mcts.nbPlayouts = atol(argv[++i]);
+            if (mcts.nbPlayouts <= 0)
+            {
+                fprintf(stderr, "Nombre de simulations invalide : %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+        }
+        else if ((strcmp(argv[i], OPTION_MCTS_ROLLOUT) == 0) && (i + 1 < argc))
+        {
+            i++;
+            if (strcmp(argv[i], "aleatoire") == 0)
+            {
+                mcts.rollout = ROLLOUT_ALEATOIRE;
+            }
+            else if (strcmp(argv[i], "sure") == 0)
+            {
+                mcts.rollout = ROLLOUT_SURE;
+            }
+            else if (strcmp(argv[i], "chemin") == 0)
+            {
+                mcts.rollout = ROLLOUT_CHEMIN;
+            }
+            else
+            {
+                fprintf(stderr, "Stratégie de simulation invalide : %s (aleatoire, sure ou chemin)\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+        }
+        else if ((strcmp(argv[i], OPTION_POMMES) == 0) && (i + 1 < argc))
+        {
+            i++;
+            if (strcmp(argv[i], "fixes") == 0)
+            {
+                sourcePommes = POMMES_FIXES;
+            }
+            else if (strcmp(argv[i], "aleatoires") == 0)
+            {
+                sourcePommes = POMMES_ALEATOIRES;
+            }
+            else
+            {
+                fprintf(stderr, "Source de pommes invalide : %s (fixes ou aleatoires)\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+        }
+        else if ((strcmp(argv[i], OPTION_ENREGISTRER) == 0) && (i + 1 < argc))
+        {
+            nomJournal = argv[++i];
+        }
+        else if ((strcmp(argv[i], OPTION_REJOUER) == 0) && (i + 1 < argc))
+        {
+            nomRejeu = argv[++i];
+        }
+        else if ((strcmp(argv[i], OPTION_PLATEAU) == 0) && (i + 1 < argc))
+        {
+            i++;
+            if ((sscanf(argv[i], "%dx%d", &largeur, &hauteur) != 2)
+                || (largeur < LARGEUR_PLATEAU) || (largeur > LARGEUR_MAX) || (hauteur < HAUTEUR_PLATEAU) || (hauteur > HAUTEUR_MAX))
+            {
+                fprintf(stderr, "Plateau invalide : %s (de %dx%d à %dx%d)\n", argv[i], LARGEUR_PLATEAU, HAUTEUR_PLATEAU, LARGEUR_MAX, HAUTEUR_MAX);
+                return EXIT_FAILURE;
+            }
+        }
+        else
+        {
+            fprintf(stderr, "Usage : %s [%s [nbParties] [%s graine] | %s [nbParties] [%s n] [%s graine] [%s fichier.csv]]\n"
+                    "       [%s] [%s] [%s microsecondes] [%s] [%s LARGEURxHAUTEUR] [%s n] [%s n] [%s fixes|aleatoires]\n"
+                    "       [%s journal] | %s journal | %s [nbParties] | %s [nbEchantillons] [%s fichier.csv]\n"
+                    "       [%s 1,2] [%s microsecondes | %s n] [%s aleatoire|sure|chemin]\n"
+                    "       [%s 1,2] [%s microsecondes | %s n] [%s Mo]\n", argv[0], OPTION_SANS_AFFICHAGE, OPTION_GRAINE,
+                    OPTION_TOURNOI, OPTION_PROCESSUS, OPTION_GRAINE, OPTION_DETAIL,
+                    OPTION_HEURISTIQUE, OPTION_SANS_TABLE, OPTION_PERIODE, OPTION_SANS_RATTRAPAGE, OPTION_PLATEAU, OPTION_SERPENTS, OPTION_FILS, OPTION_POMMES,
+                    OPTION_ENREGISTRER, OPTION_REJOUER, OPTION_INSTANTANES, OPTION_MICRO, OPTION_DETAIL,
+                    OPTION_MCTS, OPTION_MCTS_BUDGET, OPTION_MCTS_PLAYOUTS, OPTION_MCTS_ROLLOUT,
+                    OPTION_ALPHABETA, OPTION_ALPHABETA_BUDGET, OPTION_ALPHABETA_PROFONDEUR, OPTION_ALPHABETA_TABLE);
+            return EXIT_FAILURE;
+        }
+    }
 
-    bool collision = false;  // Variable pour détecter si le serpent a heurter avec quelque chose (mur ou lui-même).
-    bool gagne = false;  // Indicateur de victoire (si toutes les pommes sont mangées).
-    bool pommeMangee = false;  // Indicateur pour savoir si une pomme a été mangée pendant le tour.
-    bool pommeMangee2 = false;  // Indicateur pour savoir si une pomme a été mangée pendant le tour.
+    if ((nbSerpents < NB_SERPENTS_MCTS) && (((mcts.serpents | alphabeta.serpents) >> nbSerpents) != 0))
+    {
+        fprintf(stderr, "Recherche demandée pour un serpent au-delà du serpent %d\n", nbSerpents);
+        return EXIT_FAILURE;
+    }
+    if ((mcts.serpents & alphabeta.serpents) != 0)
+    {
+        fprintf(stderr, "Un serpent ne peut pas suivre à la fois %s et %s\n", OPTION_MCTS, OPTION_ALPHABETA);
+        return EXIT_FAILURE;
+    }
 
-    // Initialisation de la position du serpent : positionnement de la tête en (X_DEPART_SERPENT, Y_DEPART_SERPENT), puis des anneaux à sa gauche.
-    for (int i = 0; i < TAILLE; i++) {
-        lesX[i] = X_DEPART_SERPENT - i;  // Position X de chaque partie du serpent.
-        lesY[i] = Y_DEPART_SERPENT;  // Position Y de chaque partie du serpent.
+    if (nomRejeu != NULL)
+    {
+        return rejouerJournal(nomRejeu) ? EXIT_SUCCESS : EXIT_FAILURE; // Dimensions et serpents viennent du journal.
     }
 
-    for (int i = 0; i < TAILLE; i++) {
-        lesX2[i] = X_DEPART_SERPENT_2 + i;  // Position X de chaque partie du serpent.
-        lesY2[i] = Y_DEPART_SERPENT_2;  // Position Y de chaque partie du serpent.
+    initDimensions(largeur, hauteur);
+    initDisposition();
+    tPartie *partieFixe = nouvellePartie(); // Bordures, trous et pavés seulement : ce qui ne change jamais pendant une partie.
+    if (!initPartie(partieFixe, 0))
+    {
+        fprintf(stderr, "Plateau trop petit pour %d serpents\n", nbSerpents);
+        free(partieFixe);
+        return EXIT_FAILURE;
+    }
+    if (avecTable && !heuristiqueManhattan)
+    {
+        initPlateau(partieFixe); // Plateau refait sans la pomme.
+        tableActive = chargerTableDistances(PLATEAU(partieFixe), FICHIER_DISTANCES);
+        champActif = !tableActive; // Plateau trop grand pour la table : un seul parcours par pomme.
+    }
+    free(partieFixe);
+    if (alphabeta.serpents != 0)
+    {
+        allouerTransposition();
     }
 
-    // Mise en place du plateau
-    initPlateau(lePlateau);  // Initialisation du plateau de jeu.
-    system("clear");  // Effacement de l'écran .
-    ajouterPomme(lePlateau, (NbPommesSerpentManger + NbPommesSerpentManger2));  // Ajoute une pomme sur le plateau.
-    dessinerPlateau(lePlateau);  // Dessine le plateau à l'écran.
+    if ((nomJournal != NULL) && !ouvrirJournal(nomJournal))
+    {
+        libererTableDistances();
+        return EXIT_FAILURE;
+    }
 
-    // Initialisation : le serpent se dirige vers la droite
-    dessinerSerpent(lesX, lesY);  // Dessine le serpent au début.
-    dessinerSerpent2(lesX2, lesY2);  // Dessine le serpent au début.
-    disable_echo();  // Désactive l'affichage des touches.
-    direction = DROITE;  // Initialisation de la direction du serpent 1 vers la droite.
-    direction2 = GAUCHE; // Initialisation de la direction du serpent 2 vers la gauche.
-    
-    // Boucle de jeu. Le jeu continue tant que l'utilisateur n'appuie pas sur la touche STOP ou qu'il n'y a pas de collision ou que toutes les pommes ne sont pas mangées.
-    do {
-		int CheminDirectPomme = abs(lesX[0] - lesPommesX[(NbPommesSerpentManger + NbPommesSerpentManger2)]) + abs(lesY[0] - lesPommesY[(NbPommesSerpentManger + NbPommesSerpentManger2)]); // Calcul de la distance directe entre la tête du serpent et la pomme
-
-        // Calcul des distances en passant par différents portails (haut, bas, gauche, droite)
-        // Chaque chemin nécessite de passer par un portail et d'en sortir de l'autre côté avant d'atteindre la pomme.
-        int CheminPortailHaut = abs(lesX[0] - TROU_HAUT.x) + abs(lesY[0] - TROU_HAUT.y) + abs(lesPommesX[(NbPommesSerpentManger + NbPommesSerpentManger2)] - TROU_BAS.x) + abs(lesPommesY[(NbPommesSerpentManger + NbPommesSerpentManger2)] - TROU_BAS.y);
-        int CheminPortailBas = abs(lesX[0] - TROU_BAS.x) + abs(lesY[0] - TROU_BAS.y) + abs(lesPommesX[(NbPommesSerpentManger + NbPommesSerpentManger2)] - TROU_HAUT.x) + abs(lesPommesY[(NbPommesSerpentManger + NbPommesSerpentManger2)] - TROU_HAUT.y);
-        int CheminPortailGauche = abs(lesX[0] - TROU_GAUCHE.x) + abs(lesY[0] - TROU_GAUCHE.y) + abs(lesPommesX[(NbPommesSerpentManger + NbPommesSerpentManger2)] - TROU_DROITE.x) + abs(lesPommesY[(NbPommesSerpentManger + NbPommesSerpentManger2)] - TROU_DROITE.y);
-        int CheminPortailDroite = abs(lesX[0] - TROU_DROITE.x) + abs(lesY[0] - TROU_DROITE.y) + abs(lesPommesX[(NbPommesSerpentManger + NbPommesSerpentManger2)] - TROU_GAUCHE.x) + abs(lesPommesY[(NbPommesSerpentManger + NbPommesSerpentManger2)] - TROU_GAUCHE.y);
-
-
-        int CheminDirectPomme2 = abs(lesX2[0] - lesPommesX[(NbPommesSerpentManger + NbPommesSerpentManger2)]) + abs(lesY2[0] - lesPommesY[(NbPommesSerpentManger + NbPommesSerpentManger2)]); // Calcul de la distance directe entre la tête du serpent et la pomme
-        int CheminPortailHaut2 = abs(lesX2[0] - TROU_HAUT.x) + abs(lesY2[0] - TROU_HAUT.y) + abs(lesPommesX[(NbPommesSerpentManger + NbPommesSerpentManger2)] - TROU_BAS.x) + abs(lesPommesY[(NbPommesSerpentManger + NbPommesSerpentManger2)] - TROU_BAS.y);
-        int CheminPortailBas2 = abs(lesX2[0] - TROU_BAS.x) + abs(lesY2[0] - TROU_BAS.y) + abs(lesPommesX[(NbPommesSerpentManger + NbPommesSerpentManger2)] - TROU_HAUT.x) + abs(lesPommesY[(NbPommesSerpentManger + NbPommesSerpentManger2)] - TROU_HAUT.y);
-        int CheminPortailGauche2 = abs(lesX2[0] - TROU_GAUCHE.x) + abs(lesY2[0] - TROU_GAUCHE.y) + abs(lesPommesX[(NbPommesSerpentManger + NbPommesSerpentManger2)] - TROU_DROITE.x) + abs(lesPommesY[(NbPommesSerpentManger + NbPommesSerpentManger2)] - TROU_DROITE.y);
-        int CheminPortailDroite2 = abs(lesX2[0] - TROU_DROITE.x) + abs(lesY2[0] - TROU_DROITE.y) + abs(lesPommesX[(NbPommesSerpentManger + NbPommesSerpentManger2)] - TROU_GAUCHE.x) + abs(lesPommesY[(NbPommesSerpentManger + NbPommesSerpentManger2)] - TROU_GAUCHE.y);
-
-
-
-        // Tableau contenant les distances calculées pour chaque chemin
-        tChemins Tableau = {CheminDirectPomme, CheminPortailHaut, CheminPortailBas, CheminPortailGauche, CheminPortailDroite};
-        tChemins Tableau2 = {CheminDirectPomme2, CheminPortailHaut2, CheminPortailBas2, CheminPortailGauche2, CheminPortailDroite2};
-        
-        // Affichage pour moi, pour comprendre comment les distances fonctionnent.
-        gotoxy(2+LARGEUR_PLATEAU, 1);
-        printf("Distance Pomme : %4d pas", CheminDirectPomme);
-        gotoxy(2+LARGEUR_PLATEAU, 2);
-        printf("Distance Portail Haut + Pomme : %4d pas", CheminPortailHaut);
-        gotoxy(2+LARGEUR_PLATEAU, 3);
-        printf("Distance Portail Bas + Pomme : %4d pas", CheminPortailBas);
-        gotoxy(2+LARGEUR_PLATEAU, 4);
-        printf("Distance Portail Gauche + Pomme : %4d pas", CheminPortailGauche);
-        gotoxy(2+LARGEUR_PLATEAU, 5);
-        printf("Distance Portail Droit + Pomme : %4d pas", CheminPortailDroite);
-
-        gotoxy(2+LARGEUR_PLATEAU, 7);
-        printf("Distance 2 Pomme : %4d pas", CheminDirectPomme2);
-        gotoxy(2+LARGEUR_PLATEAU, 8);
-        printf("Distance 2 Portail Haut + Pomme : %4d pas", CheminPortailHaut2);
-        gotoxy(2+LARGEUR_PLATEAU, 9);
-        printf("Distance 2 Portail Bas + Pomme : %4d pas", CheminPortailBas2);
-        gotoxy(2+LARGEUR_PLATEAU, 10);
-        printf("Distance 2 Portail Gauche + Pomme : %4d pas", CheminPortailGauche2);
-        gotoxy(2+LARGEUR_PLATEAU, 11);
-        printf("Distance 2 Portail Droit + Pomme : %4d pas", CheminPortailDroite2);
-
-        int minimunDes5distances = minimunTableau(Tableau); // Calcule la minimun des distances pour atteindre la pomme.
-        int minimunDes5distances2 = minimunTableau(Tableau2); // Calcule la minimun des distances pour atteindre la pomme.
-
-
-
-        switch (minimunDes5distances)
-        {
-            case 0:
-                // Cas 0 : Chemin direct vers la pomme
-                // Si la pomme est plus proche sans utiliser de portail, on va vers la pomme.
-                if ((lesPommesY[(NbPommesSerpentManger + NbPommesSerpentManger2)] - lesY[0]) < 0) 
-                {
-                    direction = HAUT; // La pomme est située au-dessus de la tête du serpent.
-                } 
-                else if ((lesPommesY[(NbPommesSerpentManger + NbPommesSerpentManger2)] - lesY[0]) > 0) 
-                {
-                    direction = BAS; // La pomme est située en-dessous de la tête du serpent.
-                } 
-                else if ((lesPommesX[(NbPommesSerpentManger + NbPommesSerpentManger2)] - lesX[0]) < 0) 
-                {
-                    direction = GAUCHE; // La pomme est à gauche de la tête du serpent.
-                } 
-                else 
-                {
-                    direction = DROITE; // La pomme est à droite de la tête du serpent.
-                }
-                break;
+    if (tournoi)
+    {
+        // Les fils ne survivent pas à fork() : chaque processus du tournoi décide seul.
+        bool reussi = lancerTournoi(nbParties, nbProcessus, graine, nomDetail);
+        reussi = (journal.fd < 0) || ((close(journal.fd) == 0) && reussi);
+        libererTableDistances();
+        return reussi ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
 
-            case 1:
-                // Cas 1 : Chemin via le portail haut
-                if (PasserPortails(lesX, lesY) == false)
-                {
-                    // Si le serpent n'est pas encore au portail haut, il se dirige vers le portail.
-                    if ((TROU_HAUT.y - lesY[0]) < 0) 
-                    {
-                        direction = HAUT; // Le portail haut est au-dessus de la tête du serpent.
-                    } 
-                    else if ((TROU_HAUT.y - lesY[0]) > 0)
-                    {
-                        direction = BAS; // Le portail haut est en-dessous de la tête.
-                    }
-                    else if ((TROU_HAUT.x - lesX[0]) < 0) 
-                    {
-                        direction = GAUCHE; // Le portail haut est à gauche de la tête.
-                    } else 
-                    {
-                        direction = DROITE; // Le portail haut est à droite de la tête.
-                    }
-                } else {
-                    // Une fois passé par le portail, on calcule la direction directe vers la pomme.
-                    if ((lesPommesY[(NbPommesSerpentManger + NbPommesSerpentManger2)] - lesY[0]) < 0) 
-                    {
-                        direction = HAUT; // La pomme est au-dessus après téléportation.
-                    } 
-                    else if ((lesPommesY[(NbPommesSerpentManger + NbPommesSerpentManger2)] - lesY[0]) > 0) 
-                    {
-                        direction = BAS; // La pomme est en-dessous après téléportation.
-                    } 
-                    else if ((lesPommesX[(NbPommesSerpentManger + NbPommesSerpentManger2)] - lesX[0]) < 0) 
-                    {
-                        direction = GAUCHE; // La pomme est à gauche après téléportation.
-                    } 
-                    else 
-                    {
-                        direction = DROITE; // La pomme est à droite après téléportation.
-                    }
-                }
-                break;
+    if (nbFils > 1)
+    {
+        lancerEquipe(nbFils);
+    }
 
-            case 2:
-                // Cas 2 : Chemin via le portail bas
-                if (PasserPortails(lesX, lesY) == false) 
-                {
-                    // Si le serpent n'est pas encore au portail bas, il se dirige vers le portail.
-                    if ((TROU_BAS.y - lesY[0]) < 0) 
-                    {
-                        direction = HAUT; // Le portail bas est au-dessus de la tête du serpent.
-                    } 
-                    else if ((TROU_BAS.y - lesY[0]) > 0) 
-                    {
-                        direction = BAS; // Le portail bas est en-dessous de la tête.
-                    } 
-                    else if ((TROU_BAS.x - lesX[0]) < 0) 
-                    {
-                        direction = GAUCHE; // Le portail bas est à gauche de la tête.
-                    } 
-                    else 
-                    {
-                        direction = DROITE; // Le portail bas est à droite de la tête.
-                    }
-                } else {
-                    // Une fois passé par le portail, on calcule la direction directe vers la pomme.
-                    if ((lesPommesY[(NbPommesSerpentManger + NbPommesSerpentManger2)] - lesY[0]) < 0)
-                    {
-                        direction = HAUT; // La pomme est au-dessus après téléportation.
-                    } 
-                    else if ((lesPommesY[(NbPommesSerpentManger + NbPommesSerpentManger2)] - lesY[0]) > 0) 
-                    {
-                        direction = BAS; // La pomme est en-dessous après téléportation.
-                    } 
-                    else if ((lesPommesX[(NbPommesSerpentManger + NbPommesSerpentManger2)] - lesX[0]) < 0) 
-                    {
-                        direction = GAUCHE; // La pomme est à gauche après téléportation.
-                    } 
-                    else 
-                    {
-                        direction = DROITE; // La pomme est à droite après téléportation.
-                    }
-                }
-                break;
+    if (nbPartiesInstantanes > 0)
+    {
+        mesurerInstantanes(nbPartiesInstantanes);
+        arreterEquipe();
+        libererTableDistances();
+        return EXIT_SUCCESS;
+    }
 
-            case 3:
-                // Cas 3 : Chemin via le portail gauche
-                if (PasserPortails(lesX, lesY) == false) 
-                {
-                    // Si le serpent n'est pas encore au portail gauche, il se dirige vers le portail.
-                    if ((TROU_GAUCHE.y - lesY[0]) < 0) 
-                    {
-                        direction = HAUT; // Le portail gauche est au-dessus de la tête du serpent.
-                    } 
-                    else if ((TROU_GAUCHE.y - lesY[0]) > 0) 
-                    {
-                        direction = BAS; // Le portail gauche est en-dessous de la tête.
-                    } 
-                    else if ((TROU_GAUCHE.x - lesX[0]) < 0) 
-                    {
-                        direction = GAUCHE; // Le portail gauche est à gauche de la tête.
-                    } 
-                    else 
-                    {
-                        direction = DROITE; // Le portail gauche est à droite de la tête.
-                    }
-                } 
-                else 
-                {
-                    // Une fois passé par le portail, on calcule la direction directe vers la pomme.
-                    if ((lesPommesY[(NbPommesSerpentManger + NbPommesSerpentManger2)] - lesY[0]) < 0) 
-                    {
-                        direction = HAUT; // La pomme est au-dessus après téléportation.
-                    } 
-                    else if ((lesPommesY[(NbPommesSerpentManger + NbPommesSerpentManger2)] - lesY[0]) > 0) 
-                    {
-                        direction = BAS; // La pomme est en-dessous après téléportation.
-                    } 
-                    else if ((lesPommesX[(NbPommesSerpentManger + NbPommesSerpentManger2)] - lesX[0]) < 0) 
-                    {
-                        direction = GAUCHE; // La pomme est à gauche après téléportation.
-                    } 
-                    else 
-                    {
-                        direction = DROITE; // La pomme est à droite après téléportation.
-                    }
-                }
-                break;
+    if (nbEchantillonsMicro > 0)
+    {
+        bool reussi = mesurerFonctions(nbEchantillonsMicro, nomDetail);
+        arreterEquipe();
+        libererTableDistances();
+        return reussi ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
 
-            case 4:
-                // Cas 4 : Chemin via le portail droit
-                if (PasserPortails(lesX, lesY) == false)
-                {
-                    // Si le serpent n'est pas encore au portail droit, il se dirige vers le portail.
-                    if ((TROU_DROITE.y - lesY[0]) < 0) 
-                    {
-                        direction = HAUT; // Le portail droit est au-dessus de la tête du serpent.
-                    } 
-                    else if ((TROU_DROITE.y - lesY[0]) > 0) 
-                    {
-                        direction = BAS; // Le portail droit est en-dessous de la tête.
-                    } 
-                    else if ((TROU_DROITE.x - lesX[0]) < 0) 
-                    {
-                        direction = GAUCHE; // Le portail droit est à gauche de la tête.
-                    } 
-                    else
-                    {
-                        direction = DROITE; // Le portail droit est à droite de la tête.
-                    }
-                } 
-                else 
-                {
-                    // Une fois passé par le portail, on calcule la direction directe vers la pomme.
-                    if ((lesPommesY[(NbPommesSerpentManger + NbPommesSerpentManger2)] - lesY[0]) < 0) 
-                    {
-                        direction = HAUT; // La pomme est au-dessus après téléportation.
-                    } 
-                    else if ((lesPommesY[(NbPommesSerpentManger + NbPommesSerpentManger2)] - lesY[0]) > 0) 
-                    {
-                        direction = BAS; // La pomme est en-dessous après téléportation.
-                    } 
-                    else if ((lesPommesX[(NbPommesSerpentManger + NbPommesSerpentManger2)] - lesX[0]) < 0) 
-                    {
-                        direction = GAUCHE; // La pomme est à gauche après téléportation.
-                    } 
-                    else 
-                    {
-                        direction = DROITE; // La pomme est à droite après téléportation.
-                    }
-                }
-                break;
-        }
+    if (sansAffichage)
+    {
+        simulerParties(nbParties, graine);
+        afficherBilanMcts();
+        afficherBilanAlphaBeta();
+#ifdef MESURE_PHASES
+        afficherMesuresPhases();
+#endif
+        arreterEquipe();
+        libererRecherches();
+        libererTableDistances();
+        bool journalEcrit = (journal.fd < 0) || ((close(journal.fd) == 0) && !journal.erreur);
+        return journalEcrit ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
 
+    tPartie *partie = nouvellePartie();
+    initPartie(partie, 0);
+    affichageActif = true;
+    tResultatPartie resultat = jouerPartie(partie, true); // Partie normale, affichée dans le terminal.
+    free(partie);
 
-        switch (minimunDes5distances2)
-        {
-            case 0:
-                // Cas 0 : Chemin direct vers la pomme
-                // Si la pomme est plus proche sans utiliser de portail, on va vers la pomme.
-                if ((lesPommesX[(NbPommesSerpentManger + NbPommesSerpentManger2)] - lesX2[0]) < 0) 
-                {
-                    direction2 = GAUCHE; // La pomme est à gauche de la tête du serpent.
-                } 
-                else if ((lesPommesX[(NbPommesSerpentManger + NbPommesSerpentManger2)] - lesX2[0]) > 0) 
-                {
-                    direction2 = DROITE; // La pomme est à droite de la tête du serpent.
-                } 
-                else if ((lesPommesY[(NbPommesSerpentManger + NbPommesSerpentManger2)] - lesY2[0]) < 0) 
-                {
-                    direction2 = HAUT; // La pomme est située au-dessus de la tête du serpent.
-                } 
-                else 
-                {
-                    direction2 = BAS; // La pomme est située en-dessous de la tête du serpent.
-                }
-                break;
+	gotoxy(largeurPlateau+1, 1); // Déplace le curseur en dehors du plateau de jeu.
+	if (resultat.gagne)
+	{
+		gotoxy(2, hauteurPlateau+1);
+		printf("Compteur de pas pour le Serpent 1 : %d et le nombre de pommes mangée %d \n", resultat.nbPas1, resultat.nbPommes1);// Affiche les performances du programme.
+        gotoxy(2,hauteurPlateau+2);
+		printf("Compteur de pas pour le Serpent 2 : %d et le nombre de pommes mangée %d \n", resultat.nbPas2, resultat.nbPommes2);// Affiche les performances du programme.
+	}
+    afficherBilanOrdonnanceur(&ordonnanceur, hauteurPlateau+3);
+    afficherBilanMcts();
+    afficherBilanAlphaBeta();
+#ifdef MESURE_PHASES
+    afficherMesuresPhases();
+#endif
+    arreterEquipe();
+    libererRecherches();
+    libererTableDistances();
+    bool journalEcrit = (journal.fd < 0) || ((close(journal.fd) == 0) && !journal.erreur);
+	return journalEcrit ? EXIT_SUCCESS : EXIT_FAILURE;
+}
 
-            case 1:
-                // Cas 1 : Chemin via le portail haut
-                if (PasserPortails(lesX2, lesY2) == false)
-                {
-                    // Si le serpent n'est pas encore au portail haut, il se dirige vers le portail.
-                    if ((TROU_HAUT.x - lesX2[0]) < 0) 
-                    {
-                        direction2 = GAUCHE; // Le portail haut est à gauche de la tête du serpent.
-                    } 
-                    else if ((TROU_HAUT.x - lesX2[0]) > 0)
-                    {
-                        direction2 = DROITE; // Le portail haut est à droite de la tête.
-                    }
-                    else if ((TROU_HAUT.y - lesY2[0]) < 0) 
-                    {
-                        direction2 = HAUT; // Le portail haut est au-dessus de la tête du serpent.
-                    } 
-                    else 
-                    {
-                        direction2 = BAS; // Le portail haut est en-dessous de la tête.
-                    }
-                } 
-                else 
-                {
-                    // Une fois passé par le portail, on calcule la direction2 directe vers la pomme.
-                    if ((lesPommesX[(NbPommesSerpentManger + NbPommesSerpentManger2)] - lesX2[0]) < 0) 
-                    {
-                        direction2 = GAUCHE; // La pomme est à gauche après téléportation.
-                    } 
-                    else if ((lesPommesX[(NbPommesSerpentManger + NbPommesSerpentManger2)] - lesX2[0]) > 0) 
-                    {
-                        direction2 = DROITE; // La pomme est à droite après téléportation.
-                    } 
-                    else if ((lesPommesY[(NbPommesSerpentManger + NbPommesSerpentManger2)] - lesY2[0]) < 0) 
-                    {
-                        direction2 = HAUT; // La pomme est au-dessus après téléportation.
-                    } 
-                    else 
-                    {
-                        direction2 = BAS; // La pomme est en-dessous après téléportation.
-                    }
-                }
-                break;
+/************************************************/
+/*		DÉROULEMENT D'UNE PARTIE     			*/
+/************************************************/
 
-            case 2:
-                // Cas 2 : Chemin via le portail bas
-                if (PasserPortails(lesX2, lesY2) == false) 
-                {
-                    // Si le serpent n'est pas encore au portail bas, il se dirige vers le portail.
-                    if ((TROU_BAS.x - lesX2[0]) < 0) 
-                    {
-                        direction2 = GAUCHE; // Le portail bas est à gauche de la tête du serpent.
-                    } 
-                    else if ((TROU_BAS.x - lesX2[0]) > 0) 
-                    {
-                        direction2 = DROITE; // Le portail bas est à droite de la tête.
-                    } 
-                    else if ((TROU_BAS.y - lesY2[0]) < 0) 
-                    {
-                        direction2 = HAUT; // Le portail bas est au-dessus de la tête.
-                    } 
-                    else 
-                    {
-                        direction2 = BAS; // Le portail bas est en-dessous de la tête.
-                    }
-                } 
-                else 
-                {
-                    // Une fois passé par le portail, on calcule la direction2 directe vers la pomme.
-                    if ((lesPommesX[(NbPommesSerpentManger + NbPommesSerpentManger2)] - lesX2[0]) < 0) 
-                    {
-                        direction2 = GAUCHE; // La pomme est à gauche après téléportation.
-                    } 
-                    else if ((lesPommesX[(NbPommesSerpentManger + NbPommesSerpentManger2)] - lesX2[0]) > 0) 
-                    {
-                        direction2 = DROITE; // La pomme est à droite après téléportation.
-                    } 
-                    else if ((lesPommesY[(NbPommesSerpentManger + NbPommesSerpentManger2)] - lesY2[0]) < 0) 
-                    {
-                        direction2 = HAUT; // La pomme est au-dessus après téléportation.
-                    } 
-                    else 
-                    {
-                        direction2 = BAS; // La pomme est en-dessous après téléportation.
-                    }
-                }
-                break;
+size_t reserver(size_t *taille, size_t octets) {
+    size_t position = *taille;
+    *taille += (octets + ALIGNEMENT_CASES - 1) / ALIGNEMENT_CASES * ALIGNEMENT_CASES; // Chaque tableau commence sur une ligne de cache.
+    return position;
+}
 
-            case 3:
-                // Cas 3 : Chemin via le portail gauche
-                if (PasserPortails(lesX2, lesY2) == false) 
-                {
-                    // Si le serpent n'est pas encore au portail gauche, il se dirige vers le portail.
-                    if ((TROU_GAUCHE.x - lesX2[0]) < 0) 
-                    {
-                        direction2 = GAUCHE; // Le portail gauche est à gauche de la tête du serpent.
-                    } 
-                    else if ((TROU_GAUCHE.x - lesX2[0]) > 0) 
-                    {
-                        direction2 = DROITE; // Le portail gauche est à droite de la tête.
-                    } 
-                    else if ((TROU_GAUCHE.y - lesY2[0]) < 0) 
-                    {
-                        direction2 = HAUT; // Le portail gauche est au-dessus de la tête.
-                    } 
-                    else 
-                    {
-                        direction2 = BAS; // Le portail gauche est en-dessous de la tête.
-                    }
-                } 
-                else 
-                {
-                    // Une fois passé par le portail, on calcule la direction2 directe vers la pomme.
-                    if ((lesPommesX[(NbPommesSerpentManger + NbPommesSerpentManger2)] - lesX2[0]) < 0) 
-                    {
-                        direction2 = GAUCHE; // La pomme est à gauche après téléportation.
-                    } 
-                    else if ((lesPommesX[(NbPommesSerpentManger + NbPommesSerpentManger2)] - lesX2[0]) > 0) 
-                    {
-                        direction2 = DROITE; // La pomme est à droite après téléportation.
-                    } 
-                    else if ((lesPommesY[(NbPommesSerpentManger + NbPommesSerpentManger2)] - lesY2[0]) < 0) 
-                    {
-                        direction2 = HAUT; // La pomme est au-dessus après téléportation.
-                    } 
-                    else 
-                    {
-                        direction2 = BAS; // La pomme est en-dessous après téléportation.
-                    }
-                }
-                break;
 
-            case 4:
-                // Cas 4 : Chemin via le portail droit
-                if (PasserPortails(lesX2, lesY2) == false)
-                {
-                    // Si le serpent n'est pas encore au portail droit, il se dirige vers le portail.
-                    if ((TROU_DROITE.x - lesX2[0]) < 0) 
-                    {
-                        direction2 = GAUCHE; // Le portail droit est à gauche de la tête du serpent.
-                    } 
-                    else if ((TROU_DROITE.x - lesX2[0]) > 0) 
-                    {
-                        direction2 = DROITE; // Le portail droit est à droite de la tête.
-                    } 
-                    else if ((TROU_DROITE.y - lesY2[0]) < 0) 
-                    {
-                        direction2 = HAUT; // Le portail droit est au-dessus de la tête.
-                    } 
-                    else 
-                    {
-                        direction2 = BAS; // Le portail droit est en-dessous de la tête.
-                    }
-                } 
-                else 
-                {
-                    // Une fois passé par le portail, on calcule la direction2 directe vers la pomme.
-                    if ((lesPommesX[(NbPommesSerpentManger + NbPommesSerpentManger2)] - lesX2[0]) < 0) 
-                    {
-                        direction2 = GAUCHE; // La pomme est à gauche après téléportation.
-                    } 
-                    else if ((lesPommesX[(NbPommesSerpentManger + NbPommesSerpentManger2)] - lesX2[0]) > 0) 
-                    {
-                        direction2 = DROITE; // La pomme est à droite après téléportation.
-                    } 
-                    else if ((lesPommesY[(NbPommesSerpentManger + NbPommesSerpentManger2)] - lesY2[0]) < 0) 
-                    {
-                        direction2 = HAUT; // La pomme est au-dessus après téléportation.
-                    } 
-                    else 
-                    {
-                        direction2 = BAS; // La pomme est en-dessous après téléportation.
-                    }
-                }
-                break;
-        }
-        
-		progresser(lesX, lesY, direction, lePlateau, &collision, &pommeMangee, lesX2, lesY2);
-        progresser2(lesX2, lesY2, direction2, lePlateau, &collision, &pommeMangee2, lesX, lesY);
-        
-        PasserPortails(lesX, lesY); //Vérifie si le serpent est passé par un portail.
-        PasserPortails(lesX2, lesY2);
-
-		if (pommeMangee) // Ajoute une pomme au compteur de pommes quand elle est mangée et arrête le jeu si le score atteint 10.
-		{
-            NbPommesSerpentManger++;
-        
-			gagne = ((NbPommesSerpentManger + NbPommesSerpentManger2)== NB_POMMES); // Vérifie si toutes les pommes ont été mangées.
-			if (!gagne)
-			{
-				ajouterPomme(lePlateau, (NbPommesSerpentManger + NbPommesSerpentManger2));// Ajoute une nouvelle pomme sur le plateau.
-				pommeMangee = false; // Réinitialise l'indicateur de pomme mangée.
-                pommeMangee2 = false;
-			}	
-			
-		}
-
-        else if (pommeMangee2) // Ajoute une pomme au compteur de pommes quand elle est mangée et arrête le jeu si le score atteint 10.
-		{
-            NbPommesSerpentManger2++;
-
-			gagne = ((NbPommesSerpentManger + NbPommesSerpentManger2)== NB_POMMES); // Vérifie si toutes les pommes ont été mangées.
-			if (!gagne)
-			{
-				ajouterPomme(lePlateau, (NbPommesSerpentManger + NbPommesSerpentManger2));// Ajoute une nouvelle pomme sur le plateau.
-				pommeMangee = false; // Réinitialise l'indicateur de pomme mangée.
-                pommeMangee2 = false;
-			}	
-			
-		}
-
-		if (!gagne) // Continue à faire avancer le serpent si le jeu n'est pas terminé.
-		{
-			if (!collision)
-            {
-                usleep(ATTENTE);  // Attends un certain temps avant de redessiner le plateau.
-                if (kbhit() == 1)  // Si une touche a été pressée.
-                {
-                    touche = getchar();  // Lit la touche pressée.
+void initDisposition(void) {
+    size_t taille = 0;
+
+    disposition.plateau = reserver(&taille, (size_t)nbCasesMemoire);
+    disposition.occupation = reserver(&taille, (size_t)nbCasesMemoire);
+    disposition.teteSur = reserver(&taille, sizeof(int) * (size_t)nbCasesMemoire);
+    size_t nbCasesIndex = (sourcePommes == POMMES_ALEATOIRES) ? (size_t)nbCasesMemoire : 0; // Inutile avec les pommes fixes.
+    disposition.casesLibres = reserver(&taille, sizeof(int) * nbCasesIndex);
+    disposition.rangLibre = reserver(&taille, sizeof(int) * nbCasesIndex);
+    disposition.anneaux = reserver(&taille, sizeof(int) * TAILLE_MAX * (size_t)nbSerpents);
+    disposition.tetes = reserver(&taille, sizeof(int) * (size_t)nbSerpents);
+    disposition.longueurs = reserver(&taille, sizeof(int) * (size_t)nbSerpents);
+    disposition.aGrandir = reserver(&taille, sizeof(int) * (size_t)nbSerpents);
+    disposition.pommes = reserver(&taille, sizeof(int) * (size_t)nbSerpents);
+    disposition.pas = reserver(&taille, sizeof(int) * (size_t)nbSerpents);
+    disposition.directions = reserver(&taille, (size_t)nbSerpents);
+    disposition.decisions = reserver(&taille, (size_t)nbSerpents);
+    disposition.vivants = reserver(&taille, sizeof(bool) * (size_t)nbSerpents);
+    disposition.taille = taille;
+}
+
+
+size_t taillePartie(void) {
+    return sizeof(tPartie) + disposition.taille; // sizeof(tPartie) est un multiple de ALIGNEMENT_CASES.
+}
+
+
+tPartie *nouvellePartie(void) {
+    tPartie *partie = aligned_alloc(ALIGNEMENT_CASES, taillePartie());
+
+    if (partie == NULL)
+    {
+        perror("aligned_alloc");
+        exit(EXIT_FAILURE);
+    }
+    return partie;
+}
+
+
+void copierPartie(tPartie *copie, const tPartie *partie) {
+    memcpy(copie, partie, taillePartie()); // Aucun pointeur dans une partie : la copie est indépendante.
+}
+
+
+bool initPartie(tPartie *partie, unsigned long graine) {
+    uint64_t etat = graine;
+
+    partie->graine = graine;
+    memcpy(partie->lesPommesX, lesPommesX, sizeof(partie->lesPommesX));
+    memcpy(partie->lesPommesY, lesPommesY, sizeof(partie->lesPommesY));
+    memcpy(partie->lesPavesX, lesPavesX, sizeof(partie->lesPavesX));
+    memcpy(partie->lesPavesY, lesPavesY, sizeof(partie->lesPavesY));
+
+    // Mélange de Fisher-Yates de l'ordre des pommes : la même graine donne toujours la même partie.
+    for (int i = NB_POMMES - 1; (graine != 0) && (i > 0); i--)
+    {
+        int j = (int)(aleatoireSuivant(&etat) % (uint64_t)(i + 1));
+        int x = partie->lesPommesX[i];
+        int y = partie->lesPommesY[i];
+        partie->lesPommesX[i] = partie->lesPommesX[j];
+        partie->lesPommesY[i] = partie->lesPommesY[j];
+        partie->lesPommesX[j] = x;
+        partie->lesPommesY[j] = y;
+    }
+    partie->alea = etat; // Le même générateur tire ensuite les pommes aléatoires.
+
+    // Remise à zéro des compteurs
+    partie->nbPommesMangees = 0;
+    partie->nbVivants = nbSerpents;
+    partie->nbTours = 0;
+    partie->collision = false;
+    partie->gagne = false;
+    memset(POMMES_SERPENTS(partie), 0, sizeof(int) * nbSerpents);
+    memset(PAS_SERPENTS(partie), 0, sizeof(int) * nbSerpents);
+
+    // Mise en place du plateau, des serpents puis de la première pomme
+    initPlateau(partie);  // Initialisation du plateau de jeu.
+    memset(OCCUPATION(partie), 0, nbCasesMemoire);
+    memset(TETE_SUR(partie), 0, sizeof(int) * nbCasesMemoire);
+    if (!placerSerpents(partie))
+    {
+        return false;
+    }
+    initCasesLibres(partie);
+    ajouterPomme(partie);  // Ajoute une pomme sur le plateau.
+    partie->zobrist = zobristPartie(partie);
+    return true;
+}
+
+
+bool placerSerpents(tPartie *partie) {
+    // Les deux premiers serpents gardent leur place d'origine : le serpent 1 a ses anneaux à gauche de la tête
+    // et part vers la droite, le serpent 2 l'inverse. Les suivants sont rangés une ligne sur deux, par tronçons
+    // libres de TAILLE cases, en alternant les deux sens.
+    int s = 0;
+
+    initSerpent(partie, s++, echelleX(X_DEPART_SERPENT), echelleY(Y_DEPART_SERPENT), 1);
+    if (nbSerpents > 1)
+    {
+        initSerpent(partie, s++, echelleX(X_DEPART_SERPENT_2), echelleY(Y_DEPART_SERPENT_2), -1);
+    }
+    for (int y = 3; (y < hauteurPlateau - 1) && (s < nbSerpents); y += 2)
+    {
+        for (int x = 3; (x + TAILLE < largeurPlateau - 1) && (s < nbSerpents); x += TAILLE + 1)
+        {
+            if (tronconLibre(partie, x, y))
+            {
+                int sens = (s % 2 == 0) ? 1 : -1;
+                initSerpent(partie, s++, (sens > 0) ? x + TAILLE - 1 : x, y, sens);
+            }
+        }
+    }
+    return s == nbSerpents;
+}
+
+
+bool tronconLibre(const tPartie *partie, int x, int y) {
+    for (int i = 0; i < TAILLE; i++)
+    {
+        int c = CASE(x + i, y);
+        if ((PLATEAU(partie)[c] != VIDE) || estSurUnSerpent(partie, c))
+        {
+            return false;
+        }
+        for (int k = 0; k < NB_POMMES; k++)
+        {
+            if ((partie->lesPommesX[k] == x + i) && (partie->lesPommesY[k] == y))
+            {
+                return false; // Une pomme apparaîtra ici.
+            }
+        }
+    }
+    return true;
+}
+
+
+void jouerTour(tPartie *partie) {
+    // Tour en deux temps : tous les serpents décident d'après le même état (celui du tour précédent,
+    // qui ne change pas pendant les décisions), puis toutes les décisions sont appliquées ensemble.
+    // Le résultat ne dépend donc pas de l'ordre des serpents, et les décisions peuvent se prendre en parallèle.
+    int caseCible = CASE(partie->lesPommesX[partie->nbPommesMangees], partie->lesPommesY[partie->nbPommesMangees]); // Pomme à atteindre.
+
+    DEBUT_PHASE(PHASE_DECISION);
+    deciderSerpents(partie, caseCible);
+    FIN_PHASE(PHASE_DECISION);
+
+    if (journal.fd >= 0)
+    {
+        noterCoups(partie); // Les décisions suffisent à rejouer le tour.
+    }
+    DEBUT_PHASE(PHASE_PROGRESSION);
+    appliquerTour(partie);
+    FIN_PHASE(PHASE_PROGRESSION);
+}
+
+
+void appliquerTour(tPartie *partie) {
+    const bool *vivants = VIVANTS(partie);
+    int nbVivantsAvant = partie->nbVivants;
+
+    int mangeur = progresser(partie); // Serpent qui a mangé la pomme pendant ce tour.
+    bool morts = (partie->nbVivants < nbVivantsAvant); // Vrai si un serpent est sorti du jeu pendant ce tour.
+
+    if (mangeur >= 0) // Ajoute une pomme au compteur de pommes quand elle est mangée et arrête le jeu si le score atteint 10.
+    {
+        partie->zobrist ^= cleZobrist(CLE_POMMES, mangeur, POMMES_SERPENTS(partie)[mangeur])
+                           ^ cleZobrist(CLE_POMMES, mangeur, POMMES_SERPENTS(partie)[mangeur] + 1) ^ clePommeEnJeu(partie);
+        POMMES_SERPENTS(partie)[mangeur]++;
+        partie->nbPommesMangees++;
+        grandirSerpent(partie, mangeur, CROISSANCE);
+        partie->gagne = (partie->nbPommesMangees == NB_POMMES); // Vérifie si toutes les pommes ont été mangées.
+        if (!partie->gagne)
+        {
+            ajouterPomme(partie); // Ajoute une nouvelle pomme sur le plateau.
+        }
+        partie->zobrist ^= clePommeEnJeu(partie);
+    }
+
+    // Les serpents sortis du jeu libèrent leurs cases, sauf au dernier tour (le plateau final reste affiché tel quel).
+    if (morts && !partieTerminee(partie))
+    {
+        for (int s = 0; s < nbSerpents; s++)
+        {
+            if (!vivants[s] && (LONGUEURS(partie)[s] > 0))
+            {
+                retirerSerpent(partie, s);
+            }
+        }
+    }
+
+    partie->nbTours++;
+}
+
+
+char deciderDirection(const tPartie *partie, int s, int caseCible) {
+    if (estSerpentMcts(s) && !enRecherche)
+    {
+        return directionMcts(partie, s);
+    }
+    if (estSerpentAlphaBeta(s) && !enRecherche)
+    {
+        return directionAlphaBeta(partie, s);
+    }
+    return directionAutomatique(partie, s, caseCible);
+}
+
+
+char directionAutomatique(const tPartie *partie, int s, int caseCible) {
+    char direction;
+
+    if (heuristiqueManhattan)
+    {
+        // Le serpent 1 règle d'abord sa hauteur, le serpent 2 d'abord sa colonne, et ainsi de suite.
+        direction = directionHeuristique(partie, s, DIRECTIONS(partie)[s], (s % 2 == 0), 1 + 6 * s);
+    }
+    else
+    {
+        direction = directionPlusCourtChemin(partie, s, caseCible, DIRECTIONS(partie)[s]);
+    }
+    direction = trouverDirectionSure(partie, s, direction); // Évite les collisions visibles au tour précédent.
+    return cederPassage(partie, s, direction);
+}
+
+
+bool caseDisputee(const tPartie *partie, int s, int c) {
+    // Les trous sont appariés : si une tête atteint c en un pas, c atteint cette tête en un pas dans l'autre sens.
+    for (int d = 0; d < 4; d++)
+    {
+        int t = TETE_SUR(partie)[caseVoisine(PLATEAU(partie), c, d)];
+        if ((t > 0) && (t - 1 < s))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+char cederPassage(const tPartie *partie, int s, char direction) {
+    // Priorité au plus petit numéro : un serpent évite la case qu'un serpent prioritaire peut atteindre au même tour,
+    // s'il lui reste une autre direction sûre. La règle ne dépend que de l'état du tour précédent.
+    const char lesDirections[4] = {GAUCHE, DROITE, HAUT, BAS}; // Même ordre que trouverDirectionSure.
+    int tete = caseAnneau(partie, s, 0);
+
+    if (!caseDisputee(partie, s, caseVoisine(PLATEAU(partie), tete, codeDirection(direction))))
+    {
+        return direction;
+    }
+    for (int i = 0; i < 4; i++)
+    {
+        int v = caseVoisine(PLATEAU(partie), tete, codeDirection(lesDirections[i]));
+        if (directionEstSure(partie, tete, lesDirections[i]) && !caseDisputee(partie, s, v))
+        {
+            return lesDirections[i];
+        }
+    }
+    return direction; // Aucune autre direction : le face-à-face est tranché par progresser().
+}
+
+
+bool partieTerminee(const tPartie *partie) {
+    // Avec plusieurs serpents, la partie s'arrête quand il n'en reste qu'un : à deux, dès la première collision.
+    int minimumVivants = (nbSerpents > 1) ? 2 : 1;
+    return partie->gagne || (partie->nbVivants < minimumVivants);
+}
+
+
+tResultatPartie jouerPartie(tPartie *partie, bool interactif) {
+    // Représente la touche frappée par l'utilisateur : touche de direction ou pour l'arrêt
+    char touche = '\0';
+
+    if (journal.fd >= 0)
+    {
+        commencerJournal();
+    }
+
+    if (interactif)
+    {
+        initEcran();  // Effacement de l'écran.
+        dessinerPlateau(PLATEAU(partie));  // Dessine le plateau à l'écran.
+        for (int s = 0; s < nbSerpents; s++)
+        {
+            dessinerSerpent(partie, s);  // Dessine le serpent au début.
+        }
+        rafraichirEcran();  // Première image : plateau, pomme et serpents.
+        disable_echo();  // Désactive l'affichage des touches.
+        demarrerOrdonnanceur(&ordonnanceur);
+    }
+
+    // Boucle de jeu. Le jeu continue tant que l'utilisateur n'appuie pas sur la touche STOP ou qu'il n'y a pas de collision ou que toutes les pommes ne sont pas mangées.
+    do {
+        jouerTour(partie);
+
+        if (interactif)
+        {
+            DEBUT_PHASE(PHASE_AFFICHAGE);
+            for (int s = 0; (s < nbSerpents) && (13 + s < NB_LIGNES_PANNEAU); s++)
+            {
+                ecrireTexte(2+largeurPlateau, 13 + s, "Nombre de pommes mangée Serpent %d : %d", s + 1, POMMES_SERPENTS(partie)[s]);
+            }
+            if (!ordonnanceur.enRetard || partieTerminee(partie))
+            {
+                rafraichirEcran();  // Une seule écriture dans le terminal pour tout le tour.
+            }
+            else
+            {
+                ordonnanceur.nbImagesSautees++; // Les cases restent marquées : la prochaine image les affichera.
+            }
+            FIN_PHASE(PHASE_AFFICHAGE);
+
+            if (!partieTerminee(partie)) // Continue à faire avancer le serpent si le jeu n'est pas terminé.
+            {
+                DEBUT_PHASE(PHASE_ATTENTE);
+                attendreProchainTour(&ordonnanceur);  // Attend l'échéance du prochain tour.
+                FIN_PHASE(PHASE_ATTENTE);
+                DEBUT_PHASE(PHASE_ENTREE);
+                if (kbhit() == 1)  // Si une touche a été pressée.
+                {
+                    touche = getchar();  // Lit la touche pressée.
                 }
+                FIN_PHASE(PHASE_ENTREE);
+            }
+        }
+	} while ( (touche != STOP) && !partieTerminee(partie) && (interactif || partie->nbTours < limiteTours)); // La boucle continue tant que l'utilisateur n'appuie pas sur STOP, qu'il n'y a pas de collision et que toutes les pommes ne sont pas mangées.
+
+    if (interactif)
+    {
+        enable_echo(); // Réactive l'affichage des touches.
+    }
+    if (journal.fd >= 0)
+    {
+        terminerJournal(partie);
+    }
+
+    // Le résultat retient les deux premiers serpents (le second compte zéro s'il est seul).
+    bool deux = (nbSerpents > 1);
+    tResultatPartie resultat = {partie->graine, partie->nbTours, POMMES_SERPENTS(partie)[0], deux ? POMMES_SERPENTS(partie)[1] : 0,
+                                PAS_SERPENTS(partie)[0], deux ? PAS_SERPENTS(partie)[1] : 0,
+                                partie->gagne, partie->collision};
+    return resultat;
+}
+
+
+void simulerParties(long nbParties, unsigned long graine) {
+    long nbToursTotal = 0; // Nombre de tours joués sur l'ensemble des parties.
+    long nbGagnees = 0; // Nombre de parties où toutes les pommes ont été mangées.
+    long nbCollisions = 0; // Nombre de parties non gagnées terminées par une collision.
+    long nbLimites = 0; // Nombre de parties arrêtées par la limite de tours.
+    long pasSerpent1 = 0; // Nombre total de déplacements du serpent 1.
+    long pasSerpent2 = 0; // Nombre total de déplacements du serpent 2.
+    struct timespec debut, fin;
+    tPartie *partie = nouvellePartie();
+
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    for (long p = 0; p < nbParties; p++)
+    {
+        initPartie(partie, graine + p); // Comme au tournoi : chaque partie a sa graine, la graine 0 rejoue la partie d'origine.
+        tResultatPartie resultat = jouerPartie(partie, false);
+        nbToursTotal += resultat.nbTours;
+        // Une seule issue par partie : une partie gagnée a pu perdre des serpents, elle ne compte pas en collision.
+        nbGagnees += resultat.gagne;
+        nbCollisions += !resultat.gagne && resultat.collision;
+        nbLimites += !resultat.gagne && !resultat.collision;
+        pasSerpent1 += resultat.nbPas1;
+        pasSerpent2 += resultat.nbPas2;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &fin);
+    free(partie);
+
+    double duree = tempsEcoule(debut, fin);
+    printf("Parties simulées : %ld (gagnées : %ld, perdues sur collision : %ld, limite de %d tours : %ld)\n",
+           nbParties, nbGagnees, nbCollisions, limiteTours, nbLimites);
+    printf("Pas moyens : serpent 1 = %.1f, serpent 2 = %.1f\n",
+           (double)pasSerpent1 / nbParties, (double)pasSerpent2 / nbParties);
+    printf("Durée : %.3f s, %.2f µs par partie, %.0f tours par seconde\n",
+           duree, duree * 1e6 / nbParties, (duree > 0) ? nbToursTotal / duree : 0.0);
+}
+
+
+/************************************************/
+/*		DÉCISIONS SUR PLUSIEURS FILS     		*/
+/************************************************/
+
+void deciderSerpents(tPartie *partie, int caseCible) {
+    // Peu de serpents : le passage des barrières coûterait plus que les décisions.
+    // Le panneau de l'heuristique s'écrit dans l'écran commun : ses décisions restent sur le fil principal.
+    if (champActif && !enRecherche)
+    {
+        distancesVers(&champPartage, PLATEAU(partie), caseCible); // Une fois par pomme, avant que les fils ne le lisent.
+    }
+    if ((equipe.nbFils == 1) || (partie->nbVivants < SEUIL_PARALLELE) || (affichageActif && heuristiqueManhattan))
+    {
+        for (int s = 0; s < nbSerpents; s++)
+        {
+            if (VIVANTS(partie)[s])
+            {
+                DECISIONS(partie)[s] = deciderDirection(partie, s, caseCible);
+            }
+        }
+        return;
+    }
+
+    equipe.partie = partie;
+    equipe.caseCible = caseCible;
+    equipe.prochainSerpent = 0;
+    equipe.travail = deciderLots;
+    equipe.occupee = true;
+    pthread_barrier_wait(&equipe.depart); // Publie la partie : les écritures ci-dessus sont visibles des autres fils.
+    deciderLots(); // Le fil principal décide aussi.
+    pthread_barrier_wait(&equipe.arrivee);
+    equipe.occupee = false;
+}
+
+
+void deciderLots(void) {
+    tPartie *partie = equipe.partie;
+    char *decisions = DECISIONS(partie); // Seul tableau écrit pendant les décisions : une case par serpent.
+
+    for (;;)
+    {
+        int debut = __atomic_fetch_add(&equipe.prochainSerpent, LOT_DECISIONS, __ATOMIC_RELAXED);
+        if (debut >= nbSerpents)
+        {
+            return;
+        }
+        int fin = (debut + LOT_DECISIONS < nbSerpents) ? debut + LOT_DECISIONS : nbSerpents;
+        for (int s = debut; s < fin; s++)
+        {
+            if (VIVANTS(partie)[s])
+            {
+                decisions[s] = deciderDirection(partie, s, equipe.caseCible);
             }
-		}
+        }
+    }
+}
+
+
+void *filDecision(void *argument) {
+    rangFil = (int)(intptr_t)argument;
+    for (;;)
+    {
+        pthread_barrier_wait(&equipe.depart);
+        if (equipe.arret)
+        {
+            return NULL;
+        }
+        equipe.travail();
+        pthread_barrier_wait(&equipe.arrivee);
+    }
+}
+
+
+void lancerEquipe(int nbFils) {
+    if ((pthread_barrier_init(&equipe.depart, NULL, nbFils) != 0) || (pthread_barrier_init(&equipe.arrivee, NULL, nbFils) != 0))
+    {
+        perror("pthread_barrier_init");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < nbFils - 1; i++)
+    {
+        int erreur = pthread_create(&equipe.lesFils[i], NULL, filDecision, (void *)(intptr_t)(i + 1));
+        if (erreur != 0)
+        {
+            fprintf(stderr, "pthread_create : %s\n", strerror(erreur)); // Les barrières attendent nbFils fils : impossible de continuer avec moins.
+            exit(EXIT_FAILURE);
+        }
+    }
+    equipe.nbFils = nbFils;
+}
+
+
+void arreterEquipe(void) {
+    if (equipe.nbFils == 1)
+    {
+        return;
+    }
+    equipe.arret = true;
+    pthread_barrier_wait(&equipe.depart); // Les fils voient arret et s'arrêtent sans franchir l'arrivée.
+    for (int i = 0; i < equipe.nbFils - 1; i++)
+    {
+        pthread_join(equipe.lesFils[i], NULL);
+    }
+    pthread_barrier_destroy(&equipe.depart);
+    pthread_barrier_destroy(&equipe.arrivee);
+    equipe.nbFils = 1;
+}
+
+
+/************************************************/
+/*		INSTANTANÉS ET ANNULATION        		*/
+/************************************************/
+
+size_t tailleInstantane(void) {
+    return sizeof(tInstantane) + (disposition.taille - disposition.anneaux);
+}
+
+
+tInstantane *nouvelInstantane(void) {
+    tInstantane *instantane = aligned_alloc(ALIGNEMENT_CASES, tailleInstantane());
+
+    if (instantane == NULL)
+    {
+        perror("aligned_alloc");
+        exit(EXIT_FAILURE);
+    }
+    return instantane;
+}
+
+
+void prendreInstantane(tInstantane *instantane, const tPartie *partie) {
+    instantane->nbPommesMangees = partie->nbPommesMangees;
+    instantane->nbVivants = partie->nbVivants;
+    instantane->nbTours = partie->nbTours;
+    instantane->collision = partie->collision;
+    instantane->gagne = partie->gagne;
+    instantane->zobrist = partie->zobrist;
+    instantane->alea = partie->alea;
+    memcpy(instantane->serpents, partie->cases + disposition.anneaux, disposition.taille - disposition.anneaux);
+}
+
+
+void poserCorps(tPartie *partie, int s, int sens) {
+    for (int i = 0; i < LONGUEURS(partie)[s]; i++)
+    {
+        if (sens > 0)
+        {
+            occuperCase(partie, caseAnneau(partie, s, i));
+        }
+        else
+        {
+            libererCase(partie, caseAnneau(partie, s, i));
+        }
+    }
+    int tete = caseAnneau(partie, s, 0);
+    if (sens > 0)
+    {
+        TETE_SUR(partie)[tete] = s + 1;
+    }
+    else if (TETE_SUR(partie)[tete] == s + 1)
+    {
+        TETE_SUR(partie)[tete] = 0;
+    }
+}
+
+
+void restaurerInstantane(tPartie *partie, const tInstantane *instantane) {
+    // Le plateau fixe ne change pas : seule la pomme en jeu est déplacée. Occupation et têtes se déduisent
+    // des corps : ceux de la partie sont retirés, puis ceux de l'instantané posés, sans parcourir le plateau.
+    tPlateau plateau = PLATEAU(partie);
+
+    for (int s = 0; s < nbSerpents; s++)
+    {
+        if (LONGUEURS(partie)[s] > 0)
+        {
+            poserCorps(partie, s, -1);
+        }
+    }
+    if (!partie->gagne)
+    {
+        plateau[CASE(partie->lesPommesX[partie->nbPommesMangees], partie->lesPommesY[partie->nbPommesMangees])] = VIDE;
+    }
+
+    partie->nbPommesMangees = instantane->nbPommesMangees;
+    partie->nbVivants = instantane->nbVivants;
+    partie->nbTours = instantane->nbTours;
+    partie->collision = instantane->collision;
+    partie->gagne = instantane->gagne;
+    partie->zobrist = instantane->zobrist;
+    partie->alea = instantane->alea;
+    memcpy(partie->cases + disposition.anneaux, instantane->serpents, disposition.taille - disposition.anneaux);
+
+    if (!partie->gagne)
+    {
+        plateau[CASE(partie->lesPommesX[partie->nbPommesMangees], partie->lesPommesY[partie->nbPommesMangees])] = POMME;
+    }
+    for (int s = 0; s < nbSerpents; s++)
+    {
+        if (LONGUEURS(partie)[s] > 0)
+        {
+            poserCorps(partie, s, 1);
+        }
+    }
+}
+
+
+void marquerTour(tPileAnnulation *pile, const tPartie *partie) {
+    if (pile->nbTours == pile->capaciteTours)
+    {
+        pile->capaciteTours = (pile->capaciteTours > 0) ? 2 * pile->capaciteTours : 64;
+        pile->lesTours = realloc(pile->lesTours, sizeof(tAnnulationTour) * pile->capaciteTours);
+    }
+    if (pile->nbSerpents + partie->nbVivants > pile->capaciteSerpents)
+    {
+        pile->capaciteSerpents = (pile->capaciteSerpents > 0) ? 2 * pile->capaciteSerpents : 256;
+        while (pile->nbSerpents + partie->nbVivants > pile->capaciteSerpents)
+        {
+            pile->capaciteSerpents *= 2;
+        }
+        pile->lesSerpents = realloc(pile->lesSerpents, sizeof(tAnnulationSerpent) * pile->capaciteSerpents);
+    }
+    if ((pile->lesTours == NULL) || (pile->lesSerpents == NULL))
+    {
+        perror("realloc");
+        exit(EXIT_FAILURE);
+    }
+
+    tAnnulationTour *tour = &pile->lesTours[pile->nbTours++];
+    tour->nbPommesMangees = partie->nbPommesMangees;
+    tour->nbVivants = partie->nbVivants;
+    tour->nbTours = partie->nbTours;
+    tour->collision = partie->collision;
+    tour->gagne = partie->gagne;
+    tour->zobrist = partie->zobrist;
+    tour->alea = partie->alea;
+    tour->premierSerpent = pile->nbSerpents;
+
+    // Seuls les serpents en jeu changent pendant le tour.
+    for (int s = 0; s < nbSerpents; s++)
+    {
+        if (!VIVANTS(partie)[s])
+        {
+            continue;
+        }
+        tAnnulationSerpent *serpent = &pile->lesSerpents[pile->nbSerpents++];
+        serpent->s = s;
+        serpent->tete = TETES(partie)[s];
+        serpent->longueur = LONGUEURS(partie)[s];
+        serpent->aGrandir = A_GRANDIR(partie)[s];
+        serpent->pommes = POMMES_SERPENTS(partie)[s];
+        serpent->pas = PAS_SERPENTS(partie)[s];
+        serpent->direction = DIRECTIONS(partie)[s];
+        serpent->caseEcrasee = ANNEAUX(partie)[s * TAILLE_MAX + ((TETES(partie)[s] + 1) & (TAILLE_MAX - 1))]; // Reçoit la prochaine tête.
+        serpent->queueLiberee = !((A_GRANDIR(partie)[s] > 0) && (LONGUEURS(partie)[s] < TAILLE_MAX)); // Même test que avancerQueue.
+    }
+}
+
+
+void annulerTour(tPileAnnulation *pile, tPartie *partie) {
+    const tAnnulationTour *tour = &pile->lesTours[--pile->nbTours];
+    tPlateau plateau = PLATEAU(partie);
+
+    // 1. Les nouvelles têtes quittent l'occupation (un serpent retiré du plateau n'y est plus du tout).
+    for (int k = tour->premierSerpent; k < pile->nbSerpents; k++)
+    {
+        int s = pile->lesSerpents[k].s;
+        if (LONGUEURS(partie)[s] > 0)
+        {
+            int tete = caseAnneau(partie, s, 0);
+            libererCase(partie, tete);
+            if (TETE_SUR(partie)[tete] == s + 1)
+            {
+                TETE_SUR(partie)[tete] = 0;
+            }
+        }
+    }
+
+    // 2. Chaque serpent retrouve son état d'avant le tour, puis sa queue (ou son corps entier s'il avait été retiré).
+    for (int k = tour->premierSerpent; k < pile->nbSerpents; k++)
+    {
+        const tAnnulationSerpent *serpent = &pile->lesSerpents[k];
+        int s = serpent->s;
+        bool retire = (LONGUEURS(partie)[s] == 0);
+
+        ANNEAUX(partie)[s * TAILLE_MAX + ((serpent->tete + 1) & (TAILLE_MAX - 1))] = serpent->caseEcrasee;
+        TETES(partie)[s] = serpent->tete;
+        LONGUEURS(partie)[s] = serpent->longueur;
+        A_GRANDIR(partie)[s] = serpent->aGrandir;
+        POMMES_SERPENTS(partie)[s] = serpent->pommes;
+        PAS_SERPENTS(partie)[s] = serpent->pas;
+        DIRECTIONS(partie)[s] = serpent->direction;
+        VIVANTS(partie)[s] = true;
+        if (retire)
+        {
+            poserCorps(partie, s, 1);
+        }
+        else
+        {
+            if (serpent->queueLiberee)
+            {
+                occuperCase(partie, caseAnneau(partie, s, serpent->longueur - 1));
+            }
+            TETE_SUR(partie)[caseAnneau(partie, s, 0)] = s + 1;
+        }
+    }
+    pile->nbSerpents = tour->premierSerpent;
+
+    // 3. Pomme et compteurs de la partie
+    if (partie->nbPommesMangees != tour->nbPommesMangees)
+    {
+        if (!partie->gagne)
+        {
+            plateau[CASE(partie->lesPommesX[partie->nbPommesMangees], partie->lesPommesY[partie->nbPommesMangees])] = VIDE;
+        }
+        plateau[CASE(partie->lesPommesX[tour->nbPommesMangees], partie->lesPommesY[tour->nbPommesMangees])] = POMME;
+    }
+    partie->nbPommesMangees = tour->nbPommesMangees;
+    partie->nbVivants = tour->nbVivants;
+    partie->nbTours = tour->nbTours;
+    partie->collision = tour->collision;
+    partie->gagne = tour->gagne;
+    partie->zobrist = tour->zobrist;
+    partie->alea = tour->alea;
+}
+
+
+void libererPileAnnulation(tPileAnnulation *pile) {
+    free(pile->lesTours);
+    free(pile->lesSerpents);
+    memset(pile, 0, sizeof(*pile));
+}
+
+
+bool etatsEgaux(const tPartie *partie, const tPartie *copie) {
+    // Avec les pommes fixes, octet pour octet. Avec les pommes aléatoires, les cases libres peuvent revenir dans un
+    // autre ordre, et la pomme suivante tirée pendant le tour annulé reste écrite dans le calendrier : on compare
+    // l'état de jeu, puis on vérifie que la liste contient exactement les cases jouables sans anneau.
+    if (sourcePommes == POMMES_FIXES)
+    {
+        return memcmp(partie, copie, taillePartie()) == 0;
+    }
+    if ((empreintePartie(partie) != empreintePartie(copie)) || (partie->zobrist != copie->zobrist) || (partie->alea != copie->alea)
+        || (partie->nbCasesLibres != copie->nbCasesLibres))
+    {
+        return false;
+    }
+    const int *casesLibres = CASES_LIBRES(partie);
+    const int *rangLibre = RANG_LIBRE(partie);
+    int nbLibres = 0;
+    for (int c = 0; c < nbCasesMemoire; c++)
+    {
+        bool libre = ((PLATEAU(partie)[c] == VIDE) || (PLATEAU(partie)[c] == POMME)) && (OCCUPATION(partie)[c] == 0);
+        if (libre != (rangLibre[c] >= 0))
+        {
+            return false;
+        }
+        if (libre && ((rangLibre[c] >= partie->nbCasesLibres) || (casesLibres[rangLibre[c]] != c)))
+        {
+            return false;
+        }
+        nbLibres += libre;
+    }
+    return nbLibres == partie->nbCasesLibres;
+}
+
+
+void mesurerInstantanes(long nbParties) {
+    // Chaque tour de chaque partie est joué, annulé, rejoué puis restauré depuis un instantané : la partie
+    // doit revenir à chaque fois, octet pour octet, à la copie prise avant le tour. Ces vérifications ne sont pas
+    // chronométrées : les durées viennent ensuite de blocs de NB_BLOC_INSTANTANES opérations sur l'état du tour,
+    // dont on déduit une seule fois le coût des deux lectures de l'horloge.
+    tPartie *partie = nouvellePartie();
+    tPartie *copie = nouvellePartie();
+    tInstantane *instantane = nouvelInstantane();
+    tInstantane *apres = nouvelInstantane(); // État après le tour : les restaurations du bloc alternent entre les deux.
+    tPileAnnulation pile = {0};
+    long nbToursTotal = 0, nbErreurs = 0, nbBlocs = 0;
+    double dureeInstantanes = 0, dureeRestaurations = 0, dureeCopies = 0, dureeAnnulations = 0;
+    double surcout = coutHorloge() / NANO_PAR_SECONDE;
+    struct timespec debut, fin;
+
+    for (long p = 0; p < nbParties; p++)
+    {
+        initPartie(partie, (unsigned long)p + 1);
+        while (!partieTerminee(partie) && (partie->nbTours < limiteTours))
+        {
+            int caseCible = CASE(partie->lesPommesX[partie->nbPommesMangees], partie->lesPommesY[partie->nbPommesMangees]);
+            deciderSerpents(partie, caseCible);
+
+            // Vérifications : annulation incrémentale, puis restauration complète depuis l'instantané
+            prendreInstantane(instantane, partie);
+            copierPartie(copie, partie);
+            marquerTour(&pile, partie);
+            appliquerTour(partie);
+            annulerTour(&pile, partie);
+            nbErreurs += !etatsEgaux(partie, copie);
+            appliquerTour(partie);
+            prendreInstantane(apres, partie);
+            restaurerInstantane(partie, instantane);
+            nbErreurs += !etatsEgaux(partie, copie);
+
+            // Mesures par blocs sur l'état du tour
+            clock_gettime(CLOCK_MONOTONIC, &debut);
+            for (int k = 0; k < NB_BLOC_INSTANTANES; k++)
+            {
+                prendreInstantane(instantane, partie);
+            }
+            clock_gettime(CLOCK_MONOTONIC, &fin);
+            dureeInstantanes += tempsEcoule(debut, fin) - surcout;
+
+            clock_gettime(CLOCK_MONOTONIC, &debut);
+            for (int k = 0; k < NB_BLOC_INSTANTANES; k++)
+            {
+                copierPartie(copie, partie);
+            }
+            clock_gettime(CLOCK_MONOTONIC, &fin);
+            dureeCopies += tempsEcoule(debut, fin) - surcout;
+
+            clock_gettime(CLOCK_MONOTONIC, &debut);
+            for (int k = 0; k < NB_BLOC_INSTANTANES; k++)
+            {
+                marquerTour(&pile, partie);
+                appliquerTour(partie);
+                annulerTour(&pile, partie);
+            }
+            clock_gettime(CLOCK_MONOTONIC, &fin);
+            dureeAnnulations += tempsEcoule(debut, fin) - surcout;
+
+            // NB_BLOC_INSTANTANES est pair : la dernière restauration ramène la partie à l'état d'avant le tour.
+            clock_gettime(CLOCK_MONOTONIC, &debut);
+            for (int k = 0; k < NB_BLOC_INSTANTANES; k++)
+            {
+                restaurerInstantane(partie, (k % 2 == 0) ? apres : instantane);
+            }
+            clock_gettime(CLOCK_MONOTONIC, &fin);
+            dureeRestaurations += tempsEcoule(debut, fin) - surcout;
+            nbBlocs++;
+            nbErreurs += !etatsEgaux(partie, copie);
+
+            appliquerTour(partie); // Le tour pour de bon.
+            nbErreurs += (partie->zobrist != zobristPartie(partie)); // Hachage tenu à jour = hachage recalculé.
+            nbToursTotal++;
+        }
+    }
+    free(partie);
+    free(copie);
+    free(instantane);
+    free(apres);
+    libererPileAnnulation(&pile);
+
+    double nbOperations = (double)nbBlocs * NB_BLOC_INSTANTANES;
+    printf("Parties : %ld, tours : %ld, états ou hachages différents après annulation ou restauration : %ld\n", nbParties, nbToursTotal, nbErreurs);
+    printf("Instantané : %zu octets (partie complète : %zu octets)\n", tailleInstantane(), taillePartie());
+    printf("Durées par blocs de %d opérations, horloge (%.1f ns) déduite une fois par bloc\n", NB_BLOC_INSTANTANES, surcout * NANO_PAR_SECONDE);
+    printf("Prise d'instantané : %8.1f ns (%.0f par seconde)\n", dureeInstantanes * NANO_PAR_SECONDE / nbOperations, nbOperations / dureeInstantanes);
+    printf("Restauration       : %8.1f ns (%.0f par seconde)\n", dureeRestaurations * NANO_PAR_SECONDE / nbOperations, nbOperations / dureeRestaurations);
+    printf("Copie de la partie : %8.1f ns (%.0f par seconde)\n", dureeCopies * NANO_PAR_SECONDE / nbOperations, nbOperations / dureeCopies);
+    printf("Marque + tour + annulation : %8.1f ns\n", dureeAnnulations * NANO_PAR_SECONDE / nbOperations);
+}
+
+
+/************************************************/
+/*		MESURE DES FONCTIONS DE CHAQUE TOUR		*/
+/************************************************/
+
+int releverEtats(tInstantane **lesEtats, unsigned long *lesGraines) {
+    // États pris tous les PAS_RELEVE_MICRO tours de parties ordinaires, en NB_LONGUEURS_MICRO classes : dans la
+    // classe k, chaque serpent grandit de k * (TAILLE_MAX - TAILLE) / NB_LONGUEURS_MICRO anneaux dès le départ.
+    // L'ordre des pommes ne fait pas partie d'un instantané : la graine de la partie est gardée avec chaque état.
+    tPartie *partie = nouvellePartie();
+    int nbEtats = 0;
+    unsigned long graine = 1;
+
+    for (int k = 0; k < NB_LONGUEURS_MICRO; k++)
+    {
+        int objectif = (k + 1) * NB_ETATS_MICRO / NB_LONGUEURS_MICRO;
+        for (int essai = 0; (essai < NB_ETATS_MICRO) && (nbEtats < objectif); essai++)
+        {
+            initPartie(partie, graine++);
+            for (int s = 0; s < nbSerpents; s++)
+            {
+                grandirSerpent(partie, s, k * (TAILLE_MAX - TAILLE) / NB_LONGUEURS_MICRO);
+            }
+            while (!partieTerminee(partie) && (partie->nbTours < limiteTours) && (nbEtats < objectif))
+            {
+                jouerTour(partie);
+                if (!partieTerminee(partie) && (partie->nbTours % PAS_RELEVE_MICRO == 0))
+                {
+                    lesGraines[nbEtats] = partie->graine;
+                    prendreInstantane(lesEtats[nbEtats++], partie);
+                }
+            }
+        }
+    }
+    free(partie);
+    return nbEtats;
+}
+
+
+double coutHorloge(void) {
+    // Deux lectures de l'horloge encadrent chaque mesure : leur coût, mesuré à vide, est déduit des durées.
+    struct timespec debut, fin, inutile;
+
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    for (int i = 0; i < NB_MESURES_HORLOGE; i++)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &inutile);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &fin);
+    return tempsEcoule(debut, fin) * NANO_PAR_SECONDE / NB_MESURES_HORLOGE;
+}
+
+
+void noterMesure(FILE *detail, const char *fonction, const double *echantillons, long nbEchantillons) {
+    double somme = 0, minimum = echantillons[0];
+    for (long e = 0; e < nbEchantillons; e++)
+    {
+        somme += echantillons[e];
+        minimum = (echantillons[e] < minimum) ? echantillons[e] : minimum;
+    }
+    double moyenne = somme / nbEchantillons;
+    double ecarts = 0;
+    for (long e = 0; e < nbEchantillons; e++)
+    {
+        ecarts += (echantillons[e] - moyenne) * (echantillons[e] - moyenne);
+    }
+    // Demi-largeur de l'intervalle de confiance à 95 % de la moyenne (échantillons supposés indépendants).
+    double demiIntervalle = (nbEchantillons > 1) ? Z_95 * sqrt(ecarts / (nbEchantillons - 1) / nbEchantillons) : 0;
+
+    printf("%-22s %10.2f ± %-8.2f %10.2f\n", fonction, moyenne, demiIntervalle, minimum);
+    if (detail != NULL)
+    {
+        fprintf(detail, "%s,%d,%d,%d,%ld,%.3f,%.3f,%.3f\n", fonction, nbSerpents, largeurPlateau, hauteurPlateau,
+                nbEchantillons, moyenne, demiIntervalle, minimum);
+    }
+}
+
+
+bool mesurerFonctions(long nbEchantillons, const char *nomDetail) {
+    // Chaque échantillon repart d'un des états relevés. Les fonctions courtes sont chronométrées par blocs de
+    // NB_APPELS_MICRO appels sur des requêtes préparées à l'avance (têtes des serpents en jeu, leurs voisines,
+    // les quatre directions), progresser par blocs d'un tour sur NB_COPIES_MICRO copies de la partie, rafraichirEcran
+    // un appel à la fois (une image entière). Le coût de l'horloge est déduit une fois par bloc.
+    // estSurCorpsSerpent et estSurCorpsAutreSerpent sont devenues estSurUnSerpent (grille d'occupation), et
+    // PasserPortails caseVoisine (case de garde devant les trous) : ce sont elles qui sont mesurées.
+    const char *lesFonctions[] = {"directionEstSure", "trouverDirectionSure", "estSurUnSerpent", "minimunTableau",
+                                  "caseVoisine", "progresser", "afficher", "rafraichirEcran"};
+    const int nbFonctions = sizeof(lesFonctions) / sizeof(lesFonctions[0]);
+    const char lesDirections[4] = {HAUT, BAS, GAUCHE, DROITE};
+    tInstantane *lesEtats[NB_ETATS_MICRO];
+    unsigned long lesGraines[NB_ETATS_MICRO]; // Graine de la partie de chaque état (ordre de ses pommes).
+    tPartie *lesCopies[NB_COPIES_MICRO]; // Copies de la partie que progresser fait avancer.
+    tPartie *partie = nouvellePartie();
+    double *echantillons = malloc(nbFonctions * nbEchantillons * sizeof(double));
+    int *lesSerpentsEnJeu = malloc(nbSerpents * sizeof(int));
+    tChemins *lesChemins = malloc(nbSerpents * sizeof(tChemins));
+    int *lesAnneauxX = malloc(nbSerpents * TAILLE_MAX * sizeof(int));
+    int *lesAnneauxY = malloc(nbSerpents * TAILLE_MAX * sizeof(int));
+    int lesRequetes[NB_APPELS_MICRO]; // Indice dans lesSerpentsEnJeu du serpent de chaque appel.
+    int lesCases[NB_APPELS_MICRO]; // Tête de ce serpent.
+    int lesVoisines[NB_APPELS_MICRO]; // Case voisine de la tête dans la direction de l'appel.
+    int lesCodes[NB_APPELS_MICRO]; // Code de la direction de l'appel.
+    struct timespec debut, fin;
+    long puits = 0; // Résultats cumulés, pour que le compilateur ne supprime aucun appel.
+    int nbEtats = 0;
+
+    // Un seul chemin de sortie : chaque étape n'a lieu que si les précédentes ont réussi, tout est libéré à la fin.
+    bool reussi = (echantillons != NULL) && (lesSerpentsEnJeu != NULL) && (lesChemins != NULL)
+                  && (lesAnneauxX != NULL) && (lesAnneauxY != NULL);
+    if (!reussi)
+    {
+        perror("malloc");
+    }
+    for (int i = 0; i < NB_ETATS_MICRO; i++)
+    {
+        lesEtats[i] = nouvelInstantane();
+    }
+    for (int k = 0; k < NB_COPIES_MICRO; k++)
+    {
+        lesCopies[k] = nouvellePartie();
+    }
+    if (reussi)
+    {
+        nbEtats = releverEtats(lesEtats, lesGraines);
+        if (nbEtats == 0)
+        {
+            fprintf(stderr, "Aucun état de partie à mesurer : les parties se terminent dès le départ\n");
+            reussi = false;
+        }
+    }
+    if (reussi)
+    {
+        sortieEcran = open("/dev/null", O_WRONLY);
+        if (sortieEcran < 0)
+        {
+            perror("/dev/null");
+            sortieEcran = STDOUT_FILENO;
+            reussi = false;
+        }
+    }
+    initPartie(partie, 1);
+    initEcran();
+    double surcout = coutHorloge();
+    int longueurMin = TAILLE_MAX, longueurMax = 0;
+
+    for (long e = 0; reussi && (e < nbEchantillons); e++)
+    {
+        // Moins d'échantillons que d'états : on en prend un sur plusieurs pour couvrir toutes les longueurs.
+        int numero = (nbEchantillons < nbEtats) ? e * nbEtats / nbEchantillons : e % nbEtats;
+        tInstantane *etat = lesEtats[numero];
+        initPartie(partie, lesGraines[numero]); // Pommes de la partie d'où vient l'état, avant de le restaurer.
+        restaurerInstantane(partie, etat);
+        tPlateau plateau = PLATEAU(partie);
+        int pommeX = partie->lesPommesX[partie->nbPommesMangees];
+        int pommeY = partie->lesPommesY[partie->nbPommesMangees];
+        int caseCible = CASE(pommeX, pommeY);
+        int nbEnJeu = 0, nbAnneaux = 0;
+
+        for (int s = 0; s < nbSerpents; s++)
+        {
+            if (!VIVANTS(partie)[s])
+            {
+                continue;
+            }
+            int xTete = X_CASE(caseAnneau(partie, s, 0));
+            int yTete = Y_CASE(caseAnneau(partie, s, 0));
+            // Les cinq distances de directionHeuristique, pour minimunTableau.
+            tChemins chemins = {abs(xTete - pommeX) + abs(yTete - pommeY),
+                                abs(xTete - TROU_HAUT.x) + abs(yTete - TROU_HAUT.y) + abs(pommeX - TROU_BAS.x) + abs(pommeY - TROU_BAS.y),
+                                abs(xTete - TROU_BAS.x) + abs(yTete - TROU_BAS.y) + abs(pommeX - TROU_HAUT.x) + abs(pommeY - TROU_HAUT.y),
+                                abs(xTete - TROU_GAUCHE.x) + abs(yTete - TROU_GAUCHE.y) + abs(pommeX - TROU_DROITE.x) + abs(pommeY - TROU_DROITE.y),
+                                abs(xTete - TROU_DROITE.x) + abs(yTete - TROU_DROITE.y) + abs(pommeX - TROU_GAUCHE.x) + abs(pommeY - TROU_GAUCHE.y)};
+            memcpy(lesChemins[nbEnJeu], chemins, sizeof(tChemins));
+            lesSerpentsEnJeu[nbEnJeu++] = s;
+            for (int i = 0; i < LONGUEURS(partie)[s]; i++)
+            {
+                lesAnneauxX[nbAnneaux] = X_CASE(caseAnneau(partie, s, i));
+                lesAnneauxY[nbAnneaux++] = Y_CASE(caseAnneau(partie, s, i));
+            }
+            longueurMin = (LONGUEURS(partie)[s] < longueurMin) ? LONGUEURS(partie)[s] : longueurMin;
+            longueurMax = (LONGUEURS(partie)[s] > longueurMax) ? LONGUEURS(partie)[s] : longueurMax;
+        }
+        for (int i = 0; i < NB_APPELS_MICRO; i++)
+        {
+            lesRequetes[i] = (i / 4) % nbEnJeu;
+            lesCodes[i] = i % 4;
+            lesCases[i] = caseAnneau(partie, lesSerpentsEnJeu[lesRequetes[i]], 0);
+            lesVoisines[i] = caseVoisine(plateau, lesCases[i], lesCodes[i]);
+        }
+
+        double *mesures = echantillons + e;
+        clock_gettime(CLOCK_MONOTONIC, &debut);
+        for (int i = 0; i < NB_APPELS_MICRO; i++)
+        {
+            puits += directionEstSure(partie, lesCases[i], lesDirections[lesCodes[i]]);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &fin);
+        mesures[0 * nbEchantillons] = (tempsEcoule(debut, fin) * NANO_PAR_SECONDE - surcout) / NB_APPELS_MICRO;
+
+        clock_gettime(CLOCK_MONOTONIC, &debut);
+        for (int i = 0; i < NB_APPELS_MICRO; i++)
+        {
+            int s = lesSerpentsEnJeu[lesRequetes[i]];
+            puits += trouverDirectionSure(partie, s, lesDirections[lesCodes[i]]);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &fin);
+        mesures[1 * nbEchantillons] = (tempsEcoule(debut, fin) * NANO_PAR_SECONDE - surcout) / NB_APPELS_MICRO;
+
+        clock_gettime(CLOCK_MONOTONIC, &debut);
+        for (int i = 0; i < NB_APPELS_MICRO; i++)
+        {
+            puits += estSurUnSerpent(partie, lesVoisines[i]);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &fin);
+        mesures[2 * nbEchantillons] = (tempsEcoule(debut, fin) * NANO_PAR_SECONDE - surcout) / NB_APPELS_MICRO;
+
+        clock_gettime(CLOCK_MONOTONIC, &debut);
+        for (int i = 0; i < NB_APPELS_MICRO; i++)
+        {
+            puits += minimunTableau(lesChemins[lesRequetes[i]]);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &fin);
+        mesures[3 * nbEchantillons] = (tempsEcoule(debut, fin) * NANO_PAR_SECONDE - surcout) / NB_APPELS_MICRO;
+
+        clock_gettime(CLOCK_MONOTONIC, &debut);
+        for (int i = 0; i < NB_APPELS_MICRO; i++)
+        {
+            puits += caseVoisine(plateau, lesCases[i], lesCodes[i]);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &fin);
+        mesures[4 * nbEchantillons] = (tempsEcoule(debut, fin) * NANO_PAR_SECONDE - surcout) / NB_APPELS_MICRO;
+
+        // progresser modifie la partie : les décisions de ce tour prises, la partie est copiée (hors chronomètre)
+        // dans NB_COPIES_MICRO parties, puis un bloc fait avancer chaque copie une fois.
+        deciderSerpents(partie, caseCible);
+        double duree = 0;
+        for (int t = 0; t < NB_TOURS_MICRO; t += NB_COPIES_MICRO)
+        {
+            for (int k = 0; k < NB_COPIES_MICRO; k++)
+            {
+                copierPartie(lesCopies[k], partie);
+            }
+            clock_gettime(CLOCK_MONOTONIC, &debut);
+            for (int k = 0; k < NB_COPIES_MICRO; k++)
+            {
+                puits += progresser(lesCopies[k]);
+            }
+            clock_gettime(CLOCK_MONOTONIC, &fin);
+            duree += tempsEcoule(debut, fin) * NANO_PAR_SECONDE - surcout;
+        }
+        mesures[5 * nbEchantillons] = duree / NB_TOURS_MICRO;
+        restaurerInstantane(partie, etat);
+
+        // Affichage vers /dev/null : une image alterne corps et cases vides sur tous les anneaux, pour que
+        // chaque appel à afficher note une case changée et que chaque rafraîchissement ait tout à envoyer.
+        affichageActif = true;
+        double dureeAffichage = 0, dureeRafraichissement = 0;
+        for (int t = 0; t < NB_TOURS_MICRO; t++)
+        {
+            char car = (t & 1) ? VIDE : CORPS;
+            clock_gettime(CLOCK_MONOTONIC, &debut);
+            for (int i = 0; i < nbAnneaux; i++)
+            {
+                afficher(lesAnneauxX[i], lesAnneauxY[i], car);
+            }
+            clock_gettime(CLOCK_MONOTONIC, &fin);
+            dureeAffichage += tempsEcoule(debut, fin) * NANO_PAR_SECONDE - surcout;
+
+            clock_gettime(CLOCK_MONOTONIC, &debut);
+            rafraichirEcran();
+            clock_gettime(CLOCK_MONOTONIC, &fin);
+            dureeRafraichissement += tempsEcoule(debut, fin) * NANO_PAR_SECONDE - surcout;
+        }
+        affichageActif = false;
+        mesures[6 * nbEchantillons] = dureeAffichage / ((double)NB_TOURS_MICRO * nbAnneaux);
+        mesures[7 * nbEchantillons] = dureeRafraichissement / NB_TOURS_MICRO;
+    }
+
+    if (reussi)
+    {
+        printf("Fonctions de chaque tour : %ld échantillons sur %d états, %d serpents de %d à %d anneaux, plateau %dx%d\n",
+               nbEchantillons, nbEtats, nbSerpents, longueurMin, longueurMax, largeurPlateau, hauteurPlateau);
+        printf("Durée d'un appel en ns (moyenne ± intervalle de confiance à 95 %%, minimum), horloge (%.1f ns) déduite\n", surcout);
+        printf("afficher : une case ; rafraichirEcran : une image de tous les anneaux vers /dev/null\n");
+
+        FILE *detail = NULL;
+        if (nomDetail != NULL)
+        {
+            detail = fopen(nomDetail, "w");
+            if (detail == NULL)
+            {
+                perror(nomDetail);
+                reussi = false;
+            }
+            else
+            {
+                fprintf(detail, "fonction,serpents,largeur,hauteur,echantillons,moyenne_ns,ic95_ns,minimum_ns\n");
+            }
+        }
+        for (int f = 0; f < nbFonctions; f++)
+        {
+            noterMesure(detail, lesFonctions[f], echantillons + f * nbEchantillons, nbEchantillons);
+        }
+        if ((detail != NULL) && (fclose(detail) != 0))
+        {
+            perror(nomDetail);
+            reussi = false;
+        }
+    }
+    if (puits == -1)
+    {
+        printf("\n"); // Jamais vrai : la condition garde les résultats vivants.
+    }
+
+    if (sortieEcran != STDOUT_FILENO)
+    {
+        close(sortieEcran);
+        sortieEcran = STDOUT_FILENO;
+    }
+    for (int i = 0; i < NB_ETATS_MICRO; i++)
+    {
+        free(lesEtats[i]);
+    }
+    for (int k = 0; k < NB_COPIES_MICRO; k++)
+    {
+        free(lesCopies[k]);
+    }
+    free(partie);
+    free(echantillons);
+    free(lesSerpentsEnJeu);
+    free(lesChemins);
+    free(lesAnneauxX);
+    free(lesAnneauxY);
+    return reussi;
+}
+
+
+/************************************************/
+/*		RECHERCHE ARBORESCENTE MONTE-CARLO    	*/
+/************************************************/
+
+bool estSerpentMcts(int s) {
+    return (s < NB_SERPENTS_MCTS) && ((mcts.serpents >> s) & 1);
+}
+
+
+int adversaireProche(const tPartie *partie, int s) {
+    // À deux serpents, l'autre ; au-delà, le serpent en jeu dont la tête est la plus proche.
+    int tete = caseAnneau(partie, s, 0);
+    int adversaire = -1, meilleureDistance = 0;
+
+    for (int t = 0; t < nbSerpents; t++)
+    {
+        if ((t == s) || !VIVANTS(partie)[t])
+        {
+            continue;
+        }
+        int autreTete = caseAnneau(partie, t, 0);
+        int distance = abs(X_CASE(tete) - X_CASE(autreTete)) + abs(Y_CASE(tete) - Y_CASE(autreTete));
+        if ((adversaire < 0) || (distance < meilleureDistance))
+        {
+            adversaire = t;
+            meilleureDistance = distance;
+        }
+    }
+    return adversaire;
+}
+
+
+unsigned coupsSurs(const tPartie *partie, int s) {
+    const char lesDirections[4] = {HAUT, BAS, GAUCHE, DROITE};
+    int tete = caseAnneau(partie, s, 0);
+    unsigned coups = 0;
+
+    for (int d = 0; d < 4; d++)
+    {
+        if (directionEstSure(partie, tete, lesDirections[d]))
+        {
+            coups |= 1u << d;
+        }
+    }
+    // Aucune direction sûre : le serpent est perdu, inutile d'ouvrir quatre branches.
+    return (coups != 0) ? coups : 1u << codeDirection(DIRECTIONS(partie)[s]);
+}
+
+
+char directionSimulation(const tPartie *partie, int s, int caseCible, uint64_t *alea) {
+    const char lesDirections[4] = {HAUT, BAS, GAUCHE, DROITE};
+
+    if (mcts.rollout == ROLLOUT_CHEMIN)
+    {
+        return directionAutomatique(partie, s, caseCible);
+    }
+    if (mcts.rollout == ROLLOUT_SURE)
+    {
+        unsigned coups = coupsSurs(partie, s);
+        int nbCoups = __builtin_popcount(coups);
+        int k = (int)(aleatoireSuivant(alea) % (uint64_t)nbCoups);
+        for (int d = 0; d < 4; d++)
+        {
+            if (((coups >> d) & 1) && (k-- == 0))
+            {
+                return lesDirections[d];
+            }
+        }
+    }
+    // Au hasard, sauf le demi-tour (qui mord toujours le cou).
+    const int lesOpposes[4] = {1, 0, 3, 2};
+    int oppose = lesOpposes[codeDirection(DIRECTIONS(partie)[s])];
+    int d = (int)(aleatoireSuivant(alea) % 3);
+    return lesDirections[(d >= oppose) ? d + 1 : d];
+}
+
+
+int nouveauNoeud(tRechercheMcts *recherche, const tPartie *jeu) {
+    int n = recherche->nbNoeuds++;
+    tNoeudMcts *noeud = &recherche->noeuds[n];
+    int adversaire = recherche->adversaire;
+
+    memset(noeud, 0, sizeof(*noeud));
+    noeud->coupsPossibles[0] = (unsigned char)coupsSurs(jeu, recherche->serpent);
+    noeud->coupsPossibles[1] = ((adversaire >= 0) && VIVANTS(jeu)[adversaire]) ? (unsigned char)coupsSurs(jeu, adversaire) : 1;
+    return n;
+}
+
+
+int choisirCoup(const tNoeudMcts *noeud, int joueur, uint64_t *alea) {
+    // UCB1 pour chaque serpent séparément (recherche découplée pour coups simultanés) :
+    // chaque coup possible encore jamais joué l'est d'abord, dans un ordre tiré au hasard.
+    unsigned coups = noeud->coupsPossibles[joueur];
+    int depart = (int)(aleatoireSuivant(alea) & 3);
+    double logVisites = log(noeud->visites + 1.0);
+    double meilleur = -1.0;
+    int choix = 0;
+
+    for (int i = 0; i < 4; i++)
+    {
+        int d = (depart + i) & 3;
+        if (!((coups >> d) & 1))
+        {
+            continue;
+        }
+        int n = noeud->visitesCoup[joueur][d];
+        if (n == 0)
+        {
+            return d;
+        }
+        double valeur = noeud->gains[joueur][d] / n + EXPLORATION_MCTS * sqrt(logVisites / n);
+        if (valeur > meilleur)
+        {
+            meilleur = valeur;
+            choix = d;
+        }
+    }
+    return choix;
+}
+
+
+void jouerCoupsMcts(tRechercheMcts *recherche, int coupSerpent, int coupAdversaire) {
+    // Coups imposés au serpent et à son adversaire (-1 : stratégie des simulations), puis un tour complet.
+    const char lesDirections[4] = {HAUT, BAS, GAUCHE, DROITE};
+    tPartie *jeu = recherche->jeu;
+    int caseCible = CASE(jeu->lesPommesX[jeu->nbPommesMangees], jeu->lesPommesY[jeu->nbPommesMangees]);
+
+    for (int t = 0; t < nbSerpents; t++)
+    {
+        if (VIVANTS(jeu)[t])
+        {
+            DECISIONS(jeu)[t] = directionSimulation(jeu, t, caseCible, &recherche->alea);
+        }
+    }
+    if (coupSerpent >= 0)
+    {
+        DECISIONS(jeu)[recherche->serpent] = lesDirections[coupSerpent];
+    }
+    bool adversaireEnJeu = (recherche->adversaire >= 0) && VIVANTS(jeu)[recherche->adversaire];
+    if ((coupAdversaire >= 0) && adversaireEnJeu)
+    {
+        DECISIONS(jeu)[recherche->adversaire] = lesDirections[coupAdversaire];
+    }
+    int pommesAvant = jeu->nbPommesMangees;
+    int pommesSerpent = POMMES_SERPENTS(jeu)[recherche->serpent];
+    appliquerTour(jeu);
+
+    // Une pomme prise tôt vaut plus qu'une pomme prise tard : les coups qui rapprochent de la pomme se distinguent.
+    if (jeu->nbPommesMangees != pommesAvant)
+    {
+        int joueur = (POMMES_SERPENTS(jeu)[recherche->serpent] != pommesSerpent) ? 0 : 1;
+        if ((joueur == 0) || adversaireEnJeu)
+        {
+            recherche->pommesActualisees[joueur] += recherche->actualisation;
+        }
+    }
+    recherche->actualisation *= ACTUALISATION_MCTS;
+}
+
+
+double valeurMcts(const tRechercheMcts *recherche, int joueur) {
+    // Gain d'une simulation pour le serpent qui cherche (joueur 0) ou son adversaire (joueur 1), entre 0 et 1.
+    // Sortir du jeu est une défaite ; sinon, comme au tournoi, c'est l'écart de pommes qui compte, définitif si
+    // la partie est finie (l'adversaire sorti du jeu n'est donc une victoire que pour le serpent en tête).
+    // À l'horizon, les pommes prises sont actualisées et la distance à la pomme en jeu départage.
+    const tPartie *jeu = recherche->jeu;
+    int moi = (joueur == 0) ? recherche->serpent : recherche->adversaire;
+    int lui = (joueur == 0) ? recherche->adversaire : recherche->serpent;
+
+    if (!VIVANTS(jeu)[moi])
+    {
+        return 0.0;
+    }
+    if (partieTerminee(jeu))
+    {
+        int ecart = POMMES_SERPENTS(jeu)[moi] - ((lui >= 0) ? POMMES_SERPENTS(jeu)[lui] : 0);
+        return (ecart > 0) ? 1.0 : (ecart == 0) ? 0.5 : 0.0;
+    }
+    int casePomme = CASE(jeu->lesPommesX[jeu->nbPommesMangees], jeu->lesPommesY[jeu->nbPommesMangees]);
+    int distanceMoi = distanceEstimee(caseAnneau(jeu, moi, 0), casePomme);
+    int distanceLui = ((lui >= 0) && VIVANTS(jeu)[lui]) ? distanceEstimee(caseAnneau(jeu, lui, 0), casePomme) : distanceMoi;
+    double ecart = ((joueur == 0) ? recherche->ecartRacine : -recherche->ecartRacine)
+                   + recherche->pommesActualisees[joueur] - recherche->pommesActualisees[1 - joueur]
+                   + 0.5 * recherche->actualisation * (pow(ACTUALISATION_MCTS, distanceMoi) - pow(ACTUALISATION_MCTS, distanceLui));
+    return 0.5 + 0.45 * ecart / (fabs(ecart) + 1.0);
+}
+
+
+int distanceEstimee(int caseDepart, int caseArrivee) {
+    if (tableActive)
+    {
+        int distance = distanceStatique(caseDepart, caseArrivee);
+        if (distance != DISTANCE_INCONNUE)
+        {
+            return distance;
+        }
+    }
+    return abs(X_CASE(caseDepart) - X_CASE(caseArrivee)) + abs(Y_CASE(caseDepart) - Y_CASE(caseArrivee));
+}
+
+
+void simulerMcts(tRechercheMcts *recherche) {
+    // Une itération : descente dans l'arbre depuis l'instantané de la racine, ajout d'un nœud,
+    // simulation jusqu'à l'horizon avec la stratégie choisie, puis remontée des gains.
+    tPartie *jeu = recherche->jeu;
+    int s = recherche->serpent;
+    int adversaire = recherche->adversaire;
+    int lesNoeuds[PROFONDEUR_MCTS]; // Chemin suivi dans l'arbre : nœud et coup joint joué depuis ce nœud.
+    int lesCoups[PROFONDEUR_MCTS];
+    int profondeur = 0;
+    int n = 0;
+
+    restaurerInstantane(jeu, recherche->racine);
+    recherche->pommesActualisees[0] = 0.0;
+    recherche->pommesActualisees[1] = 0.0;
+    recherche->actualisation = 1.0;
+    while ((profondeur < PROFONDEUR_MCTS) && !partieTerminee(jeu) && VIVANTS(jeu)[s])
+    {
+        tNoeudMcts *noeud = &recherche->noeuds[n];
+        int coupSerpent = choisirCoup(noeud, 0, &recherche->alea);
+        int coupAdversaire = ((adversaire >= 0) && VIVANTS(jeu)[adversaire]) ? choisirCoup(noeud, 1, &recherche->alea) : 0;
+
+        jouerCoupsMcts(recherche, coupSerpent, coupAdversaire);
+        lesNoeuds[profondeur] = n;
+        lesCoups[profondeur] = 4 * coupSerpent + coupAdversaire;
+        profondeur++;
+
+        n = noeud->enfants[4 * coupSerpent + coupAdversaire];
+        if (n == 0) // Feuille : un nœud de plus (s'il reste de la place), puis la simulation.
+        {
+            if (recherche->nbNoeuds < NB_NOEUDS_MCTS)
+            {
+                noeud->enfants[4 * coupSerpent + coupAdversaire] = nouveauNoeud(recherche, jeu);
+            }
+            break;
+        }
+    }
+
+    for (int t = 0; (t < PROFONDEUR_MCTS) && !partieTerminee(jeu) && VIVANTS(jeu)[s]; t++)
+    {
+        jouerCoupsMcts(recherche, -1, -1);
+    }
+
+    double gainSerpent = valeurMcts(recherche, 0);
+    double gainAdversaire = (adversaire >= 0) ? valeurMcts(recherche, 1) : 0.0;
+    for (int i = 0; i < profondeur; i++)
+    {
+        tNoeudMcts *noeud = &recherche->noeuds[lesNoeuds[i]];
+        int coupSerpent = lesCoups[i] / 4, coupAdversaire = lesCoups[i] % 4;
+        noeud->visites++;
+        noeud->visitesCoup[0][coupSerpent]++;
+        noeud->gains[0][coupSerpent] += (float)gainSerpent;
+        noeud->visitesCoup[1][coupAdversaire]++;
+        noeud->gains[1][coupAdversaire] += (float)gainAdversaire;
+    }
+    recherche->nbPlayouts++;
+}
+
+
+void chercherMcts(tRechercheMcts *recherche, const tPartie *partie, int s, int adversaire, long nbPlayouts, struct timespec echeance) {
+    // Arbre propre à ce fil (parallélisme à la racine) : aucune donnée partagée pendant la recherche.
+    if (recherche->jeu == NULL)
+    {
+        recherche->jeu = nouvellePartie();
+        recherche->racine = nouvelInstantane();
+        recherche->noeuds = malloc(sizeof(tNoeudMcts) * NB_NOEUDS_MCTS);
+        if (recherche->noeuds == NULL)
+        {
+            perror("malloc");
+            exit(EXIT_FAILURE);
+        }
+    }
+    copierPartie(recherche->jeu, partie);
+    prendreInstantane(recherche->racine, recherche->jeu);
+    recherche->serpent = s;
+    recherche->adversaire = adversaire;
+    recherche->alea = partie->graine * 0x9E3779B97F4A7C15ULL ^ ((uint64_t)partie->nbTours << 24) ^ ((uint64_t)s << 8) ^ (uint64_t)rangFil;
+    recherche->nbNoeuds = 0;
+    recherche->nbPlayouts = 0;
+    recherche->ecartRacine = POMMES_SERPENTS(partie)[s] - ((adversaire >= 0) ? POMMES_SERPENTS(partie)[adversaire] : 0);
+    nouveauNoeud(recherche, recherche->jeu);
+
+    enRecherche = true; // Les simulations n'écrivent rien à l'écran.
+    for (long i = 0; (nbPlayouts > 0) ? (i < nbPlayouts) : true; i++)
+    {
+        if ((nbPlayouts == 0) && (i % 8 == 0)) // Budget en temps : l'horloge n'est lue que toutes les 8 simulations.
+        {
+            struct timespec maintenant;
+            clock_gettime(CLOCK_MONOTONIC, &maintenant);
+            if (tempsEcoule(echeance, maintenant) >= 0)
+            {
+                break;
+            }
+        }
+        simulerMcts(recherche);
+    }
+    enRecherche = false;
+}
+
+
+void rechercheEquipe(void) {
+    long nbPlayouts = (equipe.nbPlayoutsMcts + equipe.nbFils - 1) / equipe.nbFils; // Part de chaque fil.
+    chercherMcts(&lesRecherches[rangFil], equipe.partieRecherche, equipe.serpentRecherche, equipe.adversaireRecherche, nbPlayouts, equipe.echeanceRecherche);
+}
+
+
+char directionMcts(const tPartie *partie, int s) {
+    const char lesDirections[4] = {HAUT, BAS, GAUCHE, DROITE};
+    unsigned coups = coupsSurs(partie, s);
+    int adversaire = adversaireProche(partie, s);
+    struct timespec debut, fin, echeance;
+
+    if ((coups & (coups - 1)) == 0)
+    {
+        return lesDirections[__builtin_ctz(coups)]; // Un seul coup possible : rien à chercher.
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    echeance = debut;
+    ajouterNanosecondes(&echeance, mcts.budget);
+
+    // Parallélisme à la racine : chaque fil de l'équipe fait pousser son propre arbre depuis le même état,
+    // puis les visites des coups de la racine s'additionnent. L'équipe ne sert que si elle est libre
+    // (décisions sur le fil principal) ; sinon, le fil qui décide ce serpent cherche seul.
+    int nbArbres = 1;
+    if ((equipe.nbFils > 1) && !equipe.occupee && (rangFil == 0))
+    {
+        equipe.partieRecherche = partie;
+        equipe.serpentRecherche = s;
+        equipe.adversaireRecherche = adversaire;
+        equipe.nbPlayoutsMcts = mcts.nbPlayouts;
+        equipe.echeanceRecherche = echeance;
+        equipe.travail = rechercheEquipe;
+        pthread_barrier_wait(&equipe.depart);
+        rechercheEquipe();
+        pthread_barrier_wait(&equipe.arrivee);
+        nbArbres = equipe.nbFils;
+    }
+    else
+    {
+        chercherMcts(&lesRecherches[rangFil], partie, s, adversaire, mcts.nbPlayouts, echeance);
+    }
+
+    long visites[4] = {0, 0, 0, 0};
+    double gains[4] = {0.0, 0.0, 0.0, 0.0};
+    long nbPlayouts = 0;
+    for (int i = 0; i < nbArbres; i++)
+    {
+        const tRechercheMcts *recherche = &lesRecherches[(nbArbres > 1) ? i : rangFil];
+        for (int d = 0; d < 4; d++)
+        {
+            visites[d] += recherche->noeuds[0].visitesCoup[0][d];
+            gains[d] += recherche->noeuds[0].gains[0][d];
+        }
+        nbPlayouts += recherche->nbPlayouts;
+    }
+
+    // Quand les simulations ne départagent pas les coups (pomme hors d'atteinte de l'horizon, par exemple),
+    // le serpent suit la stratégie ordinaire : la recherche ne l'en écarte que pour un gain moyen nettement meilleur.
+    int caseCible = CASE(partie->lesPommesX[partie->nbPommesMangees], partie->lesPommesY[partie->nbPommesMangees]);
+    int ordinaire = codeDirection(directionAutomatique(partie, s, caseCible));
+    int meilleur = -1;
+    for (int d = 0; d < 4; d++)
+    {
+        if (((coups >> d) & 1) && (visites[d] > 0) && ((meilleur < 0) || (gains[d] / visites[d] > gains[meilleur] / visites[meilleur])))
+        {
+            meilleur = d;
+        }
+    }
+    int choix = ordinaire;
+    if ((meilleur >= 0) && (!((coups >> ordinaire) & 1) || (visites[ordinaire] == 0)
+                            || (gains[meilleur] / visites[meilleur] > gains[ordinaire] / visites[ordinaire] + MARGE_MCTS)))
+    {
+        choix = meilleur;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &fin);
+    __atomic_fetch_add(&mcts.nbDecisions, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&mcts.nbPlayoutsTotal, nbPlayouts, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&mcts.dureeTotale, (long)(tempsEcoule(debut, fin) * NANO_PAR_SECONDE), __ATOMIC_RELAXED);
+    return lesDirections[choix];
+}
+
+
+void afficherBilanMcts(void) {
+    if (mcts.nbDecisions == 0)
+    {
+        return;
+    }
+    double duree = mcts.dureeTotale / NANO_PAR_SECONDE;
+    printf("MCTS : %ld décisions, %.0f simulations par décision, %.0f simulations par seconde\n",
+           mcts.nbDecisions, (double)mcts.nbPlayoutsTotal / mcts.nbDecisions, (duree > 0) ? mcts.nbPlayoutsTotal / duree : 0.0);
+}
+
+
+void libererRecherches(void) {
+    for (int i = 0; i < NB_FILS_MAX; i++)
+    {
+        free(lesRecherches[i].jeu);
+        free(lesRecherches[i].racine);
+        free(lesRecherches[i].noeuds);
+        memset(&lesRecherches[i], 0, sizeof(lesRecherches[i]));
+        free(lesRecherchesAlphaBeta[i].jeu);
+        libererPileAnnulation(&lesRecherchesAlphaBeta[i].pile);
+        memset(&lesRecherchesAlphaBeta[i], 0, sizeof(lesRecherchesAlphaBeta[i]));
+    }
+    free(alphabeta.table);
+    alphabeta.table = NULL;
+}
+
+
+bool lireSerpents(const char *liste, uint64_t *serpents) {
+    const char *suite = liste;
+
+    do
+    {
+        char *fin;
+        long numero = strtol(suite, &fin, 10);
+        if ((numero < 1) || (numero > NB_SERPENTS_MCTS) || ((*fin != ',') && (*fin != '\0')))
+        {
+            fprintf(stderr, "Serpents invalides : %s (numéros de 1 à %d séparés par des virgules)\n", liste, NB_SERPENTS_MCTS);
+            return false;
+        }
+        *serpents |= 1ULL << (numero - 1);
+        suite = fin;
+    } while (*suite++ == ',');
+    return true;
+}
+
+
+/************************************************/
+/*		RECHERCHE ALPHA-BÊTA            		*/
+/************************************************/
+
+bool estSerpentAlphaBeta(int s) {
+    return (s < NB_SERPENTS_MCTS) && ((alphabeta.serpents >> s) & 1);
+}
+
+
+uint64_t cleZobrist(tCleZobrist type, int s, int valeur) {
+    // Clé pseudo-aléatoire d'un élément de la position, calculée plutôt que lue dans des tables : splitmix64 est
+    // une bijection, deux éléments différents ont donc des clés différentes. Une case tient sur 32 bits (jusqu'à
+    // environ 270 millions de cases avec les gardes au plus grand plateau), un numéro de serpent sur 17 : les trois
+    // champs ne se chevauchent pas.
+    uint64_t etat = ((uint64_t)type << 56) ^ ((uint64_t)(unsigned)s << 32) ^ (uint64_t)(unsigned)valeur;
+    return aleatoireSuivant(&etat);
+}
+
+
+uint64_t zobristPartie(const tPartie *partie) {
+    // Hachage recalculé depuis zéro ; en cours de partie, avancerQueue, avancerTete, retirerSerpent et
+    // appliquerTour le tiennent à jour par XOR, sans parcourir les serpents.
+    uint64_t etat = partie->graine;
+    uint64_t zobrist = aleatoireSuivant(&etat); // La graine fixe l'ordre des pommes à venir.
+
+    for (int s = 0; s < nbSerpents; s++)
+    {
+        zobrist ^= cleZobrist(CLE_POMMES, s, POMMES_SERPENTS(partie)[s]);
+        if (LONGUEURS(partie)[s] > 0)
+        {
+            zobrist ^= cleZobrist(CLE_TETE, s, caseAnneau(partie, s, 0));
+        }
+        for (int i = 0; i < LONGUEURS(partie)[s]; i++)
+        {
+            zobrist ^= cleZobrist(CLE_CORPS, s, caseAnneau(partie, s, i));
+        }
+    }
+    return zobrist ^ clePommeEnJeu(partie);
+}
+
+
+uint64_t clePommeEnJeu(const tPartie *partie) {
+    // La case compte aussi : avec les pommes aléatoires, la pomme d'un indice donné dépend de la partie jouée.
+    if (partie->gagne)
+    {
+        return 0;
+    }
+    int casePomme = CASE(partie->lesPommesX[partie->nbPommesMangees], partie->lesPommesY[partie->nbPommesMangees]);
+    return cleZobrist(CLE_POMME_EN_JEU, partie->nbPommesMangees, casePomme);
+}
+
+
+void allouerTransposition(void) {
+    // Plus grande puissance de 2 d'entrées qui tient dans la taille demandée : l'indice est un simple masque.
+    size_t nbEntrees = 1;
+
+    while (2 * nbEntrees * sizeof(tEntreeTransposition) <= ((size_t)alphabeta.tailleTable << 20))
+    {
+        nbEntrees *= 2;
+    }
+    alphabeta.table = calloc(nbEntrees, sizeof(tEntreeTransposition));
+    if (alphabeta.table == NULL)
+    {
+        perror("calloc");
+        exit(EXIT_FAILURE);
+    }
+    alphabeta.masque = nbEntrees - 1;
+}
+
+
+bool lireTransposition(uint64_t cle, uint64_t *donnees) {
+    // Sans verrou : l'entrée n'est valable que si sa vérification redonne la clé. Une entrée écrite à moitié par
+    // un autre fil (vérification et données de deux écritures différentes) échoue à ce test et compte comme absente.
+    tEntreeTransposition *entree = &alphabeta.table[cle & alphabeta.masque];
+    uint64_t verification = __atomic_load_n(&entree->verification, __ATOMIC_RELAXED);
+
+    *donnees = __atomic_load_n(&entree->donnees, __ATOMIC_RELAXED);
+    return ((*donnees & ENTREE_VALIDE) != 0) && ((verification ^ *donnees) == cle);
+}
+
+
+void ecrireTransposition(uint64_t cle, int valeur, int profondeur, tBorne borne, int coup) {
+    tEntreeTransposition *entree = &alphabeta.table[cle & alphabeta.masque];
+    uint64_t ancienne;
+
+    // Remplacement systématique, sauf une entrée de la même position cherchée plus profondément.
+    if (lireTransposition(cle, &ancienne) && (PROFONDEUR_ENTREE(ancienne) > profondeur))
+    {
+        return;
+    }
+    uint64_t donnees = (uint64_t)(uint32_t)valeur | ((uint64_t)profondeur << 32) | ((uint64_t)borne << 40)
+                       | ((uint64_t)coup << 42) | ENTREE_VALIDE;
+    __atomic_store_n(&entree->donnees, donnees, __ATOMIC_RELAXED);
+    __atomic_store_n(&entree->verification, cle ^ donnees, __ATOMIC_RELAXED);
+}
+
+
+int espaceLibre(const tPartie *partie, int depart, int limite) {
+    // Cases libres atteignables depuis depart (parcours en largeur arrêté à limite cases).
+    static _Thread_local int *file = NULL;
+    static _Thread_local uint32_t *visite = NULL;
+    static _Thread_local uint32_t generation = 0;
+    tPlateau plateau = PLATEAU(partie);
+    const unsigned char *occupation = OCCUPATION(partie);
+    int debut = 0, fin = 0, nbCases = 0;
+
+    if (file == NULL)
+    {
+        file = allouerCases(sizeof(int));
+        visite = allouerCases(sizeof(uint32_t));
+        memset(visite, 0, nbCasesMemoire * sizeof(uint32_t));
+    }
+    if (++generation == UINT32_MAX)
+    {
+        memset(visite, 0, nbCasesMemoire * sizeof(uint32_t));
+        generation = 1;
+    }
+
+    visite[depart] = generation;
+    file[fin++] = depart;
+    while ((debut < fin) && (nbCases < limite))
+    {
+        int c = file[debut++];
+        for (int d = 0; d < 4; d++)
+        {
+            int v = caseVoisine(plateau, c, d);
+            if ((visite[v] == generation) || (plateau[v] == BORDURE) || (plateau[v] == PAVE) || (occupation[v] != 0))
+            {
+                continue;
+            }
+            visite[v] = generation;
+            file[fin++] = v;
+            nbCases++;
+        }
+    }
+    return nbCases;
+}
+
+
+int evaluerAlphaBeta(const tRechercheAlphaBeta *recherche, int profondeur) {
+    // Valeur d'une position pour le serpent qui cherche. Sortir du jeu est une défaite et, comme au tournoi,
+    // une partie finie se juge à l'écart de pommes ; la profondeur restante fait préférer la victoire la plus
+    // rapide et la défaite la plus lointaine. À l'horizon : pommes d'avance, avance vers la pomme en jeu, et
+    // pénalité pour un serpent enfermé dans moins de cases libres que sa longueur.
+    const tPartie *jeu = recherche->jeu;
+    int moi = recherche->serpent;
+    int lui = recherche->adversaire;
+    bool luiEnJeu = (lui >= 0) && VIVANTS(jeu)[lui];
+
+    if (!VIVANTS(jeu)[moi])
+    {
+        return -VICTOIRE_ALPHABETA - profondeur;
+    }
+    int ecart = POMMES_SERPENTS(jeu)[moi] - ((lui >= 0) ? POMMES_SERPENTS(jeu)[lui] : 0);
+    if (partieTerminee(jeu))
+    {
+        return (ecart > 0) ? VICTOIRE_ALPHABETA + profondeur : (ecart < 0) ? -VICTOIRE_ALPHABETA - profondeur : 0;
+    }
+
+    int casePomme = CASE(jeu->lesPommesX[jeu->nbPommesMangees], jeu->lesPommesY[jeu->nbPommesMangees]);
+    int teteMoi = caseAnneau(jeu, moi, 0);
+    int distanceMoi = distanceEstimee(teteMoi, casePomme);
+    int valeur = POMME_ALPHABETA * ecart;
+
+    if (espaceLibre(jeu, teteMoi, LONGUEURS(jeu)[moi]) < LONGUEURS(jeu)[moi])
+    {
+        valeur -= PIEGE_ALPHABETA;
+    }
+    if (luiEnJeu)
+    {
+        int teteLui = caseAnneau(jeu, lui, 0);
+        valeur += DISTANCE_ALPHABETA * (distanceEstimee(teteLui, casePomme) - distanceMoi);
+        if (espaceLibre(jeu, teteLui, LONGUEURS(jeu)[lui]) < LONGUEURS(jeu)[lui])
+        {
+            valeur += PIEGE_ALPHABETA;
+        }
+    }
+    return valeur;
+}
+
+
+void jouerCoupsAlphaBeta(tRechercheAlphaBeta *recherche, int coupSerpent, int coupAdversaire) {
+    // Un tour avec ces coups imposés (-1 : adversaire hors jeu), les autres serpents suivant la stratégie ordinaire.
+    // Le tour est marqué : l'appelant le défait par annulerTour.
+    const char lesDirections[4] = {HAUT, BAS, GAUCHE, DROITE};
+    tPartie *jeu = recherche->jeu;
+    int caseCible = CASE(jeu->lesPommesX[jeu->nbPommesMangees], jeu->lesPommesY[jeu->nbPommesMangees]);
+
+    for (int t = 0; t < nbSerpents; t++)
+    {
+        if (VIVANTS(jeu)[t] && (t != recherche->serpent) && (t != recherche->adversaire))
+        {
+            DECISIONS(jeu)[t] = directionAutomatique(jeu, t, caseCible);
+        }
+    }
+    DECISIONS(jeu)[recherche->serpent] = lesDirections[coupSerpent];
+    if (coupAdversaire >= 0)
+    {
+        DECISIONS(jeu)[recherche->adversaire] = lesDirections[coupAdversaire];
+    }
+    marquerTour(&recherche->pile, jeu);
+    appliquerTour(jeu);
+}
+
+
+int alphaBeta(tRechercheAlphaBeta *recherche, int profondeur, int alpha, int beta, bool racine) {
+    // Coups simultanés vus prudemment : pour chaque coup du serpent, l'adversaire choisit la réponse la pire
+    // pour lui (min), puis le serpent garde le meilleur de ces pires cas (max). Valeur dans [alpha, beta] si exacte.
+    tPartie *jeu = recherche->jeu;
+    int adversaire = recherche->adversaire;
+
+    if ((++recherche->nbNoeuds % 1024 == 0) && recherche->avecEcheance) // L'horloge n'est lue que tous les 1024 nœuds.
+    {
+        struct timespec maintenant;
+        clock_gettime(CLOCK_MONOTONIC, &maintenant);
+        recherche->interrompue = (tempsEcoule(recherche->echeance, maintenant) >= 0);
+    }
+    if (recherche->interrompue)
+    {
+        return 0; // Valeur sans importance : la profondeur en cours est abandonnée.
+    }
+    if ((profondeur == 0) || !VIVANTS(jeu)[recherche->serpent] || partieTerminee(jeu) || (jeu->nbTours >= limiteTours))
+    {
+        return evaluerAlphaBeta(recherche, profondeur);
+    }
+
+    // Position déjà cherchée au moins aussi profond : sa valeur suffit. Sinon son meilleur coup est essayé d'abord.
+    uint64_t cle = jeu->zobrist ^ recherche->camp;
+    uint64_t donnees;
+    int coupTable = -1;
+    recherche->nbLectures++;
+    if (lireTransposition(cle, &donnees))
+    {
+        recherche->nbTrouvees++;
+        coupTable = COUP_ENTREE(donnees);
+        int valeur = VALEUR_ENTREE(donnees);
+        if (!racine && (PROFONDEUR_ENTREE(donnees) >= profondeur)
+            && ((BORNE_ENTREE(donnees) == BORNE_EXACTE) || ((BORNE_ENTREE(donnees) == BORNE_INFERIEURE) && (valeur >= beta))
+                || ((BORNE_ENTREE(donnees) == BORNE_SUPERIEURE) && (valeur <= alpha))))
+        {
+            return valeur;
+        }
+    }
+
+    // Ordre des coups : à la racine, celui de la stratégie ordinaire d'abord (il est gardé à valeur égale),
+    // puis celui de la table, puis les autres.
+    unsigned mesCoups = coupsSurs(jeu, recherche->serpent);
+    bool adversaireEnJeu = (adversaire >= 0) && VIVANTS(jeu)[adversaire];
+    unsigned sesCoups = adversaireEnJeu ? coupsSurs(jeu, adversaire) : 1;
+    int lesCandidats[6] = {racine ? recherche->coupOrdinaire : -1, coupTable, 0, 1, 2, 3};
+    int lesCoups[4];
+    int nbCoups = 0;
+    for (int i = 0; i < 6; i++)
+    {
+        int d = lesCandidats[i];
+        if ((d >= 0) && ((mesCoups >> d) & 1))
+        {
+            lesCoups[nbCoups++] = d;
+            mesCoups &= ~(1u << d);
+        }
+    }
+
+    int alphaInitial = alpha;
+    int meilleur = -INFINI_ALPHABETA;
+    int meilleurCoup = lesCoups[0];
+    for (int i = 0; (i < nbCoups) && (alpha < beta); i++)
+    {
+        int pire = INFINI_ALPHABETA; // Meilleure réponse de l'adversaire à ce coup.
+        for (int r = 0; (r < 4) && (pire > alpha) && !recherche->interrompue; r++)
+        {
+            if (!((sesCoups >> r) & 1))
+            {
+                continue;
+            }
+            jouerCoupsAlphaBeta(recherche, lesCoups[i], adversaireEnJeu ? r : -1);
+            int valeur = alphaBeta(recherche, profondeur - 1, alpha, (pire < beta) ? pire : beta, false);
+            annulerTour(&recherche->pile, jeu);
+            if (valeur < pire)
+            {
+                pire = valeur;
+            }
+        }
+        if (recherche->interrompue)
+        {
+            return 0;
+        }
+        if (pire > meilleur)
+        {
+            meilleur = pire;
+            meilleurCoup = lesCoups[i];
+        }
+        if (meilleur > alpha)
+        {
+            alpha = meilleur;
+        }
+    }
+
+    tBorne borne = (meilleur <= alphaInitial) ? BORNE_SUPERIEURE : (meilleur >= beta) ? BORNE_INFERIEURE : BORNE_EXACTE;
+    ecrireTransposition(cle, meilleur, profondeur, borne, meilleurCoup);
+    if (racine)
+    {
+        recherche->coupRacine = meilleurCoup;
+    }
+    return meilleur;
+}
+
+
+void chercherAlphaBeta(tRechercheAlphaBeta *recherche, const tPartie *partie, int s, int adversaire, int profondeurMax, struct timespec echeance, int premiereProfondeur) {
+    // Approfondissement itératif sur la partie de ce fil : chaque profondeur remplit la table de transposition,
+    // qui ordonne les coups de la suivante. Une profondeur interrompue par l'échéance ne compte pas.
+    if (recherche->jeu == NULL)
+    {
+        recherche->jeu = nouvellePartie();
+    }
+    copierPartie(recherche->jeu, partie);
+    recherche->serpent = s;
+    recherche->adversaire = adversaire;
+    recherche->camp = cleZobrist(CLE_CAMP, s, adversaire + 1);
+    recherche->echeance = echeance;
+    recherche->avecEcheance = (alphabeta.profondeur == 0);
+    recherche->interrompue = false;
+    recherche->nbNoeuds = 0;
+    recherche->nbLectures = 0;
+    recherche->nbTrouvees = 0;
+    recherche->meilleurCoup = -1;
+    recherche->profondeur = 0;
+
+    enRecherche = true; // Les tours cherchés n'écrivent rien à l'écran.
+    int caseCible = CASE(partie->lesPommesX[partie->nbPommesMangees], partie->lesPommesY[partie->nbPommesMangees]);
+    recherche->coupOrdinaire = codeDirection(directionAutomatique(partie, s, caseCible));
+    for (int profondeur = premiereProfondeur; profondeur <= profondeurMax; profondeur++)
+    {
+        alphaBeta(recherche, profondeur, -INFINI_ALPHABETA, INFINI_ALPHABETA, true);
+        if (recherche->interrompue)
+        {
+            break;
+        }
+        recherche->meilleurCoup = recherche->coupRacine;
+        recherche->profondeur = profondeur;
+    }
+    enRecherche = false;
+}
+
+
+void rechercheEquipeAlphaBeta(void) {
+    // Un fil sur deux commence une profondeur plus loin : les fils n'explorent pas les mêmes nœuds au même moment
+    // et s'échangent leurs résultats par la table de transposition.
+    chercherAlphaBeta(&lesRecherchesAlphaBeta[rangFil], equipe.partieRecherche, equipe.serpentRecherche, equipe.adversaireRecherche,
+                      PROFONDEUR_MAX_ALPHABETA, equipe.echeanceRecherche, 1 + rangFil % 2);
+}
+
+
+char directionAlphaBeta(const tPartie *partie, int s) {
+    const char lesDirections[4] = {HAUT, BAS, GAUCHE, DROITE};
+    unsigned coups = coupsSurs(partie, s);
+    int adversaire = adversaireProche(partie, s);
+    struct timespec debut, fin, echeance;
+
+    if ((coups & (coups - 1)) == 0)
+    {
+        return lesDirections[__builtin_ctz(coups)]; // Un seul coup possible : rien à chercher.
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    echeance = debut;
+    ajouterNanosecondes(&echeance, alphabeta.budget);
+
+    // Avec un budget en temps et l'équipe libre, tous les fils cherchent la même position en partageant la table ;
+    // à profondeur fixe, un seul fil cherche pour que la partie soit reproductible.
+    int nbRecherches = 1;
+    if ((alphabeta.profondeur == 0) && (equipe.nbFils > 1) && !equipe.occupee && (rangFil == 0))
+    {
+        equipe.partieRecherche = partie;
+        equipe.serpentRecherche = s;
+        equipe.adversaireRecherche = adversaire;
+        equipe.echeanceRecherche = echeance;
+        equipe.travail = rechercheEquipeAlphaBeta;
+        pthread_barrier_wait(&equipe.depart);
+        rechercheEquipeAlphaBeta();
+        pthread_barrier_wait(&equipe.arrivee);
+        nbRecherches = equipe.nbFils;
+    }
+    else
+    {
+        int profondeurMax = (alphabeta.profondeur > 0) ? alphabeta.profondeur : PROFONDEUR_MAX_ALPHABETA;
+        chercherAlphaBeta(&lesRecherchesAlphaBeta[rangFil], partie, s, adversaire, profondeurMax, echeance, 1);
+    }
+
+    // Le coup retenu est celui de la recherche terminée le plus profond.
+    const tRechercheAlphaBeta *retenue = NULL;
+    long nbNoeuds = 0, nbLectures = 0, nbTrouvees = 0;
+    for (int i = 0; i < nbRecherches; i++)
+    {
+        const tRechercheAlphaBeta *recherche = &lesRecherchesAlphaBeta[(nbRecherches > 1) ? i : rangFil];
+        nbNoeuds += recherche->nbNoeuds;
+        nbLectures += recherche->nbLectures;
+        nbTrouvees += recherche->nbTrouvees;
+        if ((recherche->meilleurCoup >= 0) && ((retenue == NULL) || (recherche->profondeur > retenue->profondeur)))
+        {
+            retenue = recherche;
+        }
+    }
+    // Budget trop court pour finir la première profondeur : stratégie ordinaire.
+    int choix = (retenue != NULL) ? retenue->meilleurCoup : lesRecherchesAlphaBeta[rangFil].coupOrdinaire;
+
+    clock_gettime(CLOCK_MONOTONIC, &fin);
+    __atomic_fetch_add(&alphabeta.nbDecisions, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&alphabeta.nbNoeudsTotal, nbNoeuds, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&alphabeta.sommeProfondeurs, (retenue != NULL) ? retenue->profondeur : 0, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&alphabeta.nbLectures, nbLectures, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&alphabeta.nbTrouvees, nbTrouvees, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&alphabeta.dureeTotale, (long)(tempsEcoule(debut, fin) * NANO_PAR_SECONDE), __ATOMIC_RELAXED);
+    return lesDirections[choix];
+}
+
+
+void afficherBilanAlphaBeta(void) {
+    if (alphabeta.nbDecisions == 0)
+    {
+        return;
+    }
+    double duree = alphabeta.dureeTotale / NANO_PAR_SECONDE;
+    printf("Alpha-bêta : %ld décisions, profondeur moyenne %.1f, %.0f nœuds par seconde, %.1f %% des lectures trouvées dans la table (%zu entrées)\n",
+           alphabeta.nbDecisions, (double)alphabeta.sommeProfondeurs / alphabeta.nbDecisions,
+           (duree > 0) ? alphabeta.nbNoeudsTotal / duree : 0.0,
+           (alphabeta.nbLectures > 0) ? 100.0 * alphabeta.nbTrouvees / alphabeta.nbLectures : 0.0, (size_t)alphabeta.masque + 1);
+}
+
+
+/************************************************/
+/*		JOURNAL ET REJEU DES PARTIES     		*/
+/************************************************/
+
+uint64_t ajouterEmpreinte(uint64_t empreinte, const void *octets, size_t taille) {
+    const unsigned char *octet = octets;
+    for (size_t i = 0; i < taille; i++)
+    {
+        empreinte = (empreinte ^ octet[i]) * 1099511628211ULL; // FNV-1a 64 bits
+    }
+    return empreinte;
+}
+
+
+uint64_t empreintePartie(const tPartie *partie) {
+    // Seules les valeurs utiles entrent dans l'empreinte : ni les octets d'alignement, ni les cases
+    // du tampon circulaire qui ne portent pas d'anneau.
+    int compteurs[5] = {partie->nbPommesMangees, partie->nbVivants, partie->nbTours, partie->collision, partie->gagne};
+    uint64_t empreinte = ajouterEmpreinte(EMPREINTE_INITIALE, compteurs, sizeof(compteurs));
+
+    empreinte = ajouterEmpreinte(empreinte, PLATEAU(partie), nbCasesMemoire);
+    empreinte = ajouterEmpreinte(empreinte, OCCUPATION(partie), nbCasesMemoire);
+    empreinte = ajouterEmpreinte(empreinte, LONGUEURS(partie), sizeof(int) * nbSerpents);
+    empreinte = ajouterEmpreinte(empreinte, POMMES_SERPENTS(partie), sizeof(int) * nbSerpents);
+    empreinte = ajouterEmpreinte(empreinte, PAS_SERPENTS(partie), sizeof(int) * nbSerpents);
+    empreinte = ajouterEmpreinte(empreinte, VIVANTS(partie), sizeof(bool) * nbSerpents);
+    for (int s = 0; s < nbSerpents; s++)
+    {
+        for (int i = 0; i < LONGUEURS(partie)[s]; i++)
+        {
+            int c = caseAnneau(partie, s, i);
+            empreinte = ajouterEmpreinte(empreinte, &c, sizeof(c));
+        }
+    }
+    return empreinte;
+}
+
+
+bool ouvrirJournal(const char *nomFichier) {
+    tEnteteJournal entete = {SIGNATURE_JOURNAL, (uint32_t)largeurPlateau, (uint32_t)hauteurPlateau, (uint32_t)nbSerpents,
+                             NB_POMMES, TAILLE, TAILLE_MAX, CROISSANCE, (uint32_t)sourcePommes};
+
+    // O_APPEND : chaque write() d'une partie entière va à la fin du fichier, même depuis plusieurs processus.
+    journal.fd = open(nomFichier, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+    if (journal.fd < 0)
+    {
+        perror(nomFichier);
+        return false;
+    }
+    if (write(journal.fd, &entete, sizeof(entete)) != (ssize_t)sizeof(entete))
+    {
+        perror(nomFichier);
+        close(journal.fd);
+        journal.fd = -1;
+        return false;
+    }
+    return true;
+}
+
+
+void commencerJournal(void) {
+    journal.nbCoups = 0;
+}
+
+
+void noterCoups(const tPartie *partie) {
+    size_t taille = sizeof(tPartieJournal) + (journal.nbCoups + (size_t)partie->nbVivants + 3) / 4; // Octets utilisés après ce tour.
+
+    if (taille > journal.capacite)
+    {
+        size_t capacite = (journal.capacite > 0) ? journal.capacite : 4096;
+        while (capacite < taille)
+        {
+            capacite *= 2;
+        }
+        journal.tampon = realloc(journal.tampon, capacite);
+        if (journal.tampon == NULL)
+        {
+            perror("realloc");
+            exit(EXIT_FAILURE);
+        }
+        journal.capacite = capacite;
+    }
+
+    unsigned char *coups = journal.tampon + sizeof(tPartieJournal);
+    for (int s = 0; s < nbSerpents; s++)
+    {
+        if (!VIVANTS(partie)[s])
+        {
+            continue;
+        }
+        size_t k = journal.nbCoups++;
+        if (k % 4 == 0)
+        {
+            coups[k / 4] = 0; // Premier coup de l'octet.
+        }
+        coups[k / 4] |= (unsigned char)(codeDirection(DECISIONS(partie)[s]) << (2 * (k % 4)));
+    }
+}
+
+
+void terminerJournal(const tPartie *partie) {
+    tPartieJournal entete = {partie->graine, empreintePartie(partie), (uint32_t)partie->nbTours, (uint32_t)journal.nbCoups};
+    size_t taille = sizeof(entete) + (journal.nbCoups + 3) / 4;
+
+    if (journal.tampon == NULL)
+    {
+        noterCoups(partie); // Partie sans aucun tour (interrompue tout de suite) : alloue le tampon sans coup.
+        journal.nbCoups = 0;
+    }
+    memcpy(journal.tampon, &entete, sizeof(entete));
+    if (write(journal.fd, journal.tampon, taille) != (ssize_t)taille)
+    {
+        if (!journal.erreur)
+        {
+            perror("journal");
+        }
+        journal.erreur = true;
+    }
+}
+
+
+bool rejouerJournal(const char *nomFichier) {
+    const char lesDirections[4] = {HAUT, BAS, GAUCHE, DROITE};
+    tEnteteJournal entete;
+    tPartieJournal enregistree;
+    long nbParties = 0, nbDifferentes = 0, nbToursTotal = 0;
+    struct timespec debut, fin;
+
+    FILE *fichier = fopen(nomFichier, "rb");
+    if (fichier == NULL)
+    {
+        perror(nomFichier);
+        return false;
+    }
+    if ((fread(&entete, sizeof(entete), 1, fichier) != 1) || (memcmp(entete.signature, SIGNATURE_JOURNAL, sizeof(entete.signature)) != 0))
+    {
+        fprintf(stderr, "%s : ce n'est pas un journal de parties\n", nomFichier);
+        fclose(fichier);
+        return false;
+    }
+    if ((entete.nbPommes != NB_POMMES) || (entete.taille != TAILLE) || (entete.tailleMax != TAILLE_MAX) || (entete.croissance != CROISSANCE)
+        || (entete.largeur < LARGEUR_PLATEAU) || (entete.largeur > LARGEUR_MAX) || (entete.hauteur < HAUTEUR_PLATEAU)
+        || (entete.hauteur > HAUTEUR_MAX) || (entete.nbSerpents < 1) || (entete.nbSerpents > NB_SERPENTS_MAX)
+        || (entete.pommes > POMMES_ALEATOIRES))
+    {
+        fprintf(stderr, "%s : journal enregistré avec d'autres règles ou dimensions\n", nomFichier);
+        fclose(fichier);
+        return false;
+    }
+
+    // Même configuration qu'à l'enregistrement ; la stratégie des serpents n'intervient pas, les coups sont lus.
+    nbSerpents = (int)entete.nbSerpents;
+    sourcePommes = (tSourcePommes)entete.pommes;
+    initDimensions((int)entete.largeur, (int)entete.hauteur);
+    initDisposition();
+    tPartie *partie = nouvellePartie();
+    unsigned char *coups = NULL;
+    size_t capacite = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    while (fread(&enregistree, sizeof(enregistree), 1, fichier) == 1)
+    {
+        size_t taille = ((size_t)enregistree.nbCoups + 3) / 4;
+        if (taille > capacite)
+        {
+            capacite = taille;
+            coups = realloc(coups, capacite);
+            if (coups == NULL)
+            {
+                perror("realloc");
+                exit(EXIT_FAILURE);
+            }
+        }
+        if (fread(coups, 1, taille, fichier) != taille)
+        {
+            fprintf(stderr, "%s : partie %ld tronquée\n", nomFichier, nbParties);
+            nbDifferentes++;
+            break;
+        }
+
+        // Rejeu depuis initPlateau (dans initPartie) : chaque tour lit un coup par serpent en jeu.
+        size_t k = 0;
+        bool identique = initPartie(partie, (unsigned long)enregistree.graine);
+        while (identique && (partie->nbTours < (int)enregistree.nbTours))
+        {
+            for (int s = 0; s < nbSerpents; s++)
+            {
+                if (!VIVANTS(partie)[s])
+                {
+                    continue;
+                }
+                if (k >= enregistree.nbCoups)
+                {
+                    identique = false; // Plus de serpents en jeu qu'à l'enregistrement.
+                    break;
+                }
+                DECISIONS(partie)[s] = lesDirections[(coups[k / 4] >> (2 * (k % 4))) & 3];
+                k++;
+            }
+            if (identique)
+            {
+                appliquerTour(partie);
+            }
+        }
+        identique = identique && (k == enregistree.nbCoups) && (empreintePartie(partie) == enregistree.empreinte);
+        if (!identique)
+        {
+            fprintf(stderr, "Partie %ld (graine %llu) : état final différent de l'enregistrement\n",
+                    nbParties, (unsigned long long)enregistree.graine);
+            nbDifferentes++;
+        }
+        nbParties++;
+        nbToursTotal += partie->nbTours;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &fin);
+    fclose(fichier);
+    free(coups);
+    free(partie);
+
+    double duree = tempsEcoule(debut, fin);
+    printf("Parties rejouées : %ld (%ux%u, %u serpents), identiques : %ld, différentes : %ld\n", nbParties,
+           entete.largeur, entete.hauteur, entete.nbSerpents, nbParties - nbDifferentes, nbDifferentes);
+    printf("Durée : %.3f s, %.0f tours par seconde\n", duree, (duree > 0) ? nbToursTotal / duree : 0.0);
+    return nbDifferentes == 0;
+}
+
+
+/************************************************/
+/*		TOURNOI SUR PLUSIEURS PROCESSUS  		*/
+/************************************************/
+
+uint64_t aleatoireSuivant(uint64_t *etat) {
+    uint64_t z = (*etat += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+
+void jouerLots(tTournoi *tournoi) {
+    tPartie *partie = nouvellePartie();
+
+    for (;;)
+    {
+        long debut = __atomic_fetch_add(&tournoi->prochainePartie, TAILLE_LOT, __ATOMIC_RELAXED);
+        if (debut >= tournoi->nbParties)
+        {
+            free(partie);
+            return; // Plus aucun lot : le processus a fini.
+        }
+        long fin = (debut + TAILLE_LOT < tournoi->nbParties) ? debut + TAILLE_LOT : tournoi->nbParties;
+        for (long p = debut; p < fin; p++)
+        {
+            initPartie(partie, tournoi->graineInitiale + (unsigned long)p);
+            tournoi->lesResultats[p] = jouerPartie(partie, false);
+        }
+    }
+}
+
+
+bool lancerTournoi(long nbParties, int nbProcessus, unsigned long graine, const char *nomDetail) {
+    size_t taille = sizeof(tTournoi) + sizeof(tResultatPartie) * (size_t)nbParties;
+    struct timespec debut, fin;
+    bool reussi = true;
+
+    // Zone partagée : les processus créés par fork() y écrivent, le processus principal la lit ensuite.
+    tTournoi *tournoi = mmap(NULL, taille, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (tournoi == MAP_FAILED)
+    {
+        perror("mmap");
+        return false;
+    }
+    tournoi->prochainePartie = 0;
+    tournoi->nbParties = nbParties;
+    tournoi->graineInitiale = graine;
+
+    fflush(stdout); // Rien ne doit rester dans le tampon au moment du fork().
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    for (int i = 0; i < nbProcessus; i++)
+    {
+        pid_t pid = fork();
+        if (pid == 0)
+        {
+            jouerLots(tournoi);
+            _exit(journal.erreur ? EXIT_FAILURE : EXIT_SUCCESS); // Une partie perdue par le journal fait échouer le tournoi.
+        }
+        if (pid < 0)
+        {
+            perror("fork");
+            jouerLots(tournoi); // Les processus déjà lancés et celui-ci se partagent les parties restantes.
+            break;
+        }
+    }
+    int statut;
+    while (wait(&statut) > 0)
+    {
+        if (!WIFEXITED(statut) || (WEXITSTATUS(statut) != EXIT_SUCCESS))
+        {
+            reussi = false; // Un lot a pu rester inachevé.
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &fin);
+
+    // Bilan de toutes les graines
+    long nbGagnees = 0, nbCollisions = 0, nbLimites = 0, nbToursTotal = 0;
+    long pommes1 = 0, pommes2 = 0, pas1 = 0, pas2 = 0;
+    long victoires1 = 0, victoires2 = 0;
+    FILE *detail = NULL;
+
+    if (nomDetail != NULL)
+    {
+        detail = fopen(nomDetail, "w");
+        if (detail == NULL)
+        {
+            perror(nomDetail);
+            reussi = false;
+        }
+        else
+        {
+            fprintf(detail, "graine,tours,pommes1,pommes2,pas1,pas2,gagne,collision\n");
+        }
+    }
+    for (long p = 0; p < nbParties; p++)
+    {
+        const tResultatPartie *r = &tournoi->lesResultats[p];
+        // Une seule issue par partie : la dernière pomme peut être mangée au tour d'une collision, la partie est gagnée.
+        nbGagnees += r->gagne;
+        nbCollisions += !r->gagne && r->collision;
+        nbLimites += !r->gagne && !r->collision;
+        nbToursTotal += r->nbTours;
+        pommes1 += r->nbPommes1;
+        pommes2 += r->nbPommes2;
+        pas1 += r->nbPas1;
+        pas2 += r->nbPas2;
+        victoires1 += (r->nbPommes1 > r->nbPommes2);
+        victoires2 += (r->nbPommes2 > r->nbPommes1);
+        if (detail != NULL)
+        {
+            fprintf(detail, "%lu,%d,%d,%d,%d,%d,%d,%d\n", r->graine, r->nbTours, r->nbPommes1, r->nbPommes2,
+                    r->nbPas1, r->nbPas2, r->gagne, r->collision);
+        }
+    }
+    if ((detail != NULL) && (fclose(detail) != 0))
+    {
+        perror(nomDetail);
+        reussi = false;
+    }
+
+    double duree = tempsEcoule(debut, fin);
+    printf("Tournoi : %ld parties (graines %lu à %lu) sur %d processus\n",
+           nbParties, graine, graine + (unsigned long)nbParties - 1, nbProcessus);
+    printf("Parties complètes : %ld, perdues sur collision : %ld, limite de %d tours : %ld\n",
+           nbGagnees, nbCollisions, limiteTours, nbLimites);
+    printf("Victoires (plus de pommes) : serpent 1 = %ld, serpent 2 = %ld, égalités = %ld\n",
+           victoires1, victoires2, nbParties - victoires1 - victoires2);
+    printf("Pommes moyennes : serpent 1 = %.2f, serpent 2 = %.2f\n",
+           (double)pommes1 / nbParties, (double)pommes2 / nbParties);
+    printf("Pas par pomme : serpent 1 = %.1f, serpent 2 = %.1f\n",
+           (pommes1 > 0) ? (double)pas1 / pommes1 : 0.0, (pommes2 > 0) ? (double)pas2 / pommes2 : 0.0);
+    printf("Durée : %.3f s, %.0f parties par seconde, %.0f tours par seconde\n",
+           duree, (duree > 0) ? nbParties / duree : 0.0, (duree > 0) ? nbToursTotal / duree : 0.0);
+
+    munmap(tournoi, taille);
+    return reussi;
+}
+
+
+double tempsEcoule(struct timespec debut, struct timespec fin) {
+    return (fin.tv_sec - debut.tv_sec) + (fin.tv_nsec - debut.tv_nsec) / NANO_PAR_SECONDE;
+}
+
+
+void ajouterNanosecondes(struct timespec *instant, long nanosecondes) {
+    instant->tv_sec += nanosecondes / (long)NANO_PAR_SECONDE;
+    instant->tv_nsec += nanosecondes % (long)NANO_PAR_SECONDE;
+    if (instant->tv_nsec >= (long)NANO_PAR_SECONDE)
+    {
+        instant->tv_sec++;
+        instant->tv_nsec -= (long)NANO_PAR_SECONDE;
+    }
+}
+
+
+void demarrerOrdonnanceur(tOrdonnanceur *ordo) {
+    clock_gettime(CLOCK_MONOTONIC, &ordo->echeance);
+    ajouterNanosecondes(&ordo->echeance, ordo->periode);
+    ordo->enRetard = false;
+    ordo->nbTours = 0;
+    ordo->nbManquees = 0;
+    ordo->nbImagesSautees = 0;
+    ordo->nbAbandonnees = 0;
+    ordo->nbReveils = 0;
+    ordo->gigueTotale = 0;
+    ordo->gigueMax = 0;
+}
+
+
+void attendreProchainTour(tOrdonnanceur *ordo) {
+    struct timespec maintenant;
+
+    ordo->nbTours++;
+    clock_gettime(CLOCK_MONOTONIC, &maintenant);
+    double retard = tempsEcoule(ordo->echeance, maintenant) * NANO_PAR_SECONDE; // Négatif si l'échéance est à venir.
+
+    if (retard >= 0)
+    {
+        // Échéance dépassée : le tour a pris plus d'une période.
+        ordo->nbManquees++;
+        if (ordo->rattrapage && (retard < (double)MAX_RATTRAPAGE * ordo->periode))
+        {
+            // Rattrapage : le tour suivant est joué tout de suite, sans affichage, l'échéance suivante reste sur la grille.
+            ordo->enRetard = true;
+            ajouterNanosecondes(&ordo->echeance, ordo->periode);
+            return;
+        }
+        // Retard trop grand (ou rattrapage désactivé) : les échéances passées sont abandonnées
+        // et la grille reprend à la prochaine échéance encore à venir.
+        long nbSautees = (long)(retard / ordo->periode) + 1;
+        ordo->nbAbandonnees += nbSautees;
+        ajouterNanosecondes(&ordo->echeance, nbSautees * ordo->periode);
+    }
+
+    // Attente jusqu'à l'échéance absolue : une interruption par un signal reprend la même échéance.
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ordo->echeance, NULL) != 0)
+    {
+    }
+    clock_gettime(CLOCK_MONOTONIC, &maintenant);
+    double gigue = tempsEcoule(ordo->echeance, maintenant) * NANO_PAR_SECONDE; // Retard du réveil sur l'échéance.
+    ordo->nbReveils++;
+    ordo->gigueTotale += gigue;
+    if (gigue > ordo->gigueMax)
+    {
+        ordo->gigueMax = gigue;
+    }
+    ordo->enRetard = false;
+    ajouterNanosecondes(&ordo->echeance, ordo->periode);
+}
+
+
+#ifdef MESURE_PHASES
+void debutPhase(tPhase phase) {
+    clock_gettime(CLOCK_MONOTONIC, &lesMesures[phase].debutMur);
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &lesMesures[phase].debutCpu);
+}
+
+
+void finPhase(tPhase phase) {
+    tMesurePhase *mesure = &lesMesures[phase];
+    struct timespec finMur, finCpu;
+
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &finCpu);
+    clock_gettime(CLOCK_MONOTONIC, &finMur);
+    double dureeMur = tempsEcoule(mesure->debutMur, finMur) * NANO_PAR_SECONDE;
+    mesure->nbMesures++;
+    mesure->totalMur += dureeMur;
+    mesure->totalCpu += tempsEcoule(mesure->debutCpu, finCpu) * NANO_PAR_SECONDE;
+    if (dureeMur > mesure->maxMur)
+    {
+        mesure->maxMur = dureeMur;
+    }
+    mesure->histogramme[classeDuree((unsigned long long)dureeMur)]++;
+}
+
+
+int classeDuree(unsigned long long duree) {
+    // Les 16 premières nanosecondes ont chacune leur classe ; au-delà, chaque puissance de 2
+    // est découpée en 16 classes d'après les 4 bits qui suivent le bit de poids fort.
+    if (duree < 16)
+    {
+        return (int)duree;
+    }
+    int exposant = 63 - __builtin_clzll(duree);
+    return (exposant - 3) * 16 + (int)((duree >> (exposant - 4)) & 15);
+}
+
+
+double dureeClasse(int classe) {
+    if (classe < 16)
+    {
+        return classe;
+    }
+    return (double)(16 + classe % 16) * (double)(1ULL << (classe / 16 + 3 - 4));
+}
+
+
+double centilePhase(const tMesurePhase *mesure, double centile) {
+    long rang = (long)(centile / 100.0 * mesure->nbMesures); // Nombre de mesures plus courtes que le centile.
+    long cumul = 0;
+
+    for (int c = 0; c < NB_CLASSES_DUREE; c++)
+    {
+        cumul += mesure->histogramme[c];
+        if (cumul > rang)
+        {
+            return dureeClasse(c);
+        }
+    }
+    return mesure->maxMur;
+}
+
+
+void afficherMesuresPhases(void) {
+    printf("Phase           Mesures   Réel (s)    CPU (s)  Moy. (µs)   p50 (µs)   p90 (µs)   p99 (µs)   Max (µs)\n");
+    for (int p = 0; p < NB_PHASES; p++)
+    {
+        const tMesurePhase *mesure = &lesMesures[p];
+        if (mesure->nbMesures == 0)
+        {
+            continue; // Phase jamais exécutée (par exemple l'attente en mode sans affichage).
+        }
+        int largeurNom = 12; // printf compte des octets : on ajoute les octets de suite des lettres accentuées.
+        for (const char *c = lesNomsPhases[p]; *c != '\0'; c++)
+        {
+            largeurNom += ((*c & 0xC0) == 0x80);
+        }
+        printf("%-*s %10ld %10.3f %10.3f %10.2f %10.2f %10.2f %10.2f %10.2f\n", largeurNom, lesNomsPhases[p],
+               mesure->nbMesures, mesure->totalMur / NANO_PAR_SECONDE, mesure->totalCpu / NANO_PAR_SECONDE,
+               mesure->totalMur / mesure->nbMesures / 1000, centilePhase(mesure, 50) / 1000,
+               centilePhase(mesure, 90) / 1000, centilePhase(mesure, 99) / 1000, mesure->maxMur / 1000);
+    }
+}
+#endif
+
+
+void afficherBilanOrdonnanceur(const tOrdonnanceur *ordo, int ligne) {
+    gotoxy(2, ligne);
+    printf("Tours : %ld de %ld µs, échéances manquées : %ld, images sautées : %ld, échéances abandonnées : %ld\n",
+           ordo->nbTours, ordo->periode / 1000, ordo->nbManquees, ordo->nbImagesSautees, ordo->nbAbandonnees);
+    gotoxy(2, ligne + 1);
+    printf("Gigue du réveil : moyenne %.1f µs, max %.1f µs\n",
+           (ordo->nbReveils > 0) ? ordo->gigueTotale / ordo->nbReveils / 1000 : 0.0, ordo->gigueMax / 1000);
+}
+
+/************************************************/
+/*		FONCTIONS ET PROCEDURES DU JEU 			*/
+/************************************************/
+
+void initDimensions(int largeur, int hauteur)
+{
+    largeurPlateau = largeur;
+    hauteurPlateau = hauteur;
+    pasLigne = (largeur + 2 + ALIGNEMENT_CASES - 1) / ALIGNEMENT_CASES * ALIGNEMENT_CASES; // Chaque ligne commence sur une ligne de cache.
+    nbCasesMemoire = pasLigne * (hauteur + 2);
+    limiteTours = MAX_TOURS * (largeur + hauteur) / (LARGEUR_PLATEAU + HAUTEUR_PLATEAU);
+
+    lesDecalages[0] = -pasLigne; // HAUT
+    lesDecalages[1] = pasLigne; // BAS
+    lesDecalages[2] = -1; // GAUCHE
+    lesDecalages[3] = 1; // DROITE
+
+    // Chaque trou du bord mène au trou opposé (mêmes trous que initPlateau)
+    lesSortiesPortail[0] = CASE(largeur + 1, hauteur / 2);  lesArriveesPortail[0] = CASE(1, hauteur / 2);
+    lesSortiesPortail[1] = CASE(0, hauteur / 2);  lesArriveesPortail[1] = CASE(largeur, hauteur / 2);
+    lesSortiesPortail[2] = CASE(largeur / 2, 0);  lesArriveesPortail[2] = CASE(largeur / 2, hauteur);
+    lesSortiesPortail[3] = CASE(largeur / 2, hauteur + 1);  lesArriveesPortail[3] = CASE(largeur / 2, 1);
+
+    TROU_HAUT = (Portail){largeur / 2, 0};
+    TROU_BAS = (Portail){largeur / 2, hauteur};
+    TROU_GAUCHE = (Portail){0, hauteur / 2};
+    TROU_DROITE = (Portail){largeur, hauteur / 2};
+
+    // Pommes et pavés gardent leur place relative ; les pavés gardent leur taille.
+    for (int i = 0; i < NB_POMMES; i++)
+    {
+        lesPommesX[i] = echelleX(lesPommesX[i]);
+        lesPommesY[i] = echelleY(lesPommesY[i]);
+    }
+    for (int p = 0; p < NB_PAVES; p++)
+    {
+        lesPavesX[p] = echelleX(lesPavesX[p]);
+        lesPavesY[p] = echelleY(lesPavesY[p]);
+    }
+}
+
+
+int echelleX(int x)
+{
+    return 1 + (int)((long long)(x - 1) * (largeurPlateau - 1) / (LARGEUR_PLATEAU - 1)); // Identité sur le plateau de référence.
+}
+
+
+int echelleY(int y)
+{
+    return 1 + (int)((long long)(y - 1) * (hauteurPlateau - 1) / (HAUTEUR_PLATEAU - 1));
+}
+
+
+void *allouerCases(size_t tailleCase)
+{
+    size_t taille = (size_t)nbCasesMemoire * tailleCase;
+    void *cases = aligned_alloc(ALIGNEMENT_CASES, (taille + ALIGNEMENT_CASES - 1) / ALIGNEMENT_CASES * ALIGNEMENT_CASES);
+
+    if (cases == NULL)
+    {
+        perror("aligned_alloc");
+        exit(EXIT_FAILURE);
+    }
+    return cases;
+}
+
+
+int caseVoisine(tPlateau plateau, int c, int d)
+{
+    int v = c + lesDecalages[d];
+
+    if (plateau[v] == SORTIE_PORTAIL) // Seul cas particulier : la case de garde devant un trou.
+    {
+        for (int k = 0; k < 4; k++)
+        {
+            if (lesSortiesPortail[k] == v)
+            {
+                return lesArriveesPortail[k];
+            }
+        }
+    }
+    return v;
+}
+
+
+void initPlateau(tPartie *partie)
+{
+    tPlateau plateau = PLATEAU(partie);
+    int i, j;
+
+    // Cases de garde bloquantes autour du plateau, puis espaces vides à l'intérieur
+    memset(plateau, BORDURE, nbCasesMemoire);
+    for (j = 1 ; j <= hauteurPlateau ; j++)  // Pour chaque ligne
+    {
+        memset(&plateau[CASE(1, j)], VIDE, largeurPlateau);  // Remplissage de la ligne avec des espaces vides
+    }
+
+    // Mise en place de la bordure autour du plateau
+    // Première ligne : en haut
+    for (i = 1 ; i <= largeurPlateau ; i++)
+    {
+        plateau[CASE(i, 1)] = BORDURE;  // Bordure sur la première ligne (haut)
+    }
+
+    // Lignes intermédiaires : les deux bords verticaux
+    for (j = 1 ; j <= hauteurPlateau ; j++)
+    {
+        plateau[CASE(1, j)] = BORDURE;  // Bordure sur le côté gauche
+        plateau[CASE(largeurPlateau, j)] = BORDURE;  // Bordure sur le côté droit
+    }
+
+    // Dernière ligne : en bas
+    for (i = 1; i <= largeurPlateau ; i++)
+    {
+        plateau[CASE(i, hauteurPlateau)] = BORDURE;  // Bordure sur la dernière ligne (bas)
+    }
+
+    // Suppression de certaines bordures pour créer des "trous" (portails)
+    plateau[CASE(largeurPlateau, hauteurPlateau / 2)] = VIDE;  // Trou en bas à droite
+    plateau[CASE(largeurPlateau / 2, hauteurPlateau)] = VIDE;  // Trou en bas au centre
+    plateau[CASE(largeurPlateau / 2, 1)] = VIDE;  // Trou en haut au centre
+    plateau[CASE(1, hauteurPlateau / 2)] = VIDE;  // Trou en haut à droite
+    for (int k = 0; k < 4; k++)
+    {
+        plateau[lesSortiesPortail[k]] = SORTIE_PORTAIL;  // La garde devant un trou mène au trou opposé.
+    }
+
+    placerPaves(partie); // Placement des pavés
+}
+
+
+void dessinerPlateau(tPlateau plateau)
+{
+    for (int j = 1; j <= hauteurPlateau; j++)  // Parcourt les lignes, dans l'ordre du tampon
+    {
+        for (int i = 1; i <= largeurPlateau; i++)  // Parcourt les colonnes
+        {
+            afficher(i, j, plateau[CASE(i, j)]);  // Appelle la fonction afficher pour chaque case
+        }
+    }
+}
+
+
+void ajouterPomme(tPartie *partie)
+{
+    // Génère la position de la pomme à partir des tableaux de positions, ou d'une case libre tirée au hasard
+    int Pomme = partie->nbPommesMangees;
+    if (sourcePommes == POMMES_ALEATOIRES)
+    {
+        int c = tirerCaseLibre(partie);
+        if (c >= 0) // Plateau plein : la pomme garde sa place du calendrier fixe.
+        {
+            partie->lesPommesX[Pomme] = X_CASE(c);
+            partie->lesPommesY[Pomme] = Y_CASE(c);
+        }
+    }
+    PLATEAU(partie)[CASE(partie->lesPommesX[Pomme], partie->lesPommesY[Pomme])] = POMME;  // Place la pomme sur le plateau
+    afficher(partie->lesPommesX[Pomme], partie->lesPommesY[Pomme], POMME);  // Affiche la pomme à l'écran
+}
+
+
+void initCasesLibres(tPartie *partie)
+{
+    if (sourcePommes != POMMES_ALEATOIRES)
+    {
+        return;
+    }
+    tPlateau plateau = PLATEAU(partie);
+    int *casesLibres = CASES_LIBRES(partie);
+    int *rangLibre = RANG_LIBRE(partie);
+
+    partie->nbCasesLibres = 0;
+    for (int c = 0; c < nbCasesMemoire; c++)
+    {
+        rangLibre[c] = -1;
+        if (((plateau[c] == VIDE) || (plateau[c] == POMME)) && (OCCUPATION(partie)[c] == 0))
+        {
+            rangLibre[c] = partie->nbCasesLibres;
+            casesLibres[partie->nbCasesLibres++] = c;
+        }
+    }
+}
+
+
+void occuperCase(tPartie *partie, int c)
+{
+    if ((OCCUPATION(partie)[c]++ == 0) && (sourcePommes == POMMES_ALEATOIRES) && (RANG_LIBRE(partie)[c] >= 0))
+    {
+        // Retrait en temps constant : la dernière case de la liste prend la place de celle qui s'en va.
+        int *casesLibres = CASES_LIBRES(partie);
+        int *rangLibre = RANG_LIBRE(partie);
+        int derniere = casesLibres[--partie->nbCasesLibres];
+        casesLibres[rangLibre[c]] = derniere;
+        rangLibre[derniere] = rangLibre[c];
+        rangLibre[c] = -1;
+    }
+}
+
+
+void libererCase(tPartie *partie, int c)
+{
+    tPlateau plateau = PLATEAU(partie);
+
+    // Une tête qui a heurté une bordure ou un pavé n'en fait pas une case libre en repartant.
+    if ((--OCCUPATION(partie)[c] == 0) && (sourcePommes == POMMES_ALEATOIRES) && ((plateau[c] == VIDE) || (plateau[c] == POMME)))
+    {
+        RANG_LIBRE(partie)[c] = partie->nbCasesLibres;
+        CASES_LIBRES(partie)[partie->nbCasesLibres++] = c;
+    }
+}
+
+
+int tirerCaseLibre(tPartie *partie)
+{
+    if (partie->nbCasesLibres == 0)
+    {
+        return -1;
+    }
+    // Produit de 32 bits aléatoires par le nombre de cases, plutôt qu'un modulo : pas de division.
+    uint64_t tirage = aleatoireSuivant(&partie->alea) >> 32;
+    return CASES_LIBRES(partie)[(tirage * (uint64_t)partie->nbCasesLibres) >> 32];
+}
+
+
+void afficher(int x, int y, char car)
+{
+    afficherCase(CASE(x, y), car);
+}
+
+
+void afficherCase(int c, char car)
+{
+    if (!affichageActif || enRecherche)
+    {
+        return; // Mode simulation, ou simulations d'une recherche : rien n'est écrit dans le terminal.
+    }
+    ecran.voulu[c] = car;  // Le terminal n'est mis à jour qu'au prochain rafraichirEcran().
+    if (!ecran.estSale[c])
+    {
+        ecran.estSale[c] = true;
+        ecran.lesSales[ecran.nbSales++] = c;
+    }
+}
+
+
+void effacer(int x, int y)
+{
+    afficher(x, y, VIDE);  // Efface la case en affichant un espace vide
+}
+
+
+void initEcran(void)
+{
+    if (ecran.voulu == NULL)
+    {
+        ecran.voulu = allouerCases(sizeof(char));
+        ecran.affiche = allouerCases(sizeof(char));
+        ecran.estSale = allouerCases(sizeof(bool));
+        ecran.lesSales = allouerCases(sizeof(int));
+    }
+
+    // Après l'effacement du terminal, l'image affichée est entièrement vide.
+    memset(ecran.voulu, VIDE, nbCasesMemoire);
+    memset(ecran.affiche, VIDE, nbCasesMemoire);
+    memset(ecran.estSale, false, nbCasesMemoire * sizeof(bool));
+    memset(ecran.panneau, '\0', sizeof(ecran.panneau));
+    ecran.nbSales = 0;
+    ecran.tailleSortie = 0;
+    ajouterSortie("\033[2J", 4);
+}
+
+
+void ecrireTexte(int x, int y, const char *format, ...)
+{
+    char texte[LONGUEUR_PANNEAU];
+    va_list arguments;
+
+    va_start(arguments, format);
+    vsnprintf(texte, sizeof(texte), format, arguments);
+    va_end(arguments);
+
+    if ((y >= NB_LIGNES_PANNEAU) || (strcmp(texte, ecran.panneau[y]) == 0))
+    {
+        return; // Texte inchangé : rien à réécrire.
+    }
+    strcpy(ecran.panneau[y], texte);
+    deplacerCurseur(x, y);
+    ajouterSortie(texte, strlen(texte));
+}
+
+
+void ajouterSortie(const char *texte, int longueur)
+{
+    if (ecran.tailleSortie + longueur > TAILLE_SORTIE)
+    {
+        rafraichirEcran(); // Tampon plein : on envoie ce qui est prêt avant de continuer.
+    }
+    memcpy(ecran.sortie + ecran.tailleSortie, texte, longueur);
+    ecran.tailleSortie += longueur;
+}
+
+
+void deplacerCurseur(int x, int y)
+{
+    char sequence[16];
+    int longueur = snprintf(sequence, sizeof(sequence), "\033[%d;%df", y, x);
+    ajouterSortie(sequence, longueur);
+}
+
+
+void rafraichirEcran(void)
+{
+    // Position du curseur après le dernier caractère écrit : un caractère voisin sur la même ligne
+    // s'écrit sans nouvelle séquence de déplacement.
+    int curseurX = -1;
+    int curseurY = -1;
+    int nbSales = ecran.nbSales;
+
+    ecran.nbSales = 0; // ajouterSortie peut rappeler rafraichirEcran quand le tampon est plein.
+    for (int i = 0; i < nbSales; i++)
+    {
+        int c = ecran.lesSales[i];
+        int x = c % pasLigne;
+        int y = c / pasLigne;
+        ecran.estSale[c] = false;
+        if (ecran.voulu[c] == ecran.affiche[c])
+        {
+            continue; // Case revenue à son état affiché (par exemple une queue effacée puis réoccupée).
+        }
+        if ((x != curseurX) || (y != curseurY))
+        {
+            deplacerCurseur(x, y);
+        }
+        ajouterSortie(&ecran.voulu[c], 1);
+        ecran.affiche[c] = ecran.voulu[c];
+        curseurX = x + 1;
+        curseurY = y;
+    }
+
+    if (ecran.tailleSortie == 0)
+    {
+        return; // Rien n'a changé : aucun appel système.
+    }
+    if (nbSales > 0)
+    {
+        deplacerCurseur(1, 1); // Remet le curseur en haut à gauche de l'écran
+    }
+
+    int envoye = 0;
+    while (envoye < ecran.tailleSortie)
+    {
+        ssize_t n = write(sortieEcran, ecran.sortie + envoye, ecran.tailleSortie - envoye);
+        if (n < 0)
+        {
+            break; // Terminal fermé : l'image est perdue, le jeu continue.
+        }
+        envoye += n;
+    }
+    ecran.tailleSortie = 0;
+}
+
+
+void initSerpent(tPartie *partie, int s, int xTete, int yTete, int sens)
+{
+    int *anneaux = ANNEAUX(partie) + s * TAILLE_MAX;
+
+    // Le dernier anneau est rangé en 0 et la tête en TAILLE - 1 : le tampon se remplit ensuite vers l'avant.
+    for (int i = 0; i < TAILLE; i++)
+    {
+        anneaux[TAILLE - 1 - i] = CASE(xTete - sens * i, yTete);  // Position de chaque partie du serpent.
+        OCCUPATION(partie)[anneaux[TAILLE - 1 - i]]++;  // La case est occupée par un anneau.
+    }
+    TETES(partie)[s] = TAILLE - 1;
+    TETE_SUR(partie)[anneaux[TAILLE - 1]] = s + 1;
+    LONGUEURS(partie)[s] = TAILLE;
+    A_GRANDIR(partie)[s] = 0;
+    DIRECTIONS(partie)[s] = (sens > 0) ? DROITE : GAUCHE; // Le serpent part du côté de sa tête.
+    VIVANTS(partie)[s] = true;
+}
+
+
+int caseAnneau(const tPartie *partie, int s, int i)
+{
+    return ANNEAUX(partie)[s * TAILLE_MAX + ((TETES(partie)[s] - i) & (TAILLE_MAX - 1))]; // TAILLE_MAX est une puissance de 2 : le masque remplace le modulo.
+}
+
+
+void grandirSerpent(tPartie *partie, int s, int nbAnneaux)
+{
+    A_GRANDIR(partie)[s] += nbAnneaux; // Les anneaux sont ajoutés un par un, en gardant la queue sur place.
+}
+
+
+char caractereTete(int s)
+{
+    if (s == 0)
+    {
+        return TETE;
+    }
+    if (s == 1)
+    {
+        return TETE2;
+    }
+    if (s < 9)
+    {
+        return '1' + s;
+    }
+    return (s < 9 + 26) ? 'A' + (s - 9) : TETE_AUTRE;
+}
+
+
+void dessinerSerpent(const tPartie *partie, int s)
+{
+    // Affiche les anneaux du serpent
+    for (int i = 1; i < LONGUEURS(partie)[s]; i++)  // Parcourt le serpent 
+    {
+        afficherCase(caseAnneau(partie, s, i), CORPS);  // Affiche un segment du serpent (corps)
+    }
+    afficherCase(caseAnneau(partie, s, 0), caractereTete(s));  // Affiche la tête du serpent
+}
+
+
+void avancerQueue(tPartie *partie, int s)
+{
+    if ((A_GRANDIR(partie)[s] > 0) && (LONGUEURS(partie)[s] < TAILLE_MAX))
+    {
+        LONGUEURS(partie)[s]++; // La queue reste en place : le serpent grandit d'un anneau.
+        A_GRANDIR(partie)[s]--;
+    }
+    else
+    {
+        int queue = caseAnneau(partie, s, LONGUEURS(partie)[s] - 1);
+        libererCase(partie, queue); // La queue libère sa case.
+        partie->zobrist ^= cleZobrist(CLE_CORPS, s, queue);
+        if (OCCUPATION(partie)[queue] == 0)
+        {
+            afficherCase(queue, PLATEAU(partie)[queue]); // Efface le dernier segment du serpent
+        }
+    }
+    LONGUEURS(partie)[s]--; // La nouvelle tête reprend cet anneau dans avancerTete.
+}
+
+
+void avancerTete(tPartie *partie, int s, int c)
+{
+    int ancienneTete = caseAnneau(partie, s, 0);
+
+    occuperCase(partie, c);
+    partie->zobrist ^= cleZobrist(CLE_CORPS, s, c) ^ cleZobrist(CLE_TETE, s, ancienneTete) ^ cleZobrist(CLE_TETE, s, c);
+    TETES(partie)[s] = (TETES(partie)[s] + 1) & (TAILLE_MAX - 1); // La case libérée par la queue reçoit la nouvelle tête.
+    ANNEAUX(partie)[s * TAILLE_MAX + TETES(partie)[s]] = c;
+    LONGUEURS(partie)[s]++;
+    if (TETE_SUR(partie)[ancienneTete] == s + 1)
+    {
+        TETE_SUR(partie)[ancienneTete] = 0; // Une autre tête a pu y entrer pendant ce tour.
+    }
+    TETE_SUR(partie)[c] = s + 1;
+
+    // Seules l'ancienne tête (devenue corps) et la nouvelle tête changent à l'écran.
+    afficherCase(ancienneTete, CORPS);
+    afficherCase(c, caractereTete(s));
+}
+
+
+void retirerSerpent(tPartie *partie, int s)
+{
+    if (TETE_SUR(partie)[caseAnneau(partie, s, 0)] == s + 1)
+    {
+        TETE_SUR(partie)[caseAnneau(partie, s, 0)] = 0;
+    }
+    partie->zobrist ^= cleZobrist(CLE_TETE, s, caseAnneau(partie, s, 0));
+    for (int i = 0; i < LONGUEURS(partie)[s]; i++)
+    {
+        int c = caseAnneau(partie, s, i);
+        libererCase(partie, c);
+        partie->zobrist ^= cleZobrist(CLE_CORPS, s, c);
+        if (OCCUPATION(partie)[c] == 0)
+        {
+            afficherCase(c, PLATEAU(partie)[c]); // Case rendue au plateau (vide, pomme, bordure ou pavé heurté).
+        }
+    }
+    LONGUEURS(partie)[s] = 0;
+}
+
+
+int progresser(tPartie *partie) {
+    // Règles du déplacement simultané, indépendantes de l'ordre des serpents :
+    // 1. toutes les queues avancent d'abord : une tête peut entrer dans la case que quitte n'importe quelle queue ;
+    // 2. puis toutes les têtes avancent dans la direction décidée ;
+    // 3. une fois toutes les têtes posées, un serpent sort du jeu si sa tête partage sa case avec un autre anneau
+    //    (deux têtes sur la même case se heurtent toutes les deux, deux têtes qui échangent leurs cases aussi),
+    //    ou si elle est sur une bordure ou un pavé ;
+    // 4. la pomme revient au seul serpent dont la tête l'atteint ; si plusieurs l'atteignent, personne ne la mange.
+    tPlateau plateau = PLATEAU(partie);
+    const unsigned char *occupation = OCCUPATION(partie);
+    bool *vivants = VIVANTS(partie);
+    int casePomme = CASE(partie->lesPommesX[partie->nbPommesMangees], partie->lesPommesY[partie->nbPommesMangees]);
+    int mangeur = -1;
+    int nbSurPomme = 0; // Nombre de têtes arrivées sur la pomme.
+
+    for (int s = 0; s < nbSerpents; s++)
+    {
+        if (vivants[s])
+        {
+            avancerQueue(partie, s);
+        }
+    }
+
+    for (int s = 0; s < nbSerpents; s++)
+    {
+        if (!vivants[s])
+        {
+            continue;
+        }
+        // Case de la future tête : la case de garde devant un trou fait ressortir de l'autre côté du plateau.
+        int c = caseVoisine(plateau, caseAnneau(partie, s, 0), codeDirection(DECISIONS(partie)[s]));
+        DIRECTIONS(partie)[s] = DECISIONS(partie)[s];
+        avancerTete(partie, s, c); // Ecrit la nouvelle tête
+        PAS_SERPENTS(partie)[s]++; // Incrémente le compteur de déplacements
+        if (c == casePomme) // Vérifie si la tête est sur la pomme
+        {
+            nbSurPomme++;
+            mangeur = s;
+        }
+    }
+
+    for (int s = 0; s < nbSerpents; s++)
+    {
+        if (!vivants[s])
+        {
+            continue;
+        }
+        int c = caseAnneau(partie, s, 0);
+        // Collision avec un autre anneau (du serpent lui-même ou d'un autre), une bordure ou un pavé
+        if ((occupation[c] > 1) || (plateau[c] == BORDURE) || estSurPave(partie, c))
+        {
+            vivants[s] = false; // Le corps reste en place jusqu'à la fin du tour.
+            partie->nbVivants--;
+            partie->collision = true;
+        }
+    }
+
+    if (nbSurPomme != 1)
+    {
+        return -1; // Pomme non atteinte, ou disputée : elle reste en place.
+    }
+    plateau[casePomme] = VIDE; // Retire la pomme du plateau quand elle est mangée
+    return mangeur;
+}
+
+
+char trouverDirectionSure(const tPartie *partie, int s, char directionActuelle) {
+    int c = caseAnneau(partie, s, 0); // Case de la tête du serpent.
+
+    // Vérifie si la direction actuelle est sûre
+    if (directionEstSure(partie, c, directionActuelle)) 
+    { 
+        return directionActuelle; // Retourne la direction actuelle si elle est sûre
+    }
+    // Vérifie si aller à gauche est sûr
+    if (directionEstSure(partie, c, GAUCHE)) 
+    { 
+        return GAUCHE; // Retourne GAUCHE si elle est sûre
+    }
+    // Vérifie si aller à droite est sûr
+    if (directionEstSure(partie, c, DROITE))
+    {
+        return DROITE; // Retourne DROITE si elle est sûre
+    }
+    // Vérifie si aller en haut est sûr
+    if (directionEstSure(partie, c, HAUT)) 
+    { 
+        return HAUT; // Retourne HAUT si elle est sûre
+    }
+    // Vérifie si aller en bas est sûr
+    if (directionEstSure(partie, c, BAS)) 
+    { 
+        return BAS; // Retourne BAS si elle est sûre
+    }
+    return directionActuelle; // Si aucune direction n'est sûre, retourne la direction actuelle
+}
+
+
+bool estSurUnSerpent(const tPartie *partie, int c) {   // Vérifie si une case est occupée par un serpent
+    return OCCUPATION(partie)[c] != 0; // Une seule lecture, quelle que soit la longueur des serpents
+}
+
+
+int minimunTableau(tChemins Tableau){
+    int minDistance = Tableau[0];
+    int minDistanceI = 0;
+    
+    for (int i = 0; i < 5; i++)
+    {
+        if (minDistance > Tableau[i]) // Si une distance plus courte est trouvée
+        {
+            minDistance = Tableau[i]; // Met à jour la distance minimale
+            minDistanceI = i;     // Met à jour l'index du chemin le plus court
+        }
+    }
+    return minDistanceI;
+}
+
+
+char directionHeuristique(const tPartie *partie, int s, char direction, bool verticalDabord, int ligneAffichage) {
+    int xTete = X_CASE(caseAnneau(partie, s, 0)); // Position de la tête du serpent.
+    int yTete = Y_CASE(caseAnneau(partie, s, 0));
+    int pommeX = partie->lesPommesX[partie->nbPommesMangees];
+    int pommeY = partie->lesPommesY[partie->nbPommesMangees];
 
-        gotoxy(2+LARGEUR_PLATEAU, 13);
-		printf("Nombre de pommes mangée Serpent 1 : %d\n", NbPommesSerpentManger );
-        gotoxy(2+LARGEUR_PLATEAU, 14);
-		printf("Nombre de pommes mangée Serpent 2 : %d\n", NbPommesSerpentManger2);
-	} while ( (touche != STOP) && !collision && !gagne); // La boucle continue tant que l'utilisateur n'appuie pas sur STOP, qu'il n'y a pas de collision et que toutes les pommes ne sont pas mangées.
-    
+    int CheminDirectPomme = abs(xTete - pommeX) + abs(yTete - pommeY); // Calcul de la distance directe entre la tête du serpent et la pomme
 
-    enable_echo(); // Réactive l'affichage des touches.
-	gotoxy(LARGEUR_PLATEAU+1, 1); // Déplace le curseur en dehors du plateau de jeu.
-	if (gagne)
-	{
-		enable_echo();
-		gotoxy(2, HAUTEUR_PLATEAU+1);
-		printf("Compteur de pas pour le Serpent 1 : %d et le nombre de pommes mangée %d \n", nbDepUnitaires, NbPommesSerpentManger);// Affiche les performances du programme.
-        gotoxy(2,HAUTEUR_PLATEAU+2);
-		printf("Compteur de pas pour le Serpent 2 : %d et le nombre de pommes mangée %d \n", nbDepUnitaires2, NbPommesSerpentManger2);// Affiche les performances du programme.
+    // Calcul des distances en passant par différents portails (haut, bas, gauche, droite)
+    // Chaque chemin nécessite de passer par un portail et d'en sortir de l'autre côté avant d'atteindre la pomme.
+    int CheminPortailHaut = abs(xTete - TROU_HAUT.x) + abs(yTete - TROU_HAUT.y) + abs(pommeX - TROU_BAS.x) + abs(pommeY - TROU_BAS.y);
+    int CheminPortailBas = abs(xTete - TROU_BAS.x) + abs(yTete - TROU_BAS.y) + abs(pommeX - TROU_HAUT.x) + abs(pommeY - TROU_HAUT.y);
+    int CheminPortailGauche = abs(xTete - TROU_GAUCHE.x) + abs(yTete - TROU_GAUCHE.y) + abs(pommeX - TROU_DROITE.x) + abs(pommeY - TROU_DROITE.y);
+    int CheminPortailDroite = abs(xTete - TROU_DROITE.x) + abs(yTete - TROU_DROITE.y) + abs(pommeX - TROU_GAUCHE.x) + abs(pommeY - TROU_GAUCHE.y);
 
-	}
-	return EXIT_SUCCESS;
+    // Tableau contenant les distances calculées pour chaque chemin
+    tChemins Tableau = {CheminDirectPomme, CheminPortailHaut, CheminPortailBas, CheminPortailGauche, CheminPortailDroite};
+    const Portail *lesPortails[5] = {NULL, &TROU_HAUT, &TROU_BAS, &TROU_GAUCHE, &TROU_DROITE}; // Portail à rejoindre pour chaque chemin.
+
+    // Affichage pour moi, pour comprendre comment les distances fonctionnent.
+    if (affichageActif && !enRecherche && (s < 2))
+    {
+        ecrireTexte(2+largeurPlateau, ligneAffichage, "Distance Pomme : %4d pas", CheminDirectPomme);
+        ecrireTexte(2+largeurPlateau, ligneAffichage + 1, "Distance Portail Haut + Pomme : %4d pas", CheminPortailHaut);
+        ecrireTexte(2+largeurPlateau, ligneAffichage + 2, "Distance Portail Bas + Pomme : %4d pas", CheminPortailBas);
+        ecrireTexte(2+largeurPlateau, ligneAffichage + 3, "Distance Portail Gauche + Pomme : %4d pas", CheminPortailGauche);
+        ecrireTexte(2+largeurPlateau, ligneAffichage + 4, "Distance Portail Droit + Pomme : %4d pas", CheminPortailDroite);
+    }
+
+    int minimunDes5distances = minimunTableau(Tableau); // Calcule la minimun des distances pour atteindre la pomme.
+
+    // Cas 0 : chemin direct vers la pomme. Cas 1 à 4 : le serpent rejoint d'abord le portail,
+    // puis, une fois passé, se dirige directement vers la pomme.
+    if (minimunDes5distances != 0)
+    {
+        direction = directionVers(xTete, yTete, lesPortails[minimunDes5distances]->x, lesPortails[minimunDes5distances]->y, verticalDabord);
+    }
+    else
+    {
+        direction = directionVers(xTete, yTete, pommeX, pommeY, verticalDabord);
+    }
+    return direction;
 }
 
-/************************************************/
-/*		FONCTIONS ET PROCEDURES DU JEU 			*/
-/************************************************/
 
-void initPlateau(tPlateau plateau)
-{
-    int i, j;
+char directionVers(int x, int y, int cibleX, int cibleY, bool verticalDabord) {
+    char direction;
 
-    // Initialisation du plateau avec des espaces vides
-    for (i = 1 ; i <= LARGEUR_PLATEAU ; i++)  // Pour chaque colonne
+    if (verticalDabord)
+    {
+        if ((cibleY - y) < 0)
+        {
+            direction = HAUT; // La cible est au-dessus de la tête du serpent.
+        }
+        else if ((cibleY - y) > 0)
+        {
+            direction = BAS; // La cible est en-dessous de la tête du serpent.
+        }
+        else if ((cibleX - x) < 0)
+        {
+            direction = GAUCHE; // La cible est à gauche de la tête du serpent.
+        }
+        else
+        {
+            direction = DROITE; // La cible est à droite de la tête du serpent.
+        }
+    }
+    else
     {
-        for (int j = 1 ; j <= HAUTEUR_PLATEAU ; j++)  // Pour chaque ligne
+        if ((cibleX - x) < 0)
+        {
+            direction = GAUCHE; // La cible est à gauche de la tête du serpent.
+        }
+        else if ((cibleX - x) > 0)
+        {
+            direction = DROITE; // La cible est à droite de la tête du serpent.
+        }
+        else if ((cibleY - y) < 0)
         {
-            plateau[i][j] = VIDE;  // Remplissage de la case avec un espace vide
+            direction = HAUT; // La cible est au-dessus de la tête du serpent.
+        }
+        else
+        {
+            direction = BAS; // La cible est en-dessous de la tête du serpent.
         }
     }
+    return direction;
+}
 
-    // Mise en place de la bordure autour du plateau
-    // Première ligne : en haut
-    for (i = 1 ; i <= LARGEUR_PLATEAU ; i++)
+
+char directionPlusCourtChemin(const tPartie *partie, int s, int caseCible, char directionActuelle) {
+    // Parcours en largeur depuis la tête. Les cases du plateau sont les sommets du graphe ; deux cases voisines
+    // sont reliées, et la case de garde devant un trou relie la case au trou opposé (caseVoisine).
+    // Bordures, pavés et anneaux des serpents sont bloquants. Chaque case retient le premier pas qui y mène :
+    // dès que la pomme est atteinte, ce premier pas est la direction à prendre.
+    // Tampons propres à chaque fil d'exécution : des parties jouées en parallèle ne se gênent pas.
+    static _Thread_local int *file = NULL; // File des cases à visiter (indices CASE(x, y)).
+    static _Thread_local uint32_t *visite = NULL; // generation * 4 + premier pas (0 HAUT, 1 BAS, 2 GAUCHE, 3 DROITE) : une seule lecture par case.
+    static _Thread_local uint32_t generation = 0; // Case visitée si visite >> 2 == generation (évite de tout remettre à zéro).
+    tPlateau plateau = PLATEAU(partie);
+    const unsigned char *occupation = OCCUPATION(partie);
+    const char lesDirections[4] = {HAUT, BAS, GAUCHE, DROITE};
+    int debut = 0;
+    int fin = 0;
+
+    int caseTete = caseAnneau(partie, s, 0);
+
+    // Sur le plateau fixe, le premier pas est lu dans la table : on ne cherche que si un anneau bloque ce pas.
+    if (tableActive)
     {
-        plateau[i][1] = BORDURE;  // Bordure sur la première ligne (haut)
+        char pas = premierPasStatique(caseTete, caseCible);
+        if ((pas != '\0') && directionEstSure(partie, caseTete, pas))
+        {
+            return pas;
+        }
     }
 
-    // Lignes intermédiaires : les deux bords verticaux
-    for (j = 1 ; j <= HAUTEUR_PLATEAU ; j++)
+    if (champActif)
     {
-        plateau[1][j] = BORDURE;  // Bordure sur le côté gauche
-        plateau[LARGEUR_PLATEAU][j] = BORDURE;  // Bordure sur le côté droit
+        return directionChampDistances(partie, s, caseCible, directionActuelle);
     }
 
-    // Dernière ligne : en bas
-    for (i = 1; i <= LARGEUR_PLATEAU ; i++)
+    if (file == NULL)
     {
-        plateau[i][HAUTEUR_PLATEAU] = BORDURE;  // Bordure sur la dernière ligne (bas)
+        file = allouerCases(sizeof(int));
+        visite = allouerCases(sizeof(uint32_t));
+        memset(visite, 0, nbCasesMemoire * sizeof(uint32_t));
+    }
+    if (++generation >= (UINT32_MAX >> 2))
+    {
+        memset(visite, 0, nbCasesMemoire * sizeof(uint32_t)); // Générations épuisées : remise à zéro, très rare.
+        generation = 1;
     }
 
-    // Suppression de certaines bordures pour créer des "trous" (portails)
-    plateau[LARGEUR_PLATEAU][HAUTEUR_PLATEAU / 2] = VIDE;  // Trou en bas à droite
-    plateau[LARGEUR_PLATEAU / 2][HAUTEUR_PLATEAU] = VIDE;  // Trou en bas au centre
-    plateau[LARGEUR_PLATEAU / 2][1] = VIDE;  // Trou en haut au centre
-    plateau[1][HAUTEUR_PLATEAU / 2] = VIDE;  // Trou en haut à droite
+    visite[caseTete] = generation << 2;
+    file[fin++] = caseTete;
+
+    while (debut < fin)
+    {
+        int c = file[debut++];
+
+        for (int d = 0; d < 4; d++)
+        {
+            int v = caseVoisine(plateau, c, d);
 
-    placerPaves(plateau); // Placement des pavés
+            if (((visite[v] >> 2) == generation) || (plateau[v] == BORDURE) || (plateau[v] == PAVE) || (occupation[v] != 0))
+            {
+                continue; // Case déjà vue ou bloquée.
+            }
+            int pas = (c == caseTete) ? d : (int)(visite[c] & 3);
+            visite[v] = (generation << 2) | pas;
+            if (v == caseCible)
+            {
+                return lesDirections[pas]; // Plus court chemin trouvé.
+            }
+            file[fin++] = v;
+        }
+    }
+    return trouverDirectionSure(partie, s, directionActuelle); // Pomme inaccessible pour l'instant : on survit.
 }
 
 
-void dessinerPlateau(tPlateau plateau)
-{
-    for (int i = 1; i <= LARGEUR_PLATEAU; i++)  // Parcourt les colonnes
+void calculerChampDistances(tPlateau plateau, int caseCible, uint32_t *champ, int *file) {
+    // Les trous sont appariés (caseVoisine) : le graphe des cases n'a pas de sens, et la distance de la pomme à une
+    // case est celle de la case à la pomme. Les serpents sont ignorés : seul le plateau fixe compte.
+    int debut = 0;
+    int fin = 0;
+
+    memset(champ, 0xFF, nbCasesMemoire * sizeof(uint32_t)); // CHAMP_INCONNU partout
+    champ[caseCible] = 0;
+    file[fin++] = caseCible;
+    while (debut < fin)
     {
-        for (int j = 1; j <= HAUTEUR_PLATEAU; j++)  // Parcourt les lignes
+        int c = file[debut++];
+        for (int d = 0; d < 4; d++)
         {
-            afficher(i, j, plateau[i][j]);  // Appelle la fonction afficher pour chaque case
+            int v = caseVoisine(plateau, c, d);
+            if ((champ[v] != CHAMP_INCONNU) || (plateau[v] == BORDURE) || (plateau[v] == PAVE))
+            {
+                continue; // Case déjà atteinte ou bloquée.
+            }
+            champ[v] = champ[c] + 1;
+            file[fin++] = v;
         }
     }
 }
 
 
-void ajouterPomme(tPlateau plateau, int Pomme)
-{
-    // Génère la position de la pomme à partir des tableaux de positions
-    plateau[lesPommesX[Pomme]][lesPommesY[Pomme]] = POMME;  // Place la pomme sur le plateau
-    afficher(lesPommesX[Pomme], lesPommesY[Pomme], POMME);  // Affiche la pomme à l'écran
+const uint32_t *distancesVers(tChampDistances *champ, tPlateau plateau, int caseCible) {
+    if (champ->distances == NULL)
+    {
+        champ->distances = allouerCases(sizeof(uint32_t));
+        champ->file = allouerCases(sizeof(int));
+    }
+    if (champ->cible != caseCible)
+    {
+        calculerChampDistances(plateau, caseCible, champ->distances, champ->file);
+        champ->cible = caseCible;
+    }
+    return champ->distances;
 }
 
 
-void afficher(int x, int y, char car)
-{
-    gotoxy(x, y);  // Déplace le curseur à la position (x, y)
-    printf("%c", car);  // Affiche le caractère à cette position
-    gotoxy(1, 1);  // Remet le curseur en haut à gauche de l'écran
+char directionChampDistances(const tPartie *partie, int s, int caseCible, char directionActuelle) {
+    // Le champ n'est refait que lorsque la pomme change de case : ensuite, chaque tour, le pas vers une case voisine
+    // plus proche d'un cran se lit en O(1). Le champ de la pomme en jeu est commun à tous les fils ; une recherche
+    // qui vise une autre pomme (après une pomme mangée dans une simulation) refait le sien, propre au fil.
+    static _Thread_local tChampDistances champPrive = {NULL, NULL, -1};
+    const char lesDirections[4] = {HAUT, BAS, GAUCHE, DROITE};
+    tPlateau plateau = PLATEAU(partie);
+    const uint32_t *champ = (champPartage.cible == caseCible) ? champPartage.distances : distancesVers(&champPrive, plateau, caseCible);
+
+    int caseTete = caseAnneau(partie, s, 0);
+    uint32_t distanceTete = champ[caseTete];
+    if ((distanceTete == CHAMP_INCONNU) || (distanceTete == 0))
+    {
+        return trouverDirectionSure(partie, s, directionActuelle); // Pomme inaccessible sur le plateau fixe.
+    }
+    for (int d = 0; d < 4; d++)
+    {
+        if ((champ[caseVoisine(plateau, caseTete, d)] == distanceTete - 1) && directionEstSure(partie, caseTete, lesDirections[d]))
+        {
+            return lesDirections[d];
+        }
+    }
+    return rechercheLocale(partie, caseTete, champ, directionActuelle, s); // Un corps barre chaque pas qui rapproche.
 }
 
 
-void effacer(int x, int y)
-{
-    gotoxy(x, y);  // Déplace le curseur à la position (x, y)
-    printf(" ");  // Efface la case en affichant un espace vide
-    gotoxy(1, 1);  // Remet le curseur en haut à gauche de l'écran
-}
+char rechercheLocale(const tPartie *partie, int caseTete, const uint32_t *champ, char directionActuelle, int s) {
+    // Parcours en largeur depuis la tête parmi les cases libres, arrêté à la première case plus proche de la pomme
+    // que la tête, ou après NB_CASES_RECHERCHE_LOCALE cases : on se dirige alors vers la plus proche des cases vues.
+    // Les cases vues sont marquées dans une petite table de hachage : rien n'est parcouru ni effacé sur le plateau.
+    static _Thread_local int lesCases[TAILLE_HACHAGE_LOCAL]; // Case marquée, -1 si l'emplacement est libre.
+    static _Thread_local unsigned char lesPas[TAILLE_HACHAGE_LOCAL]; // Premier pas qui mène à la case marquée.
+    int file[NB_CASES_RECHERCHE_LOCALE];
+    const char lesDirections[4] = {HAUT, BAS, GAUCHE, DROITE};
+    tPlateau plateau = PLATEAU(partie);
+    const unsigned char *occupation = OCCUPATION(partie);
+    uint32_t distanceTete = champ[caseTete];
+    uint32_t meilleureDistance = CHAMP_INCONNU;
+    int meilleurPas = -1;
+    int debut = 0;
+    int fin = 0;
 
+    memset(lesCases, 0xFF, sizeof(lesCases));
+    file[fin++] = caseTete;
+    lesCases[((uint32_t)caseTete * 2654435761u) & (TAILLE_HACHAGE_LOCAL - 1)] = caseTete;
 
-void dessinerSerpent(int lesX[], int lesY[])
-{
-    // Affiche les anneaux du serpent
-    for (int i = 1; i < TAILLE; i++)  // Parcourt le serpent 
+    while ((debut < fin) && (fin < NB_CASES_RECHERCHE_LOCALE))
+    {
+        int c = file[debut++];
+        int pasCase = -1;
+        if (c != caseTete)
+        {
+            int h = ((uint32_t)c * 2654435761u) & (TAILLE_HACHAGE_LOCAL - 1);
+            while (lesCases[h] != c)
+            {
+                h = (h + 1) & (TAILLE_HACHAGE_LOCAL - 1);
+            }
+            pasCase = lesPas[h];
+        }
+        for (int d = 0; (d < 4) && (fin < NB_CASES_RECHERCHE_LOCALE); d++)
+        {
+            int v = caseVoisine(plateau, c, d);
+            if ((plateau[v] == BORDURE) || (plateau[v] == PAVE) || (occupation[v] != 0))
+            {
+                continue; // Case bloquée.
+            }
+            int h = ((uint32_t)v * 2654435761u) & (TAILLE_HACHAGE_LOCAL - 1);
+            while ((lesCases[h] != -1) && (lesCases[h] != v))
+            {
+                h = (h + 1) & (TAILLE_HACHAGE_LOCAL - 1);
+            }
+            if (lesCases[h] == v)
+            {
+                continue; // Case déjà vue.
+            }
+            int pas = (c == caseTete) ? d : pasCase;
+            lesCases[h] = v;
+            lesPas[h] = (unsigned char)pas;
+            if (champ[v] < distanceTete)
+            {
+                return lesDirections[pas]; // Obstacle contourné.
+            }
+            if (champ[v] < meilleureDistance)
+            {
+                meilleureDistance = champ[v];
+                meilleurPas = pas;
+            }
+            file[fin++] = v;
+        }
+    }
+    if ((fin < NB_CASES_RECHERCHE_LOCALE) || (meilleurPas < 0))
     {
-        afficher(lesX[i], lesY[i], CORPS);  // Affiche un segment du serpent (corps)
+        return trouverDirectionSure(partie, s, directionActuelle); // Enfermé loin de la pomme pour l'instant : on survit.
     }
-    afficher(lesX[0], lesY[0], TETE);  // Affiche la tête du serpent
+    return lesDirections[meilleurPas];
 }
 
 
-void dessinerSerpent2(int lesX[], int lesY[])
-{
-    // Affiche les anneaux du serpent
-    for (int i = 1; i < TAILLE; i++)  // Parcourt le serpent 
-    {
-        afficher(lesX[i], lesY[i], CORPS);  // Affiche un segment du serpent (corps)
+bool estSurPave(const tPartie *partie, int c) { // Vérifie si une case est occupée par un pavé
+    return PLATEAU(partie)[c] == PAVE; // Retourne vrai si la position correspond à un pavé
+}
+
+
+void placerPaves(tPartie *partie) { // Place les pavés sur le plateau
+    tPlateau plateau = PLATEAU(partie);
+    for (int p = 0; p < NB_PAVES; p++) { // Parcourt chaque pavé à placer
+        for (int i = 0; i < TAILLE_PAVE; i++) { // Parcourt les lignes du pavé
+            for (int j = 0; j < TAILLE_PAVE; j++) { // Parcourt les colonnes du pavé
+                plateau[CASE(partie->lesPavesX[p] + i, partie->lesPavesY[p] + j)] = PAVE; // Marque la position comme pavé sur le plateau
+            }
+        }
     }
-    afficher(lesX[0], lesY[0], TETE2);  // Affiche la tête du serpent
 }
 
 
-void progresser(int lesX[], int lesY[], char direction, tPlateau plateau, bool *collision, bool *pomme, int autreX[], int autreY[]) {   
-    direction = trouverDirectionSure(lesX, lesY, direction, plateau, autreX, autreY); // Trouve une direction sûre pour éviter les collisions
-    effacer(lesX[TAILLE - 1], lesY[TAILLE - 1]); // Efface le dernier segment du serpent
+int codeDirection(char direction) {
+    int d = 0; // Code de la direction : 0 HAUT, 1 BAS, 2 GAUCHE, 3 DROITE.
 
-    for (int i = TAILLE - 1; i > 0; i--) { 
-        lesX[i] = lesX[i - 1]; // Décale chaque segment X du corps vers l'arrière
-        lesY[i] = lesY[i - 1]; // Décale chaque segment Y du corps vers l'arrière
-    }
-    switch (direction) { 
+    switch (direction) {
         case HAUT: 
-            lesY[0]--; // Déplace la tête vers le haut
-            break;                                                                       
+            d = 0; 
+            break;
         case BAS: 
-            lesY[0]++; // Déplace la tête vers le bas
-            break;                                                                        
+            d = 1; 
+            break;
+        case GAUCHE:
+            d = 2; 
+            break;
         case DROITE: 
-            lesX[0]++; // Déplace la tête vers la droite
-            break;                                                                     
-        case GAUCHE: 
-            lesX[0]--; // Déplace la tête vers la gauche
-            break;                                                                     
-    }
-
-    if (lesX[0] <= 0) {
-        lesX[0] = LARGEUR_PLATEAU; // Si la tête sort à gauche, elle réapparaît à droite
-    }                                                          
-    else if (lesX[0] > LARGEUR_PLATEAU) {
-        lesX[0] = 1; // Si la tête sort à droite, elle réapparaît à gauche
-    } 
-
-    if (lesY[0] <= 0) {
-        lesY[0] = HAUTEUR_PLATEAU; // Si la tête sort en haut, elle réapparaît en bas
-    }                                                          
-    else if (lesY[0] > HAUTEUR_PLATEAU) {
-        lesY[0] = 1; // Si la tête sort en bas, elle réapparaît en haut
-    }
-    
-    *pomme = (plateau[lesX[0]][lesY[0]] == POMME); // Vérifie si la tête est sur une pomme
-    if (*pomme) {
-        plateau[lesX[0]][lesY[0]] = VIDE; // Retire la pomme du plateau si elle est mangée
-    }
-    else if (plateau[lesX[0]][lesY[0]] == BORDURE) {
-        *collision = true; // Collision avec une bordure
+            d = 3; 
+            break;
     }
+    return d;
+}
 
-    // Vérifie les collisions avec le serpent lui-même ou l'autre serpent
-    if (estSurCorpsSerpent(lesX[0], lesY[0], lesX, lesY) || estSurCorpsAutreSerpent(lesX[0], lesY[0], autreX, autreY)) {
-        *collision = true; // Collision détectée
-    }  
 
-    if (*collision || estSurPave(lesX[0], lesY[0], plateau)) {
-        *collision = true; // Collision avec un pavé
-    }
+bool directionEstSure(const tPartie *partie, int c, char direction) {
+    // Case d'arrivée : les cases de garde bloquent, sauf devant un trou qui mène au bord opposé
+    tPlateau plateau = PLATEAU(partie);
+    int v = caseVoisine(plateau, c, codeDirection(direction));
 
-    dessinerSerpent(lesX, lesY); // Redessine le serpent avec sa nouvelle position
-    nbDepUnitaires++; // Incrémente le compteur de déplacements
-}
+    // Vérifie si la position est sûre
+    bool estSur = (OCCUPATION(partie)[v] == 0) && 
+                  (plateau[v] != PAVE) && 
+                  (plateau[v] != BORDURE);
 
+    return estSur;
+}
 
-void progresser2(int lesX2[], int lesY2[], char direction2, tPlateau plateau, bool *collision, bool *pomme, int autreX[], int autreY[]) {   
-    direction2 = trouverDirectionSure(lesX2, lesY2, direction2, plateau, autreX, autreY); // Trouve une direction sûre pour éviter les collisions
-    effacer(lesX2[TAILLE - 1], lesY2[TAILLE - 1]); // Efface la dernière partie du serpent
 
-    for (int i = TAILLE - 1; i > 0; i--) { 
-        lesX2[i] = lesX2[i - 1]; // Décale les segments X du serpent
-        lesY2[i] = lesY2[i - 1]; // Décale les segments Y du serpent
-    }
-    switch (direction2) { 
-        case HAUT: 
-            lesY2[0]--; // Déplace la tête vers le haut
-            break;                                                                       
-        case BAS: 
-            lesY2[0]++; // Déplace la tête vers le bas
-            break;                                                                        
-        case DROITE: 
-            lesX2[0]++; // Déplace la tête vers la droite
-            break;                                                                     
-        case GAUCHE: 
-            lesX2[0]--; // Déplace la tête vers la gauche
-            break;                                                                     
-    }
-
-    if (lesX2[0] <= 0) {
-        lesX2[0] = LARGEUR_PLATEAU; // Si la tête sort à gauche, elle réapparaît à droite
-    }                                                          
-    else if (lesX2[0] > LARGEUR_PLATEAU) {
-        lesX2[0] = 1; // Si la tête sort à droite, elle réapparaît à gauche
-    } 
-
-    if (lesY2[0] <= 0) {
-        lesY2[0] = HAUTEUR_PLATEAU; // Si la tête sort en haut, elle réapparaît en bas
-    }                                                          
-    else if (lesY2[0] > HAUTEUR_PLATEAU) {
-        lesY2[0] = 1; // Si la tête sort en bas, elle réapparaît en haut
-    }
-    
-    *pomme = (plateau[lesX2[0]][lesY2[0]] == POMME); // Vérifie si la tête est sur une pomme
-    if (*pomme) {
-        plateau[lesX2[0]][lesY2[0]] = VIDE; // Retire la pomme si elle est mangée
-    }
-    else if (plateau[lesX2[0]][lesY2[0]] == BORDURE) {
-        *collision = true; // Collision avec une bordure
-    }
+/************************************************/
+/*	TABLE DES DISTANCES DU PLATEAU FIXE 		*/
+/************************************************/
 
-    // Vérifie les collisions avec le corps du serpent ou celui de l'autre serpent
-    if (estSurCorpsSerpent(lesX2[0], lesY2[0], lesX2, lesY2) || estSurCorpsAutreSerpent(lesX2[0], lesY2[0], autreX, autreY)) {
-        *collision = true; // Collision détectée
+uint64_t empreintePlateau(tPlateau plateau) {
+    uint64_t empreinte = 14695981039346656037ULL; // FNV-1a 64 bits
+    for (int j = 1; j <= hauteurPlateau; j++)
+    {
+        for (int i = 1; i <= largeurPlateau; i++)
+        {
+            empreinte = (empreinte ^ (unsigned char)plateau[CASE(i, j)]) * 1099511628211ULL;
+        }
     }
+    return empreinte;
+}
 
-    if (*collision || estSurPave(lesX2[0], lesY2[0], plateau)) {
-        *collision = true; // Collision avec un pavé
-    }
 
-    dessinerSerpent2(lesX2, lesY2); // Redessine le serpent avec sa nouvelle position
-    nbDepUnitaires2++; // Incrémente le compteur de déplacements
+size_t tailleTableDistances(int nbCasesLibres) {
+    size_t nbPaires = (size_t)nbCasesLibres * nbCasesLibres;
+    return sizeof(tEnteteDistances) + nbPaires + (nbPaires + 3) / 4;
 }
 
 
-char trouverDirectionSure(int lesX[], int lesY[], char directionActuelle, tPlateau plateau, int autreX[], int autreY[]) {
-    // Vérifie si la direction actuelle est sûre
-    if (directionEstSure(lesX[0], lesY[0], directionActuelle, lesX, lesY, autreX, autreY, plateau)) 
-    { 
-        return directionActuelle; // Retourne la direction actuelle si elle est sûre
-    }
-    // Vérifie si aller à gauche est sûr
-    if (directionEstSure(lesX[0], lesY[0], GAUCHE, lesX, lesY, autreX, autreY, plateau)) 
-    { 
-        return GAUCHE; // Retourne GAUCHE si elle est sûre
-    }
-    // Vérifie si aller à droite est sûr
-    if (directionEstSure(lesX[0], lesY[0], DROITE, lesX, lesY, autreX, autreY, plateau))
+void calculerTableDistances(tPlateau plateau, unsigned char *distances, unsigned char *premiersPas) {
+    // Un parcours en largeur par case de départ, sur le plateau sans pommes ni serpents.
+    // Les voisins (trous compris) sont calculés une fois pour toutes en numéros de cases libres.
+    int n = tableDistances.nbCasesLibres;
+    int (*voisins)[4] = malloc(sizeof(int[4]) * n);
+    int *file = malloc(sizeof(int) * n);
+    unsigned char *pasDepuisDepart = malloc(n);
+
+    if ((voisins == NULL) || (file == NULL) || (pasDepuisDepart == NULL))
     {
-        return DROITE; // Retourne DROITE si elle est sûre
-    }
-    // Vérifie si aller en haut est sûr
-    if (directionEstSure(lesX[0], lesY[0], HAUT, lesX, lesY, autreX, autreY, plateau)) 
-    { 
-        return HAUT; // Retourne HAUT si elle est sûre
+        perror("malloc");
+        exit(EXIT_FAILURE);
     }
-    // Vérifie si aller en bas est sûr
-    if (directionEstSure(lesX[0], lesY[0], BAS, lesX, lesY, autreX, autreY, plateau)) 
-    { 
-        return BAS; // Retourne BAS si elle est sûre
+
+    for (int j = 1; j <= hauteurPlateau; j++)
+    {
+        for (int i = 1; i <= largeurPlateau; i++)
+        {
+            int c = tableDistances.numero[CASE(i, j)];
+            if (c < 0)
+            {
+                continue;
+            }
+            for (int d = 0; d < 4; d++)
+            {
+                voisins[c][d] = tableDistances.numero[caseVoisine(plateau, CASE(i, j), d)]; // -1 pour une garde.
+            }
+        }
     }
-    return directionActuelle; // Si aucune direction n'est sûre, retourne la direction actuelle
-}
 
+    memset(premiersPas, 0, ((size_t)n * n + 3) / 4);
+    for (int depart = 0; depart < n; depart++)
+    {
+        unsigned char *ligne = distances + (size_t)depart * n;
+        int debut = 0;
+        int fin = 0;
 
-bool estSurCorpsSerpent(int x, int y, int lesX[], int lesY[]) {   // Vérifie si une position est occupée par le corps du serpent
-    bool collision = false; // Initialise la variable de collision
-    for (int i = 1; i < TAILLE; i++) // Parcourt les parties du serpent, sauf la tête
-    { 
-        if (lesX[i] == x && lesY[i] == y) // Compare les coordonnées fournies avec celles du serpent
-        { 
-            collision = true; // Si une partie correspond, une collision est détectée
+        memset(ligne, DISTANCE_INCONNUE, n);
+        ligne[depart] = 0;
+        file[fin++] = depart;
+        while (debut < fin)
+        {
+            int c = file[debut++];
+            for (int d = 0; d < 4; d++)
+            {
+                int v = voisins[c][d];
+                if ((v < 0) || (ligne[v] != DISTANCE_INCONNUE) || (v == depart))
+                {
+                    continue; // Bordure, pavé ou case déjà atteinte.
+                }
+                ligne[v] = (ligne[c] + 1 < DISTANCE_INCONNUE) ? ligne[c] + 1 : DISTANCE_INCONNUE - 1;
+                pasDepuisDepart[v] = (c == depart) ? d : pasDepuisDepart[c];
+                size_t paire = (size_t)depart * n + v;
+                premiersPas[paire / 4] |= pasDepuisDepart[v] << (2 * (paire % 4));
+                file[fin++] = v;
+            }
         }
     }
-    return collision; // Retourne vrai si une collision est détectée, sinon faux
+
+    free(voisins);
+    free(file);
+    free(pasDepuisDepart);
 }
 
 
-bool PasserPortails(int lesX[], int lesY[]) {
-    bool teleporter = false ;
-    if (lesX[0] <= 0) {
-        lesX[0] = LARGEUR_PLATEAU;  // Réapparaît à droite
-        teleporter = true;
-    } else if (lesX[0] > LARGEUR_PLATEAU) {
-        lesX[0] = 1;  // Réapparaît à gauche
-        teleporter = true;
-    }
+bool chargerTableDistances(tPlateau plateau, const char *nomFichier) {
+    tEnteteDistances attendu;
+    int n = 0;
 
-    if (lesY[0] <= 0) {
-        lesY[0] = HAUTEUR_PLATEAU;  // Réapparaît en bas
-        teleporter = true;
-    } else if (lesY[0] > HAUTEUR_PLATEAU) {
-        lesY[0] = 1;  // Réapparaît en haut
-        teleporter = true;
+    // Numérotation des cases libres du plateau fixe, ligne par ligne
+    for (int c = 0; c < nbCasesMemoire; c++)
+    {
+        n += (plateau[c] != BORDURE) && (plateau[c] != PAVE) && (plateau[c] != SORTIE_PORTAIL);
     }
-    return teleporter;
-}
+    if (n > MAX_CASES_TABLE)
+    {
+        return false; // Table trop grande (n*n octets) : les chemins seront cherchés à chaque tour.
+    }
+    tableDistances.numero = malloc(sizeof(int) * nbCasesMemoire);
+    if (tableDistances.numero == NULL)
+    {
+        return false;
+    }
+    n = 0;
+    for (int c = 0; c < nbCasesMemoire; c++)
+    {
+        bool libre = (plateau[c] != BORDURE) && (plateau[c] != PAVE) && (plateau[c] != SORTIE_PORTAIL);
+        tableDistances.numero[c] = libre ? n++ : -1;
+    }
+    tableDistances.nbCasesLibres = n;
+    tableDistances.tailleMemoire = tailleTableDistances(n);
 
+    memset(&attendu, 0, sizeof(attendu));
+    memcpy(attendu.signature, SIGNATURE_DISTANCES, sizeof(attendu.signature));
+    attendu.largeur = (uint32_t)largeurPlateau;
+    attendu.hauteur = (uint32_t)hauteurPlateau;
+    attendu.nbCasesLibres = (uint32_t)n;
+    attendu.empreinte = empreintePlateau(plateau);
 
-int minimunTableau(tChemins Tableau){
-    int minDistance = Tableau[0];
-    int minDistanceI = 0;
-    
-    for (int i = 0; i < 5; i++)
+    // 1. Projection du fichier existant, s'il correspond à ce plateau
+    int fd = open(nomFichier, O_RDONLY);
+    if (fd >= 0)
     {
-        if (minDistance > Tableau[i]) // Si une distance plus courte est trouvée
+        struct stat infos;
+        if ((fstat(fd, &infos) == 0) && ((size_t)infos.st_size == tableDistances.tailleMemoire))
         {
-            minDistance = Tableau[i]; // Met à jour la distance minimale
-            minDistanceI = i;     // Met à jour l'index du chemin le plus court
+            void *memoire = mmap(NULL, tableDistances.tailleMemoire, PROT_READ, MAP_SHARED, fd, 0);
+            if (memoire != MAP_FAILED)
+            {
+                if (memcmp(memoire, &attendu, sizeof(attendu)) == 0)
+                {
+                    tableDistances.memoire = memoire;
+                    tableDistances.projetee = true;
+                }
+                else
+                {
+                    munmap(memoire, tableDistances.tailleMemoire); // Table d'un autre plateau : on la recalcule.
+                }
+            }
         }
+        close(fd);
     }
-    return minDistanceI;
-}
-
-
-bool estSurPave(int x, int y, tPlateau plateau) { // Vérifie si une position est occupée par un pavé
-    return plateau[x][y] == PAVE; // Retourne vrai si la position correspond à un pavé
-}
 
+    // 2. Sinon calcul, puis enregistrement pour les prochains lancements
+    if (tableDistances.memoire == NULL)
+    {
+        unsigned char *memoire = malloc(tableDistances.tailleMemoire);
+        if (memoire == NULL)
+        {
+            free(tableDistances.numero);
+            tableDistances.numero = NULL;
+            return false; // Pas assez de mémoire : les chemins seront cherchés à chaque tour.
+        }
+        memcpy(memoire, &attendu, sizeof(attendu));
+        calculerTableDistances(plateau, memoire + sizeof(attendu), memoire + sizeof(attendu) + (size_t)n * n);
 
-void placerPaves(tPlateau plateau) { // Place les pavés sur le plateau
-    for (int p = 0; p < NB_PAVES; p++) { // Parcourt chaque pavé à placer
-        for (int i = 0; i < TAILLE_PAVE; i++) { // Parcourt les lignes du pavé
-            for (int j = 0; j < TAILLE_PAVE; j++) { // Parcourt les colonnes du pavé
-                plateau[lesPavesX[p] + i][lesPavesY[p] + j] = PAVE; // Marque la position comme pavé sur le plateau
+        // Écriture dans un fichier temporaire renommé ensuite : un autre lancement ne lit jamais un fichier à moitié écrit.
+        char nomTemporaire[256];
+        snprintf(nomTemporaire, sizeof(nomTemporaire), "%s.%d", nomFichier, (int)getpid());
+        FILE *fichier = fopen(nomTemporaire, "wb");
+        if (fichier != NULL)
+        {
+            bool ecrit = (fwrite(memoire, 1, tableDistances.tailleMemoire, fichier) == tableDistances.tailleMemoire);
+            ecrit = (fclose(fichier) == 0) && ecrit;
+            if (!ecrit || (rename(nomTemporaire, nomFichier) != 0))
+            {
+                remove(nomTemporaire); // La table reste utilisable pour ce lancement.
             }
         }
+        tableDistances.memoire = memoire;
+        tableDistances.projetee = false;
     }
+
+    tableDistances.distances = (const unsigned char *)tableDistances.memoire + sizeof(tEnteteDistances);
+    tableDistances.premiersPas = tableDistances.distances + (size_t)n * n;
+    return true;
 }
 
 
-bool estSurCorpsAutreSerpent(int x, int y, int autreX[], int autreY[]) {
-    // Vérifie si la tête d'un serpent est sur le corps de l'autre
-    for (int i = 0; i < TAILLE; i++) {
-        if (x == autreX[i] && y == autreY[i]) {
-            return true;
-        }
+void libererTableDistances(void) {
+    free(tableDistances.numero);
+    tableDistances.numero = NULL;
+    if (tableDistances.memoire == NULL)
+    {
+        return;
     }
-    return false;
+    if (tableDistances.projetee)
+    {
+        munmap(tableDistances.memoire, tableDistances.tailleMemoire);
+    }
+    else
+    {
+        free(tableDistances.memoire);
+    }
+    tableDistances.memoire = NULL;
+    tableActive = false;
 }
 
 
-bool directionEstSure(int x, int y, char direction, int lesX[], int lesY[], int autreX[], int autreY[], tPlateau plateau) {
-    // Met à jour les coordonnées en fonction de la direction
-    switch (direction) {
-        case HAUT: 
-            y--; 
-            break;
-        case BAS: 
-            y++; 
-            break;
-        case GAUCHE:
-            x--; 
-            break;
-        case DROITE: 
-            x++; 
-            break;
+char premierPasStatique(int caseDepart, int caseArrivee) {
+    const char lesDirections[4] = {HAUT, BAS, GAUCHE, DROITE};
+    int depart = tableDistances.numero[caseDepart];
+    int arrivee = tableDistances.numero[caseArrivee];
+
+    if ((depart < 0) || (arrivee < 0) || (depart == arrivee)
+        || (tableDistances.distances[(size_t)depart * tableDistances.nbCasesLibres + arrivee] == DISTANCE_INCONNUE))
+    {
+        return '\0';
     }
+    size_t paire = (size_t)depart * tableDistances.nbCasesLibres + arrivee;
+    return lesDirections[(tableDistances.premiersPas[paire / 4] >> (2 * (paire % 4))) & 3];
+}
 
-    // Gère les sorties du plateau pour les rendre cycliques
-    x = (x + LARGEUR_PLATEAU - 1) % LARGEUR_PLATEAU + 1;
-    y = (y + HAUTEUR_PLATEAU - 1) % HAUTEUR_PLATEAU + 1;
 
-    // Vérifie si la position est sûre
-    bool estSur = !estSurCorpsSerpent(x, y, lesX, lesY) && 
-                  !estSurCorpsAutreSerpent(x, y, autreX, autreY) && 
-                  !estSurPave(x, y, plateau) && 
-                  plateau[x][y] != BORDURE;
+int distanceStatique(int caseDepart, int caseArrivee) {
+    int depart = tableDistances.numero[caseDepart];
+    int arrivee = tableDistances.numero[caseArrivee];
 
-    return estSur;
+    if ((depart < 0) || (arrivee < 0))
+    {
+        return DISTANCE_INCONNUE;
+    }
+    return tableDistances.distances[(size_t)depart * tableDistances.nbCasesLibres + arrivee];
 }
 
 
@@ -1032,36 +4899,27 @@ void gotoxy(int x, int y)
     printf("\033[%d;%df", y, x);
 }
 
+// Attributs du terminal au lancement, rétablis à la fin du programme.
+struct termios terminalInitial;
+bool terminalModifie = false;
+
 int kbhit()
 {
 	// la fonction retourne :
 	// 1 si un caractere est present
 	// 0 si pas de caractere présent
-	int unCaractere = 0;
-	struct termios oldt, newt;
-	int ch;
-	int oldf;
-
-	// mettre le terminal en mode non bloquant
-	tcgetattr(STDIN_FILENO, &oldt);
-	newt = oldt;
-	newt.c_lflag &= ~(ICANON | ECHO);
-	tcsetattr(STDIN_FILENO, TCSANOW, &newt);
-	oldf = fcntl(STDIN_FILENO, F_GETFL, 0);
-	fcntl(STDIN_FILENO, F_SETFL, oldf | O_NONBLOCK);
- 
-	ch = getchar();
-
-	// restaurer le mode du terminal
-	tcsetattr(STDIN_FILENO, TCSANOW, &oldt);
-	fcntl(STDIN_FILENO, F_SETFL, oldf);
- 
-	if(ch != EOF)
-	{
-		ungetc(ch, stdin);
-		unCaractere = 1;
-	} 
-	return unCaractere;
+	// Le terminal reste en mode non canonique pendant toute la partie (disable_echo) :
+	// un seul poll() sans attente suffit, sans changer les réglages à chaque tour.
+	struct pollfd entree = {STDIN_FILENO, POLLIN, 0};
+
+	return (poll(&entree, 1, 0) > 0) && (entree.revents & POLLIN);
+}
+
+// Rétablit le terminal quand le programme est interrompu (Ctrl+C) pendant la partie.
+void interrompre(int numeroSignal)
+{
+    enable_echo();
+    _exit(128 + numeroSignal);
 }
 
 // Fonction pour désactiver l'echo
@@ -1070,42 +4928,43 @@ void disable_echo()
     struct termios tty;
 
     // Obtenir les attributs du terminal
-    if (tcgetattr(STDIN_FILENO, &tty) == -1) 
+    if (tcgetattr(STDIN_FILENO, &terminalInitial) == -1) 
 	{
         perror("tcgetattr");
         exit(EXIT_FAILURE);
     }
 
-    // Désactiver le flag ECHO
-    tty.c_lflag &= ~ECHO;
+    // Désactiver l'écho et le mode ligne ; une lecture rend la main tout de suite
+    tty = terminalInitial;
+    tty.c_lflag &= ~(ICANON | ECHO);
+    tty.c_cc[VMIN] = 0;
+    tty.c_cc[VTIME] = 0;
 
-    // Appliquer les nouvelles configurations
+    // Appliquer les nouvelles configurations, une seule fois pour toute la partie
     if (tcsetattr(STDIN_FILENO, TCSANOW, &tty) == -1)
 	{
         perror("tcsetattr");
         exit(EXIT_FAILURE);
     }
+    terminalModifie = true;
+    setvbuf(stdin, NULL, _IONBF, 0); // getchar() lit un seul octet : poll() voit encore les touches suivantes.
+    atexit(enable_echo);
+    signal(SIGINT, interrompre);
+    signal(SIGTERM, interrompre);
 }
 
 // Fonction pour réactiver l'echo
 void enable_echo()
 {
-    struct termios tty;
-
-    // Obtenir les attributs du terminal
-    if (tcgetattr(STDIN_FILENO, &tty) == -1)
-	{
-        perror("tcgetattr");
-        exit(EXIT_FAILURE);
+    if (!terminalModifie)
+    {
+        return; // Terminal déjà rétabli.
     }
 
-    // Réactiver le flag ECHO
-    tty.c_lflag |= ECHO;
-
-    // Appliquer les nouvelles configurations
-    if (tcsetattr(STDIN_FILENO, TCSANOW, &tty) == -1)
+    // Rétablir les attributs d'origine du terminal
+    if (tcsetattr(STDIN_FILENO, TCSANOW, &terminalInitial) == -1)
 	{
         perror("tcsetattr");
-        exit(EXIT_FAILURE);
     }
-}
\ No newline at end of file
+    terminalModifie = false;
+}
@@ -1,37 +1,163 @@
+// Compilation : cc -O2 -pthread -o ex1 ex1.c
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <limits.h>
 #include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
 
 #define TAILLE 300000 
+#define SEUIL_NINTHER 40 // Au-delà, le pivot de triRapide est la médiane de trois médianes.
+#define SEUIL_INSERTION 16 // En dessous, les sous-tableaux sont finis par insertion.
+#define MAX_INSERTION 100000 // Au-delà, tri_insertion (quadratique) n'est pas mesuré.
+#define NB_REPETITIONS 3 // Nombre de mesures de chaque tri.
+#define GRAINE_MESURE 1 // Graine des valeurs à trier en mode mesure.
+#define OPTION_MESURE "--mesure"
+#define OPTION_PARALLELE "--parallele"
+#define TAILLE_PARALLELE 100000000 // Nombre d'éléments par défaut du mode parallèle.
+#define SEUIL_PARALLELE 16384 // En dessous, les tris parallèles continuent sans créer de tâche.
+#define CAPACITE_FILE 4096 // Tâches en attente dans la file d'un fil (puissance de 2).
+#define SEUIL_PARTITION_PARALLELE 262144 // Au-delà, triRapideParallele partitionne par blocs sur tous les fils.
+#define NB_TACHES_TRI 32 // Tâches lancées au plus par un appel de triRapideParallele ; au-delà, la petite partie est triée sur place.
+#define TAILLE_BLOC_PARTITION 65536 // Taille visée d'un bloc de la partition parallèle.
+#define NB_BLOCS_MAX 256 // Nombre maximal de blocs d'une partition parallèle.
+#define PHASE_COMPTER 0 // Phases d'un bloc de la partition parallèle.
+#define PHASE_RANGER 1
+#define PHASE_RECOPIER 2
+#define NB_VALEURS_PEU_DISTINCTES 10 // Valeurs différentes de la forme peu distincte.
+#define FORME_ALEATOIRE 0 // Formes des valeurs à trier en mode mesure.
+#define FORME_TRIEE 1
+#define FORME_INVERSEE 2
+#define FORME_EGALE 3
+#define FORME_PEU_DISTINCTE 4
+#define NB_FORMES 5
 typedef int tableau[TAILLE];
+typedef void (*tTri)(int T[], int n);
 
+typedef struct tTache {
+    void (*executer)(struct tTache *tache); // Fonction qui fait la tâche.
+    atomic_bool finie;
+    int *source; // Tableau à trier, ou suites à fusionner.
+    int *destination; // Tampon du tri fusion, ou tableau où fusionner.
+    int debut, fin; // Partie à trier, ou première suite.
+    int debut2, fin2; // Seconde suite.
+    int position; // Indice du premier élément fusionné.
+    bool dansSource; // Le tri fusion laisse son résultat dans source (sinon dans destination).
+} tTache;
 
-void tri_insertion(tableau T);
+typedef struct {
+    tTache tache; // En premier : la fonction de la tâche reçoit l'adresse du bloc.
+    int phase; // PHASE_COMPTER, PHASE_RANGER ou PHASE_RECOPIER.
+    int valeur; // Pivot de la partition.
+    int nbInferieurs, nbEgaux; // Valeurs du bloc plus petites que le pivot, égales au pivot.
+    int rangInferieurs, rangEgaux, rangSuperieurs; // Où le bloc range chaque sorte de valeur dans le tampon.
+} tBloc;
+
+typedef struct {
+    _Atomic long haut; // Prochaine tâche à voler.
+    _Atomic long bas; // Prochaine place libre du propriétaire.
+    tTache *_Atomic taches[CAPACITE_FILE];
+} tFile;
+
+typedef struct {
+    int nbFils;
+    tFile *lesFiles; // Une file par fil.
+    pthread_t *lesFils;
+    atomic_bool arret;
+} tOrdonnanceur;
+
+tOrdonnanceur ordonnanceur;
+_Thread_local int numeroFil; // Numéro du fil courant dans l'ordonnanceur (0 : fil principal).
+_Thread_local unsigned int graineFil; // Tirage des fils à voler.
+
+
+void tri_insertion(int T[], int n);
 void afficher(tableau T);
 int aleatoires();
 void initTab(tableau T);
-int partition(tableau T,int debut,int fin,int pivot);
+void partition(tableau T, int debut, int fin, int pivot, int *premierEgal, int *dernierEgal);
+int mediane(tableau T, int a, int b, int c);
+int choisirPivot(tableau T, int debut, int fin);
 void triRapide(tableau T, int debut, int fin);
+void echanger(int T[], int i, int j);
+void tamiser(int T[], int racine, int n);
+void triTas(int T[], int n);
+void triIntro(int T[], int debut, int fin, int profondeur);
+void triHybride(int T[], int n);
+void triRadix(int T[], int n);
+void triRapideTableau(int T[], int n);
+int comparerEntiers(const void *a, const void *b);
+void triQsort(int T[], int n);
+double duree(struct timespec debut, struct timespec fin);
+void remplir(int T[], int n, int forme);
+int mesurer(int n);
+bool pousser(tFile *file, tTache *tache);
+tTache *reprendre(tFile *file);
+tTache *voler(tFile *file);
+void executer(tTache *tache);
+tTache *chercherTache(void);
+void *filOrdonnanceur(void *numero);
+void demarrerOrdonnanceur(int nbFils);
+void arreterOrdonnanceur(void);
+void lancer(tTache *tache);
+void attendre(tTache *tache);
+void tacheBloc(tTache *tache);
+void partitionParallele(int T[], int tampon[], int debut, int fin, int valeur, int *premierEgal, int *dernierEgal);
+void tacheTriRapide(tTache *tache);
+void triRapideParallele(int T[], int tampon[], int debut, int fin);
+void tacheFusion(tTache *tache);
+void fusionParallele(const int source[], int debut1, int fin1, int debut2, int fin2, int destination[], int position);
+void tacheTriFusion(tTache *tache);
+void triFusionParallele(int T[], int tampon[], int debut, int fin, bool dansT);
+void triRapideParalleleTableau(int T[], int n);
+void triFusionParalleleTableau(int T[], int n);
+int mesurerParallele(int n, int filsMax);
+
 
+int main(int argc, char *argv[]){
+    if ( (argc >= 2) && (strcmp(argv[1], OPTION_MESURE) == 0) ){
+        int n = (argc >= 3) ? atoi(argv[2]) : TAILLE;
+        if ( n <= 0 ){
+            fprintf(stderr, "Nombre d'éléments invalide : %s\n", argv[2]);
+            return EXIT_FAILURE;
+        }
+        return mesurer(n);
+    }
+    if ( (argc >= 2) && (strcmp(argv[1], OPTION_PARALLELE) == 0) ){
+        int n = (argc >= 3) ? atoi(argv[2]) : TAILLE_PARALLELE;
+        int filsMax = (argc >= 4) ? atoi(argv[3]) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+        if ( (n <= 0) || (filsMax <= 0) ){
+            fprintf(stderr, "Nombre d'éléments ou de fils invalide\n");
+            return EXIT_FAILURE;
+        }
+        return mesurerParallele(n, filsMax);
+    }
+    if ( argc >= 2 ){
+        fprintf(stderr, "Usage : %s [%s [nbElements] | %s [nbElements] [filsMax]]\n", argv[0], OPTION_MESURE, OPTION_PARALLELE);
+        return EXIT_FAILURE;
+    }
 
-int main(){
-    time_t t1 = time(NULL);
-    time_t t2 = time(NULL);
+    struct timespec t1, t2;
     tableau T = {5,3,9,8,7,5,2,1,9,1};
     initTab(T);
-    t1 = time(NULL);
-    tri_insertion(T);
-    t2 = time(NULL);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    triHybride(T, TAILLE);
+    clock_gettime(CLOCK_MONOTONIC, &t2);
     afficher(T);
     printf("\n");
-    printf("duree = %.3f secondes\n", difftime(t2, t1) );
+    printf("duree = %.3f secondes\n", duree(t1, t2) );
     return EXIT_SUCCESS;
 }
 
 
-void tri_insertion(tableau T){
+void tri_insertion(int T[], int n){
     int x , j ;
-    for (int i = 1 ;  i <= TAILLE-1 ; i++)
+    for (int i = 1 ;  i <= n-1 ; i++)
     {
         x = T[i];
         j = i;
@@ -58,38 +184,696 @@ int aleatoires(){
 
 
 void initTab(tableau T){
-    for (int i = 0 ;  i <= TAILLE ; i++){
+    for (int i = 0 ;  i < TAILLE ; i++){
         T[i] = aleatoires();
     }
 }
 
-int partition(tableau T,int debut,int fin,int pivot){
-    int temp = T[fin]; 
-    T[fin] = T[pivot];
-    T[pivot] = temp ;
-    int j = debut ;
-    for ( int i = debut ; i <= (fin-1) ; i++ ){
-        if (T[i] <= T[fin]){
-            temp = T[i]; 
-            T[i] = T[j];
-            T[j] = temp ;
-            j++ ;
+// Partition en trois de T[debut..fin] autour de T[pivot] (Bentley et McIlroy) : deux parcours de Hoare qui
+// n'échangent que les paires mal placées, les valeurs égales au pivot étant rangées aux deux bouts puis
+// ramenées au milieu. À la fin, T[debut..*premierEgal-1] < valeur, T[*premierEgal..*dernierEgal] == valeur
+// et T[*dernierEgal+1..fin] > valeur : les doublons ne sont plus revisités.
+void partition(tableau T, int debut, int fin, int pivot, int *premierEgal, int *dernierEgal){
+    echanger(T, debut, pivot);
+    int valeur = T[debut];
+    int i = debut , j = fin + 1 ;
+    int p = debut , q = fin + 1 ; // T[debut..p] et T[q..fin] : valeurs égales au pivot.
+    while ( 1 ){
+        while ( T[++i] < valeur ){
+            if ( i == fin ) break;
         }
+        while ( valeur < T[--j] ){
+            if ( j == debut ) break;
+        }
+        if ( (i == j) && (T[i] == valeur) ){
+            echanger(T, ++p, i);
+        }
+        if ( i >= j ){
+            break;
+        }
+        echanger(T, i, j);
+        if ( T[i] == valeur ) echanger(T, ++p, i);
+        if ( T[j] == valeur ) echanger(T, --q, j);
     }
-    
-    temp = T[fin]; 
-    T[fin] = T[j];
-    T[j] = temp ;
-    return j ;
+    i = j + 1;
+    for ( int k = debut ; k <= p ; k++ ){
+        echanger(T, k, j--);
+    }
+    for ( int k = fin ; k >= q ; k-- ){
+        echanger(T, k, i++);
+    }
+    *premierEgal = j + 1;
+    *dernierEgal = i - 1;
 }
 
+int mediane(tableau T, int a, int b, int c){
+    if ( T[a] < T[b] ){
+        return (T[b] < T[c]) ? b : ((T[a] < T[c]) ? c : a);
+    }
+    return (T[a] < T[c]) ? a : ((T[b] < T[c]) ? c : b);
+}
+
+// Médiane de trois (début, milieu, fin), ou au-delà de SEUIL_NINTHER éléments médiane de trois médianes
+// de trois (ninther de Tukey) : un tableau trié ou inversé donne le pivot du milieu.
+int choisirPivot(tableau T, int debut, int fin){
+    int milieu = debut + (fin - debut)/2;
+    int n = fin - debut + 1;
+    if ( n > SEUIL_NINTHER ){
+        int pas = n/8;
+        return mediane(T, mediane(T, debut, debut + pas, debut + 2*pas),
+                          mediane(T, milieu - pas, milieu, milieu + pas),
+                          mediane(T, fin - 2*pas, fin - pas, fin));
+    }
+    return mediane(T, debut, milieu, fin);
+}
+
+// Récursion sur la plus petite partie, boucle sur la plus grande : au plus log2(n) appels empilés.
 void triRapide(tableau T, int debut, int fin){
-    int pivot ;
-    if ( debut < fin ){
-        pivot = (debut + fin)/2;
-        pivot = partition(T, debut, fin, pivot);
-        triRapide(T, debut, pivot-1);
-        triRapide(T, pivot+1, fin);
+    int premierEgal , dernierEgal ;
+    while ( debut < fin ){
+        partition(T, debut, fin, choisirPivot(T, debut, fin), &premierEgal, &dernierEgal);
+        if ( premierEgal - debut < fin - dernierEgal ){
+            triRapide(T, debut, premierEgal-1);
+            debut = dernierEgal + 1;
+        }
+        else {
+            triRapide(T, dernierEgal+1, fin);
+            fin = premierEgal - 1;
+        }
+    }
+}
+
+void echanger(int T[], int i, int j){
+    int temp = T[i];
+    T[i] = T[j];
+    T[j] = temp ;
+}
+
+// Fait descendre T[racine] dans le tas T[0..n-1] jusqu'à ce que ses fils soient plus petits.
+void tamiser(int T[], int racine, int n){
+    int x = T[racine];
+    int fils = 2*racine + 1;
+    while ( fils < n ){
+        if ( (fils + 1 < n) && (T[fils+1] > T[fils]) ){
+            fils++ ;
+        }
+        if ( T[fils] <= x ){
+            break;
+        }
+        T[racine] = T[fils];
+        racine = fils;
+        fils = 2*racine + 1;
+    }
+    T[racine] = x ;
+}
+
+void triTas(int T[], int n){
+    for ( int i = n/2 - 1 ; i >= 0 ; i-- ){
+        tamiser(T, i, n);
+    }
+    for ( int i = n-1 ; i > 0 ; i-- ){
+        echanger(T, 0, i);
+        tamiser(T, 0, i);
+    }
+}
+
+// Tri rapide sur T[debut..fin] : pivot médian de trois, partition de Hoare (les valeurs égales au pivot
+// se répartissent des deux côtés), récursion sur la plus petite partie et boucle sur la plus grande,
+// tri par tas quand la profondeur dépasse 2 log2(n), insertion sous SEUIL_INSERTION éléments.
+void triIntro(int T[], int debut, int fin, int profondeur){
+    while ( fin - debut + 1 > SEUIL_INSERTION ){
+        if ( profondeur == 0 ){
+            triTas(T + debut, fin - debut + 1);
+            return;
+        }
+        profondeur-- ;
+        int milieu = debut + (fin - debut)/2;
+        if ( T[milieu] < T[debut] ) echanger(T, milieu, debut);
+        if ( T[fin] < T[debut] ) echanger(T, fin, debut);
+        if ( T[fin] < T[milieu] ) echanger(T, fin, milieu);
+        int pivot = T[milieu];
+        int i = debut , j = fin ;
+        while ( i <= j ){
+            while ( T[i] < pivot ) i++ ;
+            while ( T[j] > pivot ) j-- ;
+            if ( i <= j ){
+                echanger(T, i, j);
+                i++ ;
+                j-- ;
+            }
+        }
+        if ( j - debut < fin - i ){
+            triIntro(T, debut, j, profondeur);
+            debut = i ;
+        }
+        else {
+            triIntro(T, i, fin, profondeur);
+            fin = j ;
+        }
+    }
+    tri_insertion(T + debut, fin - debut + 1);
+}
+
+void triHybride(int T[], int n){
+    int profondeur = 0;
+    for ( int m = n ; m > 1 ; m /= 2 ){
+        profondeur += 2;
+    }
+    triIntro(T, 0, n-1, profondeur);
+}
+
+// Tri par base, chiffre de poids faible d'abord : 4 passes de 8 bits. Le bit de signe est inversé
+// pendant le tri pour que les négatifs passent devant ; une passe où tous ont le même chiffre est sautée.
+void triRadix(int T[], int n){
+    if ( n <= 1 ){
+        return;
+    }
+    int *tampon = malloc(n * sizeof(int));
+    if ( tampon == NULL ){
+        perror("malloc");
+        exit(EXIT_FAILURE);
+    }
+    int *source = T , *destination = tampon ;
+    for ( int i = 0 ; i < n ; i++ ){
+        T[i] ^= INT_MIN;
+    }
+    for ( int decalage = 0 ; decalage < 32 ; decalage += 8 ){
+        int compte[257] = {0};
+        for ( int i = 0 ; i < n ; i++ ){
+            compte[(((unsigned int)source[i] >> decalage) & 0xFF) + 1]++ ;
+        }
+        if ( compte[(((unsigned int)source[0] >> decalage) & 0xFF) + 1] == n ){
+            continue;
+        }
+        for ( int c = 1 ; c <= 256 ; c++ ){
+            compte[c] += compte[c-1];
+        }
+        for ( int i = 0 ; i < n ; i++ ){
+            destination[compte[((unsigned int)source[i] >> decalage) & 0xFF]++] = source[i];
+        }
+        int *temp = source;
+        source = destination;
+        destination = temp ;
     }
+    if ( source != T ){
+        memcpy(T, source, n * sizeof(int));
+    }
+    for ( int i = 0 ; i < n ; i++ ){
+        T[i] ^= INT_MIN;
+    }
+    free(tampon);
+}
+
+void triRapideTableau(int T[], int n){
+    triRapide(T, 0, n-1);
+}
+
+int comparerEntiers(const void *a, const void *b){
+    int x = *(const int *)a , y = *(const int *)b ;
+    return (x > y) - (x < y);
+}
+
+void triQsort(int T[], int n){
+    qsort(T, n, sizeof(int), comparerEntiers);
 }
 
+double duree(struct timespec debut, struct timespec fin){
+    return (fin.tv_sec - debut.tv_sec) + (fin.tv_nsec - debut.tv_nsec) / 1e9;
+}
+
+// Valeurs à trier selon la forme : aléatoires (rand(), graine fixe), déjà triées, inversées, toutes
+// égales (ce que donne initTab quand aleatoires() est appelée dans la même seconde) ou peu distinctes.
+void remplir(int T[], int n, int forme){
+    srand(GRAINE_MESURE);
+    for ( int i = 0 ; i < n ; i++ ){
+        switch ( forme ){
+            case FORME_TRIEE : T[i] = i ; break;
+            case FORME_INVERSEE : T[i] = n - i ; break;
+            case FORME_EGALE : T[i] = aleatoires() ; break;
+            case FORME_PEU_DISTINCTE : T[i] = rand() % NB_VALEURS_PEU_DISTINCTES ; break;
+            default : T[i] = rand() ; break;
+        }
+    }
+}
+
+// Trie les mêmes n valeurs de chaque forme avec chaque algorithme, vérifie le résultat contre qsort
+// et affiche la meilleure et la moyenne de NB_REPETITIONS mesures sur l'horloge monotone.
+int mesurer(int n){
+    const char *lesFormes[NB_FORMES] = {"aléatoire", "triée", "inversée", "égale", "peu distincte"};
+    const char *lesNoms[] = {"qsort", "tri_insertion", "triRapide", "triHybride", "triRadix"};
+    tTri lesTris[] = {triQsort, tri_insertion, triRapideTableau, triHybride, triRadix};
+    int nbTris = sizeof(lesTris) / sizeof(lesTris[0]);
+    int *reference = malloc(n * sizeof(int));
+    int *attendu = malloc(n * sizeof(int));
+    int *T = malloc(n * sizeof(int));
+    if ( (reference == NULL) || (attendu == NULL) || (T == NULL) ){
+        perror("malloc");
+        exit(EXIT_FAILURE);
+    }
+    int resultat = EXIT_SUCCESS;
+    printf("%d éléments, %d mesures par tri (ms)\n", n, NB_REPETITIONS);
+    for ( int f = 0 ; f < NB_FORMES ; f++ ){
+        remplir(reference, n, f);
+        memcpy(attendu, reference, n * sizeof(int));
+        triQsort(attendu, n);
+        printf("\n%-14s %12s %12s\n", lesFormes[f], "meilleure", "moyenne");
+        for ( int a = 0 ; a < nbTris ; a++ ){
+            if ( (lesTris[a] == tri_insertion) && (n > MAX_INSERTION) ){
+                printf("%-14s %25s\n", lesNoms[a], "ignoré (quadratique)");
+                continue;
+            }
+            double meilleure = 0 , total = 0 ;
+            for ( int r = 0 ; r < NB_REPETITIONS ; r++ ){
+                struct timespec t1, t2;
+                memcpy(T, reference, n * sizeof(int));
+                clock_gettime(CLOCK_MONOTONIC, &t1);
+                lesTris[a](T, n);
+                clock_gettime(CLOCK_MONOTONIC, &t2);
+                double d = duree(t1, t2) * 1e3;
+                meilleure = ((r == 0) || (d < meilleure)) ? d : meilleure;
+                total += d ;
+                if ( memcmp(T, attendu, n * sizeof(int)) != 0 ){
+                    fprintf(stderr, "%s : résultat mal trié\n", lesNoms[a]);
+                    resultat = EXIT_FAILURE;
+                }
+            }
+            printf("%-14s %12.3f %12.3f\n", lesNoms[a], meilleure, total / NB_REPETITIONS);
+        }
+    }
+    free(reference);
+    free(attendu);
+    free(T);
+    return resultat;
+}
+
+// File de tâches d'un fil (Chase et Lev) : le fil propriétaire pousse et reprend par le bas,
+// les autres volent par le haut. Une tâche qui ne tient plus dans la file est exécutée tout de suite.
+bool pousser(tFile *file, tTache *tache){
+    long bas = atomic_load_explicit(&file->bas, memory_order_relaxed);
+    long haut = atomic_load_explicit(&file->haut, memory_order_acquire);
+    if ( bas - haut >= CAPACITE_FILE ){
+        return false;
+    }
+    atomic_store_explicit(&file->taches[bas & (CAPACITE_FILE - 1)], tache, memory_order_relaxed);
+    atomic_store_explicit(&file->bas, bas + 1, memory_order_release); // Publie la tâche pour les voleurs.
+    return true;
+}
+
+tTache *reprendre(tFile *file){
+    long bas = atomic_load_explicit(&file->bas, memory_order_relaxed) - 1;
+    atomic_store_explicit(&file->bas, bas, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    long haut = atomic_load_explicit(&file->haut, memory_order_relaxed);
+    tTache *tache = NULL;
+    if ( haut <= bas ){
+        tache = atomic_load_explicit(&file->taches[bas & (CAPACITE_FILE - 1)], memory_order_relaxed);
+        if ( haut == bas ){
+            // Dernière tâche : un voleur peut la prendre en même temps, le premier qui avance haut l'emporte.
+            if ( !atomic_compare_exchange_strong_explicit(&file->haut, &haut, haut + 1,
+                                                          memory_order_seq_cst, memory_order_relaxed) ){
+                tache = NULL;
+            }
+            atomic_store_explicit(&file->bas, bas + 1, memory_order_relaxed);
+        }
+    }
+    else {
+        atomic_store_explicit(&file->bas, bas + 1, memory_order_relaxed);
+    }
+    return tache;
+}
+
+tTache *voler(tFile *file){
+    long haut = atomic_load_explicit(&file->haut, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    long bas = atomic_load_explicit(&file->bas, memory_order_acquire);
+    if ( haut >= bas ){
+        return NULL;
+    }
+    tTache *tache = atomic_load_explicit(&file->taches[haut & (CAPACITE_FILE - 1)], memory_order_relaxed);
+    if ( !atomic_compare_exchange_strong_explicit(&file->haut, &haut, haut + 1,
+                                                  memory_order_seq_cst, memory_order_relaxed) ){
+        return NULL;
+    }
+    return tache;
+}
+
+void executer(tTache *tache){
+    tache->executer(tache);
+    atomic_store_explicit(&tache->finie, true, memory_order_release);
+}
+
+// Une tâche à faire : d'abord dans sa propre file, sinon volée dans la file d'un autre fil tiré au hasard.
+tTache *chercherTache(void){
+    tTache *tache = reprendre(&ordonnanceur.lesFiles[numeroFil]);
+    if ( (tache == NULL) && (ordonnanceur.nbFils > 1) ){
+        graineFil ^= graineFil << 13;
+        graineFil ^= graineFil >> 17;
+        graineFil ^= graineFil << 5;
+        int victime = graineFil % ordonnanceur.nbFils;
+        if ( victime != numeroFil ){
+            tache = voler(&ordonnanceur.lesFiles[victime]);
+        }
+    }
+    return tache;
+}
+
+void *filOrdonnanceur(void *numero){
+    numeroFil = (int)(intptr_t)numero;
+    graineFil = 2463534242u + numeroFil;
+    while ( !atomic_load_explicit(&ordonnanceur.arret, memory_order_acquire) ){
+        tTache *tache = chercherTache();
+        if ( tache != NULL ){
+            executer(tache);
+        }
+        else {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+// Le fil appelant est le fil 0 ; nbFils-1 autres fils sont créés et cherchent des tâches jusqu'à l'arrêt.
+void demarrerOrdonnanceur(int nbFils){
+    ordonnanceur.nbFils = nbFils;
+    ordonnanceur.lesFiles = calloc(nbFils, sizeof(tFile));
+    ordonnanceur.lesFils = malloc(nbFils * sizeof(pthread_t));
+    if ( (ordonnanceur.lesFiles == NULL) || (ordonnanceur.lesFils == NULL) ){
+        perror("malloc");
+        exit(EXIT_FAILURE);
+    }
+    atomic_store(&ordonnanceur.arret, false);
+    numeroFil = 0;
+    graineFil = 2463534242u;
+    for ( int i = 1 ; i < nbFils ; i++ ){
+        int erreur = pthread_create(&ordonnanceur.lesFils[i], NULL, filOrdonnanceur, (void *)(intptr_t)i);
+        if ( erreur != 0 ){
+            fprintf(stderr, "pthread_create : %s\n", strerror(erreur));
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+void arreterOrdonnanceur(void){
+    atomic_store_explicit(&ordonnanceur.arret, true, memory_order_release);
+    for ( int i = 1 ; i < ordonnanceur.nbFils ; i++ ){
+        pthread_join(ordonnanceur.lesFils[i], NULL);
+    }
+    free(ordonnanceur.lesFiles);
+    free(ordonnanceur.lesFils);
+}
+
+void lancer(tTache *tache){
+    atomic_store_explicit(&tache->finie, false, memory_order_relaxed);
+    if ( !pousser(&ordonnanceur.lesFiles[numeroFil], tache) ){
+        executer(tache);
+    }
+}
+
+// En attendant la fin d'une tâche lancée, le fil exécute d'autres tâches (la sienne si personne ne l'a volée).
+void attendre(tTache *tache){
+    while ( !atomic_load_explicit(&tache->finie, memory_order_acquire) ){
+        tTache *autre = chercherTache();
+        if ( autre != NULL ){
+            executer(autre);
+        }
+        else {
+            sched_yield();
+        }
+    }
+}
+
+// Une phase de la partition parallèle sur le bloc T[debut..fin] : compter ses valeurs de chaque sorte, les ranger
+// dans le tampon aux rangs calculés pour le bloc, ou recopier sa part du tampon dans T.
+void tacheBloc(tTache *tache){
+    tBloc *bloc = (tBloc *)tache;
+    int *T = tache->source , *tampon = tache->destination ;
+    if ( bloc->phase == PHASE_COMPTER ){
+        int nbInferieurs = 0 , nbEgaux = 0 ;
+        for ( int i = tache->debut ; i <= tache->fin ; i++ ){
+            nbInferieurs += (T[i] < bloc->valeur);
+            nbEgaux += (T[i] == bloc->valeur);
+        }
+        bloc->nbInferieurs = nbInferieurs ;
+        bloc->nbEgaux = nbEgaux ;
+    }
+    else if ( bloc->phase == PHASE_RANGER ){
+        int inferieur = bloc->rangInferieurs , egal = bloc->rangEgaux , superieur = bloc->rangSuperieurs ;
+        for ( int i = tache->debut ; i <= tache->fin ; i++ ){
+            int x = T[i];
+            if ( x < bloc->valeur ) tampon[inferieur++] = x ;
+            else if ( x == bloc->valeur ) tampon[egal++] = x ;
+            else tampon[superieur++] = x ;
+        }
+    }
+    else {
+        memcpy(T + tache->debut, tampon + tache->debut, (tache->fin - tache->debut + 1) * sizeof(int));
+    }
+}
+
+// Partition en trois de T[debut..fin] répartie sur les fils : chaque bloc compte ses valeurs plus petites, égales
+// et plus grandes que valeur, les rangs de chaque bloc dans le tampon s'en déduisent, puis chaque bloc range ses
+// valeurs dans le tampon et en recopie une part dans T. Chaque phase ne coûte que n / nbFils par fil.
+void partitionParallele(int T[], int tampon[], int debut, int fin, int valeur, int *premierEgal, int *dernierEgal){
+    tBloc lesBlocs[NB_BLOCS_MAX];
+    int n = fin - debut + 1;
+    int nbBlocs = n / TAILLE_BLOC_PARTITION;
+    nbBlocs = (nbBlocs < 2) ? 2 : ((nbBlocs > NB_BLOCS_MAX) ? NB_BLOCS_MAX : nbBlocs);
+    for ( int b = 0 ; b < nbBlocs ; b++ ){
+        lesBlocs[b] = (tBloc){.tache = {.executer = tacheBloc, .source = T, .destination = tampon,
+                                        .debut = debut + (int)((long)n * b / nbBlocs),
+                                        .fin = debut + (int)((long)n * (b + 1) / nbBlocs) - 1},
+                              .valeur = valeur};
+    }
+    int nbInferieurs = 0 , nbEgaux = 0 ;
+    for ( int phase = PHASE_COMPTER ; phase <= PHASE_RECOPIER ; phase++ ){
+        if ( phase == PHASE_RANGER ){
+            for ( int b = 0 ; b < nbBlocs ; b++ ){
+                nbInferieurs += lesBlocs[b].nbInferieurs ;
+                nbEgaux += lesBlocs[b].nbEgaux ;
+            }
+            int inferieur = debut , egal = debut + nbInferieurs , superieur = debut + nbInferieurs + nbEgaux ;
+            for ( int b = 0 ; b < nbBlocs ; b++ ){
+                int taille = lesBlocs[b].tache.fin - lesBlocs[b].tache.debut + 1;
+                lesBlocs[b].rangInferieurs = inferieur ;
+                lesBlocs[b].rangEgaux = egal ;
+                lesBlocs[b].rangSuperieurs = superieur ;
+                inferieur += lesBlocs[b].nbInferieurs ;
+                egal += lesBlocs[b].nbEgaux ;
+                superieur += taille - lesBlocs[b].nbInferieurs - lesBlocs[b].nbEgaux ;
+            }
+        }
+        for ( int b = 1 ; b < nbBlocs ; b++ ){
+            lesBlocs[b].phase = phase ;
+            lancer(&lesBlocs[b].tache);
+        }
+        lesBlocs[0].phase = phase ;
+        tacheBloc(&lesBlocs[0].tache);
+        for ( int b = 1 ; b < nbBlocs ; b++ ){
+            attendre(&lesBlocs[b].tache);
+        }
+    }
+    *premierEgal = debut + nbInferieurs ;
+    *dernierEgal = debut + nbInferieurs + nbEgaux - 1;
+}
+
+void tacheTriRapide(tTache *tache){
+    triRapideParallele(tache->source, tache->destination, tache->debut, tache->fin);
+}
+
+// triRapide dont la plus petite partie est confiée à l'ordonnanceur au-dessus de SEUIL_PARALLELE éléments, tandis que
+// la boucle continue sur la plus grande sans appel imbriqué ; les tâches lancées sont attendues à la fin. Chaque
+// tâche porte sur au plus la moitié de la partie qui l'a lancée : si un fil exécute ses propres tâches en les
+// imbriquant (lancer avec une file pleine, ou attendre qui reprend la tâche que personne n'a volée), il n'empile
+// pas plus de log2(n) appels. attendre peut aussi exécuter une tâche volée à un autre fil : celle-ci ajoute ses
+// propres niveaux, bornés de la même façon par la taille de sa partie. Au-delà de SEUIL_PARTITION_PARALLELE
+// éléments et avec plusieurs fils, la partition elle-même est répartie (partitionParallele, à travers le tampon) :
+// sans cela, partitionner tout le tableau avant le premier partage limiterait l'accélération à environ log2(n)/2.
+void triRapideParallele(int T[], int tampon[], int debut, int fin){
+    tTache lesTaches[NB_TACHES_TRI];
+    int nbTaches = 0 ;
+    while ( fin - debut + 1 > SEUIL_PARALLELE ){
+        int premierEgal , dernierEgal ;
+        if ( (fin - debut + 1 > SEUIL_PARTITION_PARALLELE) && (ordonnanceur.nbFils > 1) ){
+            partitionParallele(T, tampon, debut, fin, T[choisirPivot(T, debut, fin)], &premierEgal, &dernierEgal);
+        }
+        else {
+            partition(T, debut, fin, choisirPivot(T, debut, fin), &premierEgal, &dernierEgal);
+        }
+        int debutPetite , finPetite ;
+        if ( premierEgal - debut < fin - dernierEgal ){
+            debutPetite = debut ;
+            finPetite = premierEgal - 1;
+            debut = dernierEgal + 1;
+        }
+        else {
+            debutPetite = dernierEgal + 1;
+            finPetite = fin ;
+            fin = premierEgal - 1;
+        }
+        if ( (finPetite - debutPetite + 1 <= SEUIL_PARALLELE) || (nbTaches == NB_TACHES_TRI) ){
+            triRapideParallele(T, tampon, debutPetite, finPetite); // Petite partie : au plus la moitié, sans tâche.
+        }
+        else {
+            lesTaches[nbTaches] = (tTache){.executer = tacheTriRapide, .source = T, .destination = tampon,
+                                           .debut = debutPetite, .fin = finPetite};
+            lancer(&lesTaches[nbTaches++]);
+        }
+    }
+    triRapide(T, debut, fin);
+    for ( int t = nbTaches - 1 ; t >= 0 ; t-- ){
+        attendre(&lesTaches[t]); // Dernière lancée d'abord : c'est la première que le fil reprend dans sa file.
+    }
+}
+
+void tacheFusion(tTache *tache){
+    fusionParallele(tache->source, tache->debut, tache->fin, tache->debut2, tache->fin2,
+                    tache->destination, tache->position);
+}
+
+// Fusionne source[debut1..fin1[ et source[debut2..fin2[ dans destination à partir de position. Au-dessus de
+// SEUIL_PARALLELE éléments, le milieu de la plus longue suite est placé par recherche dichotomique dans
+// l'autre et les deux moitiés de chaque côté sont fusionnées en parallèle.
+void fusionParallele(const int source[], int debut1, int fin1, int debut2, int fin2, int destination[], int position){
+    if ( fin1 - debut1 < fin2 - debut2 ){
+        int temp = debut1; debut1 = debut2; debut2 = temp ;
+        temp = fin1; fin1 = fin2; fin2 = temp ;
+    }
+    if ( (fin1 - debut1) + (fin2 - debut2) <= SEUIL_PARALLELE ){
+        while ( (debut1 < fin1) && (debut2 < fin2) ){
+            destination[position++] = (source[debut2] < source[debut1]) ? source[debut2++] : source[debut1++];
+        }
+        memcpy(destination + position, source + debut1, (fin1 - debut1) * sizeof(int));
+        memcpy(destination + position + (fin1 - debut1), source + debut2, (fin2 - debut2) * sizeof(int));
+        return;
+    }
+    int milieu = debut1 + (fin1 - debut1)/2;
+    int inf = debut2 , sup = fin2 ;
+    while ( inf < sup ){
+        int m = inf + (sup - inf)/2;
+        if ( source[m] < source[milieu] ) inf = m + 1;
+        else sup = m ;
+    }
+    int rang = position + (milieu - debut1) + (inf - debut2);
+    destination[rang] = source[milieu];
+    tTache tache = {.executer = tacheFusion, .source = (int *)source, .destination = destination,
+                    .debut = debut1, .fin = milieu, .debut2 = debut2, .fin2 = inf, .position = position};
+    lancer(&tache);
+    fusionParallele(source, milieu + 1, fin1, inf, fin2, destination, rang + 1);
+    attendre(&tache);
+}
+
+void tacheTriFusion(tTache *tache){
+    triFusionParallele(tache->source, tache->destination, tache->debut, tache->fin, tache->dansSource);
+}
+
+// Trie T[debut..fin[ ; le résultat est dans T si dansT, sinon dans tampon. Les deux moitiés sont triées
+// en parallèle vers l'autre tableau, puis fusionnées vers celui demandé : aucune recopie à chaque niveau.
+void triFusionParallele(int T[], int tampon[], int debut, int fin, bool dansT){
+    if ( fin - debut <= SEUIL_PARALLELE ){
+        triHybride(T + debut, fin - debut);
+        if ( !dansT ){
+            memcpy(tampon + debut, T + debut, (fin - debut) * sizeof(int));
+        }
+        return;
+    }
+    int milieu = debut + (fin - debut)/2;
+    tTache tache = {.executer = tacheTriFusion, .source = T, .destination = tampon,
+                    .debut = debut, .fin = milieu, .dansSource = !dansT};
+    lancer(&tache);
+    triFusionParallele(T, tampon, milieu, fin, !dansT);
+    attendre(&tache);
+    if ( dansT ){
+        fusionParallele(tampon, debut, milieu, milieu, fin, T, debut);
+    }
+    else {
+        fusionParallele(T, debut, milieu, milieu, fin, tampon, debut);
+    }
+}
+
+void triRapideParalleleTableau(int T[], int n){
+    int *tampon = NULL;
+    if ( ordonnanceur.nbFils > 1 ){
+        tampon = malloc(n * sizeof(int));
+        if ( tampon == NULL ){
+            perror("malloc");
+            exit(EXIT_FAILURE);
+        }
+    }
+    triRapideParallele(T, tampon, 0, n-1);
+    free(tampon);
+}
+
+void triFusionParalleleTableau(int T[], int n){
+    int *tampon = malloc(n * sizeof(int));
+    if ( tampon == NULL ){
+        perror("malloc");
+        exit(EXIT_FAILURE);
+    }
+    triFusionParallele(T, tampon, 0, n, true);
+    free(tampon);
+}
+
+// Trie les mêmes n valeurs aléatoires avec 1, 2, 4... jusqu'à filsMax fils et affiche, pour chaque tri
+// parallèle, la durée et l'accélération par rapport au même tri sur un seul fil.
+int mesurerParallele(int n, int filsMax){
+    const char *lesNoms[] = {"triRapide", "triFusion"};
+    tTri lesTris[] = {triRapideParalleleTableau, triFusionParalleleTableau};
+    int nbTris = sizeof(lesTris) / sizeof(lesTris[0]);
+    int *reference = malloc((size_t)n * sizeof(int));
+    int *T = malloc((size_t)n * sizeof(int));
+    if ( (reference == NULL) || (T == NULL) ){
+        perror("malloc");
+        exit(EXIT_FAILURE);
+    }
+    remplir(reference, n, FORME_ALEATOIRE);
+    long long somme = 0;
+    for ( int i = 0 ; i < n ; i++ ){
+        somme += reference[i];
+    }
+
+    int resultat = EXIT_SUCCESS;
+    double lesDurees[2] = {0, 0}; // Durée de chaque tri sur un seul fil.
+    printf("%d éléments, meilleure de %d mesures (ms) et accélération par rapport à 1 fil\n", n, NB_REPETITIONS);
+    printf("%-6s %12s %8s %12s %8s\n", "fils", lesNoms[0], "", lesNoms[1], "");
+    for ( int nbFils = 1 ; ; nbFils *= 2 ){
+        nbFils = (nbFils > filsMax) ? filsMax : nbFils ;
+        demarrerOrdonnanceur(nbFils);
+        printf("%-6d", nbFils);
+        for ( int a = 0 ; a < nbTris ; a++ ){
+            double meilleure = 0;
+            for ( int r = 0 ; r < NB_REPETITIONS ; r++ ){
+                struct timespec t1, t2;
+                memcpy(T, reference, (size_t)n * sizeof(int));
+                clock_gettime(CLOCK_MONOTONIC, &t1);
+                lesTris[a](T, n);
+                clock_gettime(CLOCK_MONOTONIC, &t2);
+                double d = duree(t1, t2) * 1e3;
+                meilleure = ((r == 0) || (d < meilleure)) ? d : meilleure;
+                long long verification = T[0];
+                for ( int i = 1 ; i < n ; i++ ){
+                    verification += T[i];
+                    if ( T[i-1] > T[i] ){
+                        verification = somme + 1;
+                        break;
+                    }
+                }
+                if ( verification != somme ){
+                    fprintf(stderr, "%s : résultat mal trié avec %d fils\n", lesNoms[a], nbFils);
+                    resultat = EXIT_FAILURE;
+                }
+            }
+            if ( nbFils == 1 ){
+                lesDurees[a] = meilleure;
+            }
+            printf(" %12.3f %7.2fx", meilleure, lesDurees[a] / meilleure);
+        }
+        printf("\n");
+        arreterOrdonnanceur();
+        if ( nbFils == filsMax ){
+            break;
+        }
+    }
+    free(reference);
+    free(T);
+    return resultat;
+}
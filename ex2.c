@@ -3,17 +3,21 @@
 #include <time.h>
 
 #define TAILLE 10
+#define SEUIL_NINTHER 40 // Au-delà, le pivot est la médiane de trois médianes.
 typedef int tableau[TAILLE];
 
-int partition(tableau T,int debut,int fin,int pivot);
+void partition(tableau T, int debut, int fin, int pivot, int *premierEgal, int *dernierEgal);
+int mediane(tableau T, int a, int b, int c);
+int choisirPivot(tableau T, int debut, int fin);
 void triRapide(tableau T, int debut, int fin);
+void echanger(tableau T, int i, int j);
 void afficher(tableau T);
 
 
 
 int main(){
     tableau T = {5,3,9,8,7,5,2,1,9,1};
-    triRapide(T, 0, TAILLE);
+    triRapide(T, 0, TAILLE-1);
     afficher(T);
     printf("\n");
     return EXIT_SUCCESS;
@@ -21,36 +25,86 @@ int main(){
 
 
 
-int partition(tableau T,int debut,int fin,int pivot){
-    int temp = T[fin]; 
-    T[fin] = T[pivot];
-    T[pivot] = temp ;
-    int j = debut ;
-    for ( int i = debut ; i <= (fin-1) ; i++ ){
-        if (T[i] <= T[fin]){
-            temp = T[i]; 
-            T[i] = T[j];
-            T[j] = temp ;
-            j++ ;
+// Partition en trois de T[debut..fin] autour de T[pivot] (Bentley et McIlroy) : deux parcours de Hoare qui
+// n'échangent que les paires mal placées, les valeurs égales au pivot étant rangées aux deux bouts puis
+// ramenées au milieu. À la fin, T[debut..*premierEgal-1] < valeur, T[*premierEgal..*dernierEgal] == valeur
+// et T[*dernierEgal+1..fin] > valeur : les doublons ne sont plus revisités.
+void partition(tableau T, int debut, int fin, int pivot, int *premierEgal, int *dernierEgal){
+    echanger(T, debut, pivot);
+    int valeur = T[debut];
+    int i = debut , j = fin + 1 ;
+    int p = debut , q = fin + 1 ; // T[debut..p] et T[q..fin] : valeurs égales au pivot.
+    while ( 1 ){
+        while ( T[++i] < valeur ){
+            if ( i == fin ) break;
         }
+        while ( valeur < T[--j] ){
+            if ( j == debut ) break;
+        }
+        if ( (i == j) && (T[i] == valeur) ){
+            echanger(T, ++p, i);
+        }
+        if ( i >= j ){
+            break;
+        }
+        echanger(T, i, j);
+        if ( T[i] == valeur ) echanger(T, ++p, i);
+        if ( T[j] == valeur ) echanger(T, --q, j);
     }
-    
-    temp = T[fin]; 
-    T[fin] = T[j];
-    T[j] = temp ;
-    return j ;
+    i = j + 1;
+    for ( int k = debut ; k <= p ; k++ ){
+        echanger(T, k, j--);
+    }
+    for ( int k = fin ; k >= q ; k-- ){
+        echanger(T, k, i++);
+    }
+    *premierEgal = j + 1;
+    *dernierEgal = i - 1;
+}
+
+int mediane(tableau T, int a, int b, int c){
+    if ( T[a] < T[b] ){
+        return (T[b] < T[c]) ? b : ((T[a] < T[c]) ? c : a);
+    }
+    return (T[a] < T[c]) ? a : ((T[b] < T[c]) ? c : b);
 }
 
+// Médiane de trois (début, milieu, fin), ou au-delà de SEUIL_NINTHER éléments médiane de trois médianes
+// de trois (ninther de Tukey) : un tableau trié ou inversé donne le pivot du milieu.
+int choisirPivot(tableau T, int debut, int fin){
+    int milieu = debut + (fin - debut)/2;
+    int n = fin - debut + 1;
+    if ( n > SEUIL_NINTHER ){
+        int pas = n/8;
+        return mediane(T, mediane(T, debut, debut + pas, debut + 2*pas),
+                          mediane(T, milieu - pas, milieu, milieu + pas),
+                          mediane(T, fin - 2*pas, fin - pas, fin));
+    }
+    return mediane(T, debut, milieu, fin);
+}
+
+// Récursion sur la plus petite partie, boucle sur la plus grande : au plus log2(n) appels empilés.
 void triRapide(tableau T, int debut, int fin){
-    int pivot ;
-    if ( debut < fin ){
-        pivot = (debut + fin)/2;
-        pivot = partition(T, debut, fin, pivot);
-        triRapide(T, debut, pivot-1);
-        triRapide(T, pivot+1, fin);
+    int premierEgal , dernierEgal ;
+    while ( debut < fin ){
+        partition(T, debut, fin, choisirPivot(T, debut, fin), &premierEgal, &dernierEgal);
+        if ( premierEgal - debut < fin - dernierEgal ){
+            triRapide(T, debut, premierEgal-1);
+            debut = dernierEgal + 1;
+        }
+        else {
+            triRapide(T, dernierEgal+1, fin);
+            fin = premierEgal - 1;
+        }
     }
 }
 
+void echanger(tableau T, int i, int j){
+    int temp = T[i];
+    T[i] = T[j];
+    T[j] = temp ;
+}
+
 void afficher(tableau T){
     for ( int i = 0 ; i < TAILLE ; i++){
         printf("%d " ,T[i]);